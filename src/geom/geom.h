@@ -6,10 +6,14 @@
 #ifndef CAESAR_GEOM_H
 #define CAESAR_GEOM_H
 
+#include "geom_box.h"
+#include "geom_bvh.h"
 #include "geom_displaced_triangle.h"
 #include "geom_points_cloud.h"
 #include "geom_prismatoid.h"
 #include "geom_tetrahedron.h"
+#include "geom_triangle.h"
 #include "geom_vector.h"
+#include "geom_vectors_array.h"
 
 #endif // CAESAR_GEOM_H
@@ -0,0 +1,276 @@
+/// \file
+/// \brief Axis-aligned box implementation.
+///
+/// Axis-aligned bounding box implementation.
+
+#include "geom_box.h"
+
+#include <cmath>
+#include <limits>
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+/// \brief Default constructor.
+///
+/// Create empty box.
+Box::Box()
+{
+    clear();
+}
+
+/// \brief Copy constructor.
+///
+/// Copy constructor.
+///
+/// \param[in] b Box.
+Box::Box(const Box& b)
+    : lo(b.lo),
+      hi(b.hi)
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+Box::~Box()
+{
+}
+
+/// \brief Print function.
+///
+/// Print box to stream.
+///
+/// \param[in] os Output stream.
+/// \param[in] b  Box.
+///
+/// \return
+/// Output stream.
+ostream&
+operator<<(ostream& os,
+           const Box& b)
+{
+    os << "[" << b.lo << " - " << b.hi << "]";
+
+    return os;
+}
+
+/// \brief Make box empty.
+///
+/// Make box empty, so any extension sets it to extending object.
+void
+Box::clear()
+{
+    double inf { numeric_limits<double>::infinity() };
+
+    lo.set(inf, inf, inf);
+    hi.set(-inf, -inf, -inf);
+}
+
+/// \brief Set box from another box.
+///
+/// Copy corners of another box.
+///
+/// \param[in] b Box.
+void
+Box::set(const Box& b)
+{
+    lo.set(b.lo);
+    hi.set(b.hi);
+}
+
+/// \brief Check if box is empty.
+///
+/// Check if box is empty.
+///
+/// \return
+/// true - if box is empty,
+/// false - otherwise.
+bool
+Box::is_empty() const
+{
+    return (lo.x > hi.x) || (lo.y > hi.y) || (lo.z > hi.z);
+}
+
+/// \brief Center of box.
+///
+/// Calculate center of box.
+///
+/// \param[out] c Center.
+void
+Box::calc_center(Vector& c) const
+{
+    Vector::avg(lo, hi, c);
+}
+
+/// \brief Box coordinate along axis.
+///
+/// Get vector coordinate by axis number.
+///
+/// \param[in] v    Vector.
+/// \param[in] axis Axis number (0 - X, 1 - Y, 2 - Z).
+///
+/// \return
+/// Coordinate.
+double
+Box::axis_value(const Vector& v,
+                int axis)
+{
+    return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+/// \brief Longest axis.
+///
+/// Get number of axis along which the box has the longest extent.
+///
+/// \return
+/// Axis number (0 - X, 1 - Y, 2 - Z).
+int
+Box::longest_axis() const
+{
+    double dx { hi.x - lo.x }, dy { hi.y - lo.y }, dz { hi.z - lo.z };
+
+    if ((dx >= dy) && (dx >= dz))
+    {
+        return 0;
+    }
+
+    return (dy >= dz) ? 1 : 2;
+}
+
+/// \brief Surface area.
+///
+/// Surface area of box (used as cost in SAH).
+///
+/// \return
+/// Surface area, zero for empty box.
+double
+Box::surface_area() const
+{
+    if (is_empty())
+    {
+        return 0.0;
+    }
+
+    double dx { hi.x - lo.x }, dy { hi.y - lo.y }, dz { hi.z - lo.z };
+
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
+
+/// \brief Check intersection with another box.
+///
+/// Check if boxes have common points.
+///
+/// \param[in] b Box.
+///
+/// \return
+/// true - if boxes intersect,
+/// false - otherwise.
+bool
+Box::is_intersect(const Box& b) const
+{
+    return (lo.x <= b.hi.x) && (b.lo.x <= hi.x)
+           && (lo.y <= b.hi.y) && (b.lo.y <= hi.y)
+           && (lo.z <= b.hi.z) && (b.lo.z <= hi.z);
+}
+
+/// \brief Square of distance from point to box.
+///
+/// Square of distance from point to the nearest point of box.
+///
+/// \param[in] p Point.
+///
+/// \return
+/// Square of distance (zero if point is inside).
+double
+Box::dist2_to(const Vector& p) const
+{
+    double dx { max(max(lo.x - p.x, 0.0), p.x - hi.x) };
+    double dy { max(max(lo.y - p.y, 0.0), p.y - hi.y) };
+    double dz { max(max(lo.z - p.z, 0.0), p.z - hi.z) };
+
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/// \brief Clip ray parameters interval with slab.
+///
+/// If ray is parallel to slab (inverted component is infinite)
+/// interval is not changed when origin is inside slab and becomes empty otherwise,
+/// so products 0 * inf are not calculated.
+///
+/// \param[in]     lo    Low bound of slab.
+/// \param[in]     hi    High bound of slab.
+/// \param[in]     o     Component of ray origin.
+/// \param[in]     inv_d Inverted component of ray direction.
+/// \param[in,out] tmin  Low bound of interval.
+/// \param[in,out] tfar  High bound of interval.
+///
+/// \return
+/// true - if interval is not empty,
+/// false - otherwise.
+static bool
+clip_slab(double lo,
+          double hi,
+          double o,
+          double inv_d,
+          double& tmin,
+          double& tfar)
+{
+    if (isinf(inv_d))
+    {
+        return (o >= lo) && (o <= hi);
+    }
+
+    double t1 { (lo - o) * inv_d }, t2 { (hi - o) * inv_d };
+
+    tmin = max(tmin, min(t1, t2));
+    tfar = min(tfar, max(t1, t2));
+
+    return true;
+}
+
+/// \brief Intersect ray with box.
+///
+/// Slab test of ray o + t * d, t in [0, tmax].
+/// Zero components of direction give infinite inverted components,
+/// they are processed separately.
+///
+/// \param[in]  o     Ray origin.
+/// \param[in]  inv_d Inverted components of ray direction.
+/// \param[in]  tmax  Maximum ray parameter.
+/// \param[out] tnear Ray parameter of entry point.
+///
+/// \return
+/// true - if ray intersects box,
+/// false - otherwise.
+bool
+Box::intersect_ray(const Vector& o,
+                   const Vector& inv_d,
+                   double tmax,
+                   double& tnear) const
+{
+    double tmin { 0.0 }, tfar { tmax };
+
+    if (!clip_slab(lo.x, hi.x, o.x, inv_d.x, tmin, tfar)
+        || !clip_slab(lo.y, hi.y, o.y, inv_d.y, tmin, tfar)
+        || !clip_slab(lo.z, hi.z, o.z, inv_d.z, tmin, tfar))
+    {
+        return false;
+    }
+
+    tnear = tmin;
+
+    return tfar >= tnear;
+}
+
+/// @}
+
+}
+
+}
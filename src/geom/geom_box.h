@@ -0,0 +1,123 @@
+/// \file
+/// \brief Axis-aligned box declaration.
+///
+/// Axis-aligned bounding box declaration.
+
+#ifndef CAESAR_GEOM_BOX_H
+#define CAESAR_GEOM_BOX_H
+
+#include "geom_vector.h"
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+/// \brief Axis-aligned bounding box.
+///
+/// Empty box has lo corner greater than hi corner.
+class Box
+{
+
+public:
+
+    /// \brief Low corner.
+    Vector lo;
+
+    /// \brief High corner.
+    Vector hi;
+
+    // Default constructor (empty box).
+    Box();
+
+    // Copy constructor.
+    Box(const Box& b);
+
+    // Default destructor.
+    ~Box();
+
+    // Print function.
+    friend ostream&
+    operator<<(ostream& os,
+               const Box& b);
+
+    // Make box empty.
+    void
+    clear();
+
+    // Set box from another box.
+    void
+    set(const Box& b);
+
+    // Check if box is empty.
+    bool
+    is_empty() const;
+
+    /// \brief Extend box with point.
+    ///
+    /// Extend box so it contains the point.
+    ///
+    /// \param[in] p Point.
+    inline void
+    extend(const Vector& p)
+    {
+        lo.set(min(lo.x, p.x), min(lo.y, p.y), min(lo.z, p.z));
+        hi.set(max(hi.x, p.x), max(hi.y, p.y), max(hi.z, p.z));
+    }
+
+    /// \brief Extend box with another box.
+    ///
+    /// Extend box so it contains another box.
+    ///
+    /// \param[in] b Box.
+    inline void
+    extend(const Box& b)
+    {
+        lo.set(min(lo.x, b.lo.x), min(lo.y, b.lo.y), min(lo.z, b.lo.z));
+        hi.set(max(hi.x, b.hi.x), max(hi.y, b.hi.y), max(hi.z, b.hi.z));
+    }
+
+    // Center of box.
+    void
+    calc_center(Vector& c) const;
+
+    // Box coordinate along axis.
+    static double
+    axis_value(const Vector& v,
+               int axis);
+
+    // Longest axis.
+    int
+    longest_axis() const;
+
+    // Surface area.
+    double
+    surface_area() const;
+
+    // Check intersection with another box.
+    bool
+    is_intersect(const Box& b) const;
+
+    // Square of distance from point to box.
+    double
+    dist2_to(const Vector& p) const;
+
+    // Intersect ray with box.
+    bool
+    intersect_ray(const Vector& o,
+                  const Vector& inv_d,
+                  double tmax,
+                  double& tnear) const;
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_GEOM_BOX_H
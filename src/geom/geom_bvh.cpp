@@ -0,0 +1,738 @@
+/// \file
+/// \brief Bounding volume hierarchy over triangles implementation.
+///
+/// Bounding volume hierarchy over triangles implementation.
+
+#include "geom_bvh.h"
+
+#include <limits>
+#include <numeric>
+
+#include "geom_triangle.h"
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+// Static constants definitions.
+const size_t BVH::bins_count;
+const size_t BVH::max_leaf_size;
+const size_t BVH::min_task_size;
+const size_t BVH::max_depth;
+const size_t BVH::stack_size;
+
+/// \brief Default constructor.
+///
+/// Default constructor.
+BVH::BVH()
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+BVH::~BVH()
+{
+}
+
+/// \brief Set points.
+///
+/// Copy points into tree.
+///
+/// \param[in] ps Points.
+void
+BVH::set_points(const vector<Vector>& ps)
+{
+    size_t n { ps.size() };
+
+    if (points.size() != n)
+    {
+        points.clear();
+        points.reserve(n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            points.push_back(ps[i]);
+        }
+
+        return;
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i)
+    {
+        points[i].set(ps[i]);
+    }
+}
+
+/// \brief Calculate triangles boxes and centroids.
+///
+/// Calculate boxes and centroids of all triangles.
+void
+BVH::calc_triangles_boxes()
+{
+    size_t n { triangles_count() };
+
+    if (triangles_boxes.size() != n)
+    {
+        triangles_boxes.clear();
+        triangles_boxes.resize(n);
+        centroids.clear();
+        centroids.resize(n);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i)
+    {
+        Box& b { triangles_boxes[i] };
+        const Vector& a { triangle_point(i, 0) };
+
+        b.lo.set(a);
+        b.hi.set(a);
+        b.extend(triangle_point(i, 1));
+        b.extend(triangle_point(i, 2));
+        Vector::avg(a, triangle_point(i, 1), triangle_point(i, 2), centroids[i]);
+    }
+}
+
+/// \brief Allocate pair of nodes.
+///
+/// Allocate two neighbour nodes (may be called from several threads).
+///
+/// \return
+/// Index of the first node of pair.
+size_t
+BVH::allocate_nodes_pair()
+{
+    size_t i { 0 };
+
+    #pragma omp atomic capture
+    {
+        i = nodes_count_;
+        nodes_count_ += 2;
+    }
+
+    DEBUG_CHECK_ERROR(i + 2 <= nodes.size(), "BVH nodes overflow");
+
+    return i;
+}
+
+/// \brief Build node.
+///
+/// Build node for range of triangles and its subtree.
+/// Big subtrees are built in separate OpenMP tasks.
+/// Depth of tree is limited, so queries use stack of fixed size.
+///
+/// \param[in] ni    Node index.
+/// \param[in] first First position in order vector.
+/// \param[in] count Count of triangles.
+/// \param[in] depth Depth of node.
+void
+BVH::build_node(size_t ni,
+                size_t first,
+                size_t count,
+                size_t depth)
+{
+    BVHNode& node { nodes[ni] };
+    Box centroids_box;
+
+    node.box.clear();
+
+    for (size_t i = first; i < first + count; ++i)
+    {
+        size_t ti { order[i] };
+
+        node.box.extend(triangles_boxes[ti]);
+        centroids_box.extend(centroids[ti]);
+    }
+
+    // Small count of triangles or too deep node - make leaf.
+    if ((count <= max_leaf_size) || (depth >= max_depth))
+    {
+        node.first = first;
+        node.count = count;
+
+        return;
+    }
+
+    size_t mid { split(first, count, centroids_box) };
+    size_t li { allocate_nodes_pair() };
+
+    node.first = li;
+    node.count = 0;
+
+    if (count >= min_task_size)
+    {
+        #pragma omp task
+        build_node(li, first, mid - first, depth + 1);
+
+        build_node(li + 1, mid, first + count - mid, depth + 1);
+    }
+    else
+    {
+        build_node(li, first, mid - first, depth + 1);
+        build_node(li + 1, mid, first + count - mid, depth + 1);
+    }
+}
+
+/// \brief Split range of triangles.
+///
+/// Split range of triangles with binned surface area heuristic.
+/// All three axes are considered.
+///
+/// source:
+/// Wald I.
+/// On fast construction of SAH-based bounding volume hierarchies.
+///
+/// \param[in] first         First position in order vector.
+/// \param[in] count         Count of triangles.
+/// \param[in] centroids_box Box of triangles centroids.
+///
+/// \return
+/// Position of the first triangle of right part.
+size_t
+BVH::split(size_t first,
+           size_t count,
+           const Box& centroids_box)
+{
+    double best_cost { numeric_limits<double>::infinity() };
+    int best_axis { -1 };
+    size_t best_bin { 0 };
+    double best_lo { 0.0 }, best_k { 0.0 };
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        double lo { Box::axis_value(centroids_box.lo, axis) };
+        double ext { Box::axis_value(centroids_box.hi, axis) - lo };
+
+        if (ext <= 0.0)
+        {
+            continue;
+        }
+
+        double k { static_cast<double>(bins_count) * (1.0 - mth::Eps) / ext };
+        Box boxes[bins_count];
+        size_t counts[bins_count];
+
+        fill(counts, counts + bins_count, 0);
+
+        // Fill bins.
+        for (size_t i = first; i < first + count; ++i)
+        {
+            size_t ti { order[i] };
+            size_t b { static_cast<size_t>((Box::axis_value(centroids[ti], axis) - lo) * k) };
+
+            boxes[b].extend(triangles_boxes[ti]);
+            ++counts[b];
+        }
+
+        // Sweep from the right to accumulate right parts costs.
+        double right_costs[bins_count];
+        Box acc;
+        size_t acc_count { 0 };
+
+        for (size_t b = bins_count - 1; b > 0; --b)
+        {
+            acc.extend(boxes[b]);
+            acc_count += counts[b];
+            right_costs[b - 1] = acc.surface_area() * static_cast<double>(acc_count);
+        }
+
+        // Sweep from the left and find best split.
+        acc.clear();
+        acc_count = 0;
+
+        for (size_t b = 0; b < bins_count - 1; ++b)
+        {
+            acc.extend(boxes[b]);
+            acc_count += counts[b];
+
+            if ((acc_count == 0) || (acc_count == count))
+            {
+                continue;
+            }
+
+            double cost { acc.surface_area() * static_cast<double>(acc_count) + right_costs[b] };
+
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_axis = axis;
+                best_bin = b;
+                best_lo = lo;
+                best_k = k;
+            }
+        }
+    }
+
+    size_t mid { first + count / 2 };
+
+    if (best_axis >= 0)
+    {
+        const vector<Vector>& cs { centroids };
+        int axis { best_axis };
+        size_t bin { best_bin };
+        double lo { best_lo }, k { best_k };
+
+        mid = static_cast<size_t>(partition(order.begin() + static_cast<long>(first),
+                                            order.begin() + static_cast<long>(first + count),
+                                            [&cs, axis, bin, lo, k] (size_t ti)
+                                            {
+                                                return static_cast<size_t>((Box::axis_value(cs[ti], axis)
+                                                                            - lo) * k) <= bin;
+                                            })
+                                  - order.begin());
+    }
+
+    // Degenerate split, divide range in the middle.
+    if ((mid == first) || (mid == first + count))
+    {
+        mid = first + count / 2;
+    }
+
+    return mid;
+}
+
+//
+// Build.
+//
+
+/// \brief Build tree.
+///
+/// Build tree for triangles.
+///
+/// \param[in] ps Points.
+/// \param[in] ts Triangles (three points indices for each triangle).
+void
+BVH::build(const vector<Vector>& ps,
+           const vector<size_t>& ts)
+{
+    DEBUG_CHECK_ERROR(ts.size() % 3 == 0, "wrong triangles vector size for BVH");
+
+    set_points(ps);
+    triangles = ts;
+    calc_triangles_boxes();
+
+    size_t n { triangles_count() };
+
+    order.resize(n);
+    iota(order.begin(), order.end(), 0);
+    nodes.clear();
+    nodes_count_ = 0;
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    nodes.resize(2 * n - 1);
+    nodes_count_ = 1;
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        build_node(0, 0, n, 0);
+    }
+}
+
+/// \brief Refit tree after points move.
+///
+/// Recalculate boxes of all nodes without changing tree topology.
+///
+/// \param[in] ps New points (the same count as while building).
+void
+BVH::refit(const vector<Vector>& ps)
+{
+    DEBUG_CHECK_ERROR(ps.size() == points.size(), "wrong points count for BVH refit");
+
+    set_points(ps);
+    calc_triangles_boxes();
+
+    // Leaves.
+    #pragma omp parallel for
+    for (size_t i = 0; i < nodes_count_; ++i)
+    {
+        BVHNode& node { nodes[i] };
+
+        if (node.is_leaf())
+        {
+            node.box.clear();
+
+            for (size_t j = node.first; j < node.first + node.count; ++j)
+            {
+                node.box.extend(triangles_boxes[order[j]]);
+            }
+        }
+    }
+
+    // Inner nodes, children always have greater indices than parents.
+    for (size_t i = nodes_count_; i > 0; --i)
+    {
+        BVHNode& node { nodes[i - 1] };
+
+        if (!node.is_leaf())
+        {
+            node.box.set(nodes[node.first].box);
+            node.box.extend(nodes[node.first + 1].box);
+        }
+    }
+}
+
+//
+// Information.
+//
+
+/// \brief Check tree correctness.
+///
+/// Check that each triangle is in exactly one leaf
+/// and boxes of nodes contain boxes of their content.
+///
+/// \return
+/// true - if tree is correct,
+/// false - otherwise.
+bool
+BVH::is_correct() const
+{
+    size_t n { triangles_count() };
+    vector<size_t> hits(n, 0);
+
+    for (size_t i = 0; i < nodes_count_; ++i)
+    {
+        const BVHNode& node { nodes[i] };
+        Box b;
+
+        if (node.is_leaf())
+        {
+            for (size_t j = node.first; j < node.first + node.count; ++j)
+            {
+                ++hits[order[j]];
+                b.extend(triangles_boxes[order[j]]);
+            }
+        }
+        else
+        {
+            b.extend(nodes[node.first].box);
+            b.extend(nodes[node.first + 1].box);
+        }
+
+        if (!b.is_empty())
+        {
+            Box u(node.box);
+
+            u.extend(b);
+
+            if (!u.lo.is_strict_eq(node.box.lo) || !u.hi.is_strict_eq(node.box.hi))
+            {
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (hits[i] != 1)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// Queries.
+//
+
+/// \brief Find closest point.
+///
+/// Find the closest point on triangles surface.
+///
+/// \param[in]  p  Point.
+/// \param[out] q  Closest point.
+/// \param[out] ti Index of triangle of the closest point.
+///
+/// \return
+/// true - if point is found,
+/// false - if tree is empty.
+bool
+BVH::closest_point(const Vector& p,
+                   Vector& q,
+                   size_t& ti) const
+{
+    double best { numeric_limits<double>::infinity() };
+    bool is_found { false };
+    size_t stack[stack_size];
+    size_t top { 0 };
+    Vector cur;
+
+    if (nodes_count_ == 0)
+    {
+        return false;
+    }
+
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BVHNode& node { nodes[stack[--top]] };
+
+        if (node.box.dist2_to(p) >= best)
+        {
+            continue;
+        }
+
+        if (node.is_leaf())
+        {
+            for (size_t j = node.first; j < node.first + node.count; ++j)
+            {
+                size_t t { order[j] };
+
+                triangle_closest_point(p,
+                                       triangle_point(t, 0), triangle_point(t, 1), triangle_point(t, 2),
+                                       cur);
+
+                double d2 { Vector(cur.x - p.x, cur.y - p.y, cur.z - p.z).mod2() };
+
+                if (d2 < best)
+                {
+                    best = d2;
+                    q.set(cur);
+                    ti = t;
+                    is_found = true;
+                }
+            }
+        }
+        else
+        {
+            size_t l { node.first }, r { node.first + 1 };
+            double dl { nodes[l].box.dist2_to(p) }, dr { nodes[r].box.dist2_to(p) };
+
+            // Nearest child is processed first.
+            if (dl > dr)
+            {
+                swap(l, r);
+                swap(dl, dr);
+            }
+
+            if (dr < best)
+            {
+                stack[top++] = r;
+            }
+
+            if (dl < best)
+            {
+                stack[top++] = l;
+            }
+        }
+    }
+
+    return is_found;
+}
+
+/// \brief Find first hit of ray.
+///
+/// Find first intersection of ray o + t * d, t in [0, tmax] with triangles.
+///
+/// \param[in]  o    Ray origin.
+/// \param[in]  d    Ray direction.
+/// \param[in]  tmax Maximum ray parameter.
+/// \param[out] t    Ray parameter of hit point.
+/// \param[out] ti   Index of hit triangle.
+///
+/// \return
+/// true - if ray hits triangles,
+/// false - otherwise.
+bool
+BVH::ray_first_hit(const Vector& o,
+                   const Vector& d,
+                   double tmax,
+                   double& t,
+                   size_t& ti) const
+{
+    Vector inv_d(1.0 / d.x, 1.0 / d.y, 1.0 / d.z);
+    double best { tmax };
+    bool is_found { false };
+    size_t stack[stack_size];
+    size_t top { 0 };
+
+    if (nodes_count_ == 0)
+    {
+        return false;
+    }
+
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BVHNode& node { nodes[stack[--top]] };
+        double tnear { 0.0 };
+
+        if (!node.box.intersect_ray(o, inv_d, best, tnear))
+        {
+            continue;
+        }
+
+        if (node.is_leaf())
+        {
+            for (size_t j = node.first; j < node.first + node.count; ++j)
+            {
+                size_t tri { order[j] };
+                double th { 0.0 };
+
+                if (triangle_ray_intersection(o, d,
+                                              triangle_point(tri, 0),
+                                              triangle_point(tri, 1),
+                                              triangle_point(tri, 2),
+                                              th)
+                    && (th <= best))
+                {
+                    best = th;
+                    t = th;
+                    ti = tri;
+                    is_found = true;
+                }
+            }
+        }
+        else
+        {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+        }
+    }
+
+    return is_found;
+}
+
+/// \brief Find triangles which boxes intersect box.
+///
+/// Find all triangles which bounding boxes intersect given box.
+///
+/// \param[in]  b   Box.
+/// \param[out] tis Indices of triangles.
+void
+BVH::find_triangles_in_box(const Box& b,
+                           vector<size_t>& tis) const
+{
+    size_t stack[stack_size];
+    size_t top { 0 };
+
+    tis.clear();
+
+    if (nodes_count_ == 0)
+    {
+        return;
+    }
+
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const BVHNode& node { nodes[stack[--top]] };
+
+        if (!node.box.is_intersect(b))
+        {
+            continue;
+        }
+
+        if (node.is_leaf())
+        {
+            for (size_t j = node.first; j < node.first + node.count; ++j)
+            {
+                if (triangles_boxes[order[j]].is_intersect(b))
+                {
+                    tis.push_back(order[j]);
+                }
+            }
+        }
+        else
+        {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+        }
+    }
+}
+
+//
+// Batched queries.
+//
+
+/// \brief Find closest points for many points.
+///
+/// Find closest points in parallel.
+/// If there is no closest point, triangle index is set to maximum size_t value.
+///
+/// \param[in]  ps  Points.
+/// \param[out] qs  Closest points.
+/// \param[out] tis Indices of triangles.
+void
+BVH::closest_points(const vector<Vector>& ps,
+                    vector<Vector>& qs,
+                    vector<size_t>& tis) const
+{
+    size_t n { ps.size() };
+
+    qs.clear();
+    qs.resize(n);
+    tis.assign(n, numeric_limits<size_t>::max());
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t ti { 0 };
+
+        if (closest_point(ps[i], qs[i], ti))
+        {
+            tis[i] = ti;
+        }
+    }
+}
+
+/// \brief Find first hits for many rays.
+///
+/// Find first hits in parallel.
+/// If ray does not hit triangles, triangle index is set to maximum size_t value
+/// and ray parameter is set to infinity.
+///
+/// \param[in]  os   Rays origins.
+/// \param[in]  ds   Rays directions.
+/// \param[in]  tmax Maximum ray parameter.
+/// \param[out] ts   Rays parameters of hit points.
+/// \param[out] tis  Indices of hit triangles.
+void
+BVH::rays_first_hits(const vector<Vector>& os,
+                     const vector<Vector>& ds,
+                     double tmax,
+                     vector<double>& ts,
+                     vector<size_t>& tis) const
+{
+    DEBUG_CHECK_ERROR(os.size() == ds.size(), "rays origins and directions count mismatch");
+
+    size_t n { os.size() };
+
+    ts.assign(n, numeric_limits<double>::infinity());
+    tis.assign(n, numeric_limits<size_t>::max());
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < n; ++i)
+    {
+        double t { 0.0 };
+        size_t ti { 0 };
+
+        if (ray_first_hit(os[i], ds[i], tmax, t, ti))
+        {
+            ts[i] = t;
+            tis[i] = ti;
+        }
+    }
+}
+
+/// @}
+
+}
+
+}
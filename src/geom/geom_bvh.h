@@ -0,0 +1,255 @@
+/// \file
+/// \brief Bounding volume hierarchy over triangles declaration.
+///
+/// Bounding volume hierarchy over triangles declaration.
+
+#ifndef CAESAR_GEOM_BVH_H
+#define CAESAR_GEOM_BVH_H
+
+#include <vector>
+
+#include "geom_box.h"
+
+using namespace std;
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+/// \brief Node of bounding volume hierarchy.
+///
+/// Inner node holds index of its left child (right child is next to it),
+/// leaf holds range of triangles in order vector.
+struct BVHNode
+{
+    /// \brief Bounding box.
+    Box box;
+
+    /// \brief Index of left child (for inner node) or first triangle position (for leaf).
+    size_t first { 0 };
+
+    /// \brief Count of triangles (zero for inner node).
+    size_t count { 0 };
+
+    /// \brief Check if node is leaf.
+    ///
+    /// Check if node is leaf.
+    ///
+    /// \return
+    /// true - if node is leaf,
+    /// false - otherwise.
+    inline bool
+    is_leaf() const
+    {
+        return count > 0;
+    }
+};
+
+/// \brief Bounding volume hierarchy over triangles.
+///
+/// Triangles are given by points and triples of points indices.
+/// Tree is built with binned surface area heuristic,
+/// subtrees are built in parallel with OpenMP tasks.
+class BVH
+{
+
+private:
+
+    /// \brief Count of bins for SAH.
+    static const size_t bins_count { 16 };
+
+    /// \brief Maximum count of triangles in leaf.
+    static const size_t max_leaf_size { 4 };
+
+    /// \brief Maximum depth of tree (deeper ranges of triangles are put in leaves).
+    static const size_t max_depth { 48 };
+
+    /// \brief Size of stack of queries (not less than max_depth + 1).
+    static const size_t stack_size { 64 };
+
+    /// \brief Minimum count of triangles for spawning build task.
+    static const size_t min_task_size { 4096 };
+
+    /// \brief Points.
+    vector<Vector> points;
+
+    /// \brief Triangles (three points indices for each triangle).
+    vector<size_t> triangles;
+
+    /// \brief Triangles boxes.
+    vector<Box> triangles_boxes;
+
+    /// \brief Triangles centroids.
+    vector<Vector> centroids;
+
+    /// \brief Order of triangles (leaves hold ranges of this vector).
+    vector<size_t> order;
+
+    /// \brief Nodes (root is 0-th node).
+    vector<BVHNode> nodes;
+
+    /// \brief Count of used nodes.
+    size_t nodes_count_ { 0 };
+
+    // Set points.
+    void
+    set_points(const vector<Vector>& ps);
+
+    // Calculate triangles boxes and centroids.
+    void
+    calc_triangles_boxes();
+
+    // Allocate pair of nodes.
+    size_t
+    allocate_nodes_pair();
+
+    // Build node.
+    void
+    build_node(size_t ni,
+               size_t first,
+               size_t count,
+               size_t depth);
+
+    // Split range of triangles.
+    size_t
+    split(size_t first,
+          size_t count,
+          const Box& centroids_box);
+
+public:
+
+    // Default constructor.
+    BVH();
+
+    // Default destructor.
+    ~BVH();
+
+    //
+    // Build.
+    //
+
+    // Build tree.
+    void
+    build(const vector<Vector>& ps,
+          const vector<size_t>& ts);
+
+    // Refit tree after points move.
+    void
+    refit(const vector<Vector>& ps);
+
+    //
+    // Information.
+    //
+
+    /// \brief Count of triangles.
+    ///
+    /// Count of triangles.
+    ///
+    /// \return
+    /// Count of triangles.
+    inline size_t
+    triangles_count() const
+    {
+        return triangles.size() / 3;
+    }
+
+    /// \brief Count of nodes.
+    ///
+    /// Count of nodes.
+    ///
+    /// \return
+    /// Count of nodes.
+    inline size_t
+    nodes_count() const
+    {
+        return nodes_count_;
+    }
+
+    /// \brief Get triangle point.
+    ///
+    /// Get point of triangle.
+    ///
+    /// \param[in] ti Triangle index.
+    /// \param[in] j  Local point index (0, 1, 2).
+    ///
+    /// \return
+    /// Point.
+    inline const Vector&
+    triangle_point(size_t ti,
+                   size_t j) const
+    {
+        return points[triangles[3 * ti + j]];
+    }
+
+    /// \brief Get triangle box.
+    ///
+    /// Get triangle box.
+    ///
+    /// \param[in] ti Triangle index.
+    ///
+    /// \return
+    /// Triangle box.
+    inline const Box&
+    triangle_box(size_t ti) const
+    {
+        return triangles_boxes[ti];
+    }
+
+    // Check tree correctness.
+    bool
+    is_correct() const;
+
+    //
+    // Queries.
+    //
+
+    // Find closest point.
+    bool
+    closest_point(const Vector& p,
+                  Vector& q,
+                  size_t& ti) const;
+
+    // Find first hit of ray.
+    bool
+    ray_first_hit(const Vector& o,
+                  const Vector& d,
+                  double tmax,
+                  double& t,
+                  size_t& ti) const;
+
+    // Find triangles which boxes intersect box.
+    void
+    find_triangles_in_box(const Box& b,
+                          vector<size_t>& tis) const;
+
+    //
+    // Batched queries.
+    //
+
+    // Find closest points for many points.
+    void
+    closest_points(const vector<Vector>& ps,
+                   vector<Vector>& qs,
+                   vector<size_t>& tis) const;
+
+    // Find first hits for many rays.
+    void
+    rays_first_hits(const vector<Vector>& os,
+                    const vector<Vector>& ds,
+                    double tmax,
+                    vector<double>& ts,
+                    vector<size_t>& tis) const;
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_GEOM_BVH_H
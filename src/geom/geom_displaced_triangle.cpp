@@ -42,6 +42,48 @@ displaced_triangle_volume(const Vector& a,
            + tetrahedron_volume(a, na, nb, nc);
 }
 
+/// \brief Displaced triangles volumes (batch version).
+///
+/// Volumes of many displaced triangles.
+///
+/// \param[in]  a  First points.
+/// \param[in]  b  Second points.
+/// \param[in]  c  Third points.
+/// \param[in]  na New positions of first points.
+/// \param[in]  nb New positions of second points.
+/// \param[in]  nc New positions of third points.
+/// \param[out] v  Volumes.
+void
+displaced_triangle_volume(const VectorsArray& a,
+                          const VectorsArray& b,
+                          const VectorsArray& c,
+                          const VectorsArray& na,
+                          const VectorsArray& nb,
+                          const VectorsArray& nc,
+                          vector<double>& v)
+{
+    size_t n { a.size() };
+
+    v.resize(n);
+
+    #pragma omp parallel for simd
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] = tetrahedron_volume(a.x[i], a.y[i], a.z[i],
+                                  b.x[i], b.y[i], b.z[i],
+                                  c.x[i], c.y[i], c.z[i],
+                                  nc.x[i], nc.y[i], nc.z[i])
+               + tetrahedron_volume(a.x[i], a.y[i], a.z[i],
+                                    b.x[i], b.y[i], b.z[i],
+                                    nb.x[i], nb.y[i], nb.z[i],
+                                    nc.x[i], nc.y[i], nc.z[i])
+               + tetrahedron_volume(a.x[i], a.y[i], a.z[i],
+                                    na.x[i], na.y[i], na.z[i],
+                                    nb.x[i], nb.y[i], nb.z[i],
+                                    nc.x[i], nc.y[i], nc.z[i]);
+    }
+}
+
 /// @}
 
 }
@@ -6,7 +6,7 @@
 #ifndef CAESAR_GEOM_DISPLACED_TRIANGLE_H
 #define CAESAR_GEOM_DISPLACED_TRIANGLE_H
 
-#include "geom_vector.h"
+#include "geom_vectors_array.h"
 
 namespace caesar
 {
@@ -26,6 +26,16 @@ displaced_triangle_volume(const Vector& a,
                           const Vector& nb,
                           const Vector& nc);
 
+// Displaced triangles volumes (batch version).
+void
+displaced_triangle_volume(const VectorsArray& a,
+                          const VectorsArray& b,
+                          const VectorsArray& c,
+                          const VectorsArray& na,
+                          const VectorsArray& nb,
+                          const VectorsArray& nc,
+                          vector<double>& v);
+
 /// @}
 
 }
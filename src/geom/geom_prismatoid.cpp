@@ -68,6 +68,80 @@ prismatoid_volume_coefficients(const Vector& v1,
     c = (1.0 / 6.0) * (u21_u31 * n);
 }
 
+/// \brief Define coefficients for prismatoids volumes (batch version).
+///
+/// Coefficients of many prismatoids volumes.
+/// The same formulas as in the single prismatoid version written on coordinates.
+///
+/// \param[in]  v1 Vectors of base points.
+/// \param[in]  v2 Vectors of base points.
+/// \param[in]  v3 Vectors of base points.
+/// \param[in]  n1 Directions from base points.
+/// \param[in]  n2 Directions from base points.
+/// \param[in]  n3 Directions from base points.
+/// \param[in]  n  Normals of bases.
+/// \param[out] a  First coefficients.
+/// \param[out] b  Second coefficients.
+/// \param[out] c  Third coefficients.
+void
+prismatoid_volume_coefficients(const VectorsArray& v1,
+                               const VectorsArray& v2,
+                               const VectorsArray& v3,
+                               const VectorsArray& n1,
+                               const VectorsArray& n2,
+                               const VectorsArray& n3,
+                               const VectorsArray& n,
+                               vector<double>& a,
+                               vector<double>& b,
+                               vector<double>& c)
+{
+    size_t cnt { v1.size() };
+
+    a.resize(cnt);
+    b.resize(cnt);
+    c.resize(cnt);
+
+    #pragma omp parallel for simd
+    for (size_t i = 0; i < cnt; ++i)
+    {
+        double nx { n.x[i] }, ny { n.y[i] }, nz { n.z[i] };
+
+        // p_ij
+        double v21x { v2.x[i] - v1.x[i] }, v21y { v2.y[i] - v1.y[i] }, v21z { v2.z[i] - v1.z[i] };
+        double v31x { v3.x[i] - v1.x[i] }, v31y { v3.y[i] - v1.y[i] }, v31z { v3.z[i] - v1.z[i] };
+
+        // u_ij
+        double k1 { 1.0 / (nx * n1.x[i] + ny * n1.y[i] + nz * n1.z[i]) };
+        double k2 { 1.0 / (nx * n2.x[i] + ny * n2.y[i] + nz * n2.z[i]) };
+        double k3 { 1.0 / (nx * n3.x[i] + ny * n3.y[i] + nz * n3.z[i]) };
+        double u21x { n2.x[i] * k2 - n1.x[i] * k1 };
+        double u21y { n2.y[i] * k2 - n1.y[i] * k1 };
+        double u21z { n2.z[i] * k2 - n1.z[i] * k1 };
+        double u31x { n3.x[i] * k3 - n1.x[i] * k1 };
+        double u31y { n3.y[i] * k3 - n1.y[i] * k1 };
+        double u31z { n3.z[i] * k3 - n1.z[i] * k1 };
+
+        // v21 x v31
+        double px { v21y * v31z - v21z * v31y };
+        double py { v21z * v31x - v21x * v31z };
+        double pz { v21x * v31y - v21y * v31x };
+
+        // v21 x u31 + u21 x v31
+        double qx { (v21y * u31z - v21z * u31y) + (u21y * v31z - u21z * v31y) };
+        double qy { (v21z * u31x - v21x * u31z) + (u21z * v31x - u21x * v31z) };
+        double qz { (v21x * u31y - v21y * u31x) + (u21x * v31y - u21y * v31x) };
+
+        // u21 x u31
+        double rx { u21y * u31z - u21z * u31y };
+        double ry { u21z * u31x - u21x * u31z };
+        double rz { u21x * u31y - u21y * u31x };
+
+        a[i] = 0.5 * sqrt(px * px + py * py + pz * pz);
+        b[i] = 0.25 * (qx * nx + qy * ny + qz * nz);
+        c[i] = (1.0 / 6.0) * (rx * nx + ry * ny + rz * nz);
+    }
+}
+
 /// @}
 
 }
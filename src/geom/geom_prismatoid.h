@@ -6,7 +6,7 @@
 #ifndef CAESAR_GEOM_PRISMATOID_H
 #define CAESAR_GEOM_PRISMATOID_H
 
-#include "geom_vector.h"
+#include "geom_vectors_array.h"
 
 namespace caesar
 {
@@ -30,6 +30,19 @@ prismatoid_volume_coefficients(const Vector& v1,
                                double& b,
                                double& c);
 
+// Define coefficients for prismatoids volumes (batch version).
+void
+prismatoid_volume_coefficients(const VectorsArray& v1,
+                               const VectorsArray& v2,
+                               const VectorsArray& v3,
+                               const VectorsArray& n1,
+                               const VectorsArray& n2,
+                               const VectorsArray& n3,
+                               const VectorsArray& n,
+                               vector<double>& a,
+                               vector<double>& b,
+                               vector<double>& c);
+
 /// @}
 
 }
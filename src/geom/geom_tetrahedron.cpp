@@ -41,6 +41,36 @@ tetrahedron_volume(const Vector& a,
     return abs(ad * cr) / 6.0;
 }
 
+/// \brief Tetrahedrons volumes (batch version).
+///
+/// Volumes of many tetrahedrons.
+///
+/// \param[in]  a First points.
+/// \param[in]  b Second points.
+/// \param[in]  c Third points.
+/// \param[in]  d 4th points.
+/// \param[out] v Volumes.
+void
+tetrahedron_volume(const VectorsArray& a,
+                   const VectorsArray& b,
+                   const VectorsArray& c,
+                   const VectorsArray& d,
+                   vector<double>& v)
+{
+    size_t n { a.size() };
+
+    v.resize(n);
+
+    #pragma omp parallel for simd
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i] = tetrahedron_volume(a.x[i], a.y[i], a.z[i],
+                                  b.x[i], b.y[i], b.z[i],
+                                  c.x[i], c.y[i], c.z[i],
+                                  d.x[i], d.y[i], d.z[i]);
+    }
+}
+
 /// @}
 
 }
@@ -6,7 +6,7 @@
 #ifndef CAESAR_GEOM_TETRAHEDRON_H
 #define CAESAR_GEOM_TETRAHEDRON_H
 
-#include "geom_vector.h"
+#include "geom_vectors_array.h"
 
 namespace caesar
 {
@@ -24,6 +24,48 @@ tetrahedron_volume(const Vector& a,
                    const Vector& c,
                    const Vector& d);
 
+/// \brief Tetrahedron volume by coordinates.
+///
+/// Tetrahedron volume by coordinates of points (kernel for batch functions).
+///
+/// \param[in] ax X coordinate of first point.
+/// \param[in] ay Y coordinate of first point.
+/// \param[in] az Z coordinate of first point.
+/// \param[in] bx X coordinate of second point.
+/// \param[in] by Y coordinate of second point.
+/// \param[in] bz Z coordinate of second point.
+/// \param[in] cx X coordinate of third point.
+/// \param[in] cy Y coordinate of third point.
+/// \param[in] cz Z coordinate of third point.
+/// \param[in] dx X coordinate of 4th point.
+/// \param[in] dy Y coordinate of 4th point.
+/// \param[in] dz Z coordinate of 4th point.
+///
+/// \return
+/// Volume.
+inline double
+tetrahedron_volume(double ax, double ay, double az,
+                   double bx, double by, double bz,
+                   double cx, double cy, double cz,
+                   double dx, double dy, double dz)
+{
+    double adx { ax - dx }, ady { ay - dy }, adz { az - dz };
+    double bdx { bx - dx }, bdy { by - dy }, bdz { bz - dz };
+    double cdx { cx - dx }, cdy { cy - dy }, cdz { cz - dz };
+
+    return abs(adx * (bdy * cdz - bdz * cdy)
+               + ady * (bdz * cdx - bdx * cdz)
+               + adz * (bdx * cdy - bdy * cdx)) / 6.0;
+}
+
+// Tetrahedrons volumes (batch version).
+void
+tetrahedron_volume(const VectorsArray& a,
+                   const VectorsArray& b,
+                   const VectorsArray& c,
+                   const VectorsArray& d,
+                   vector<double>& v);
+
 /// @}
 
 }
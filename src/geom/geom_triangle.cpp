@@ -0,0 +1,296 @@
+/// \file
+/// \brief Triangle functions implementation.
+///
+/// Triangle functions implementation.
+
+#include "geom_triangle.h"
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+/// \brief Closest point of triangle.
+///
+/// Find point of triangle which is the closest to the given point.
+/// Point is classified by Voronoi regions of triangle vertices, edges and face.
+///
+/// source:
+/// Ericson C.
+/// Real-time collision detection.
+/// section 5.1.5
+///
+/// \param[in]  p Point.
+/// \param[in]  a First point of triangle.
+/// \param[in]  b Second point of triangle.
+/// \param[in]  c Third point of triangle.
+/// \param[out] q Closest point.
+void
+triangle_closest_point(const Vector& p,
+                       const Vector& a,
+                       const Vector& b,
+                       const Vector& c,
+                       Vector& q)
+{
+    Vector ab, ac, ap, bp, cp;
+
+    Vector::sub(b, a, ab);
+    Vector::sub(c, a, ac);
+    Vector::sub(p, a, ap);
+
+    // Vertex region A.
+    double d1 { ab * ap }, d2 { ac * ap };
+
+    if ((d1 <= 0.0) && (d2 <= 0.0))
+    {
+        q.set(a);
+
+        return;
+    }
+
+    // Vertex region B.
+    Vector::sub(p, b, bp);
+
+    double d3 { ab * bp }, d4 { ac * bp };
+
+    if ((d3 >= 0.0) && (d4 <= d3))
+    {
+        q.set(b);
+
+        return;
+    }
+
+    // Edge region AB.
+    double vc { d1 * d4 - d3 * d2 };
+
+    if ((vc <= 0.0) && (d1 >= 0.0) && (d3 <= 0.0))
+    {
+        Vector::fma(ab, d1 / (d1 - d3), a, q);
+
+        return;
+    }
+
+    // Vertex region C.
+    Vector::sub(p, c, cp);
+
+    double d5 { ab * cp }, d6 { ac * cp };
+
+    if ((d6 >= 0.0) && (d5 <= d6))
+    {
+        q.set(c);
+
+        return;
+    }
+
+    // Edge region AC.
+    double vb { d5 * d2 - d1 * d6 };
+
+    if ((vb <= 0.0) && (d2 >= 0.0) && (d6 <= 0.0))
+    {
+        Vector::fma(ac, d2 / (d2 - d6), a, q);
+
+        return;
+    }
+
+    // Edge region BC.
+    double va { d3 * d6 - d5 * d4 };
+
+    if ((va <= 0.0) && ((d4 - d3) >= 0.0) && ((d5 - d6) >= 0.0))
+    {
+        Vector bc;
+
+        Vector::sub(c, b, bc);
+        Vector::fma(bc, (d4 - d3) / ((d4 - d3) + (d5 - d6)), b, q);
+
+        return;
+    }
+
+    // Face region.
+    double denom { 1.0 / (va + vb + vc) };
+
+    Vector::linear_combination(ab, vb * denom, ac, vc * denom, q);
+    q.add(a);
+}
+
+/// \brief Barycentric coordinates of point in triangle.
+///
+/// Barycentric coordinates of point projection on triangle plane.
+/// For degenerate triangle all coordinates are equal.
+///
+/// source:
+/// Ericson C.
+/// Real-time collision detection.
+/// section 3.4
+///
+/// \param[in]  p Point.
+/// \param[in]  a First point of triangle.
+/// \param[in]  b Second point of triangle.
+/// \param[in]  c Third point of triangle.
+/// \param[out] u Coordinate for a.
+/// \param[out] v Coordinate for b.
+/// \param[out] w Coordinate for c.
+void
+triangle_barycentric(const Vector& p,
+                     const Vector& a,
+                     const Vector& b,
+                     const Vector& c,
+                     double& u,
+                     double& v,
+                     double& w)
+{
+    Vector v0, v1, v2;
+
+    Vector::sub(b, a, v0);
+    Vector::sub(c, a, v1);
+    Vector::sub(p, a, v2);
+
+    double d00 { v0 * v0 }, d01 { v0 * v1 }, d11 { v1 * v1 };
+    double d20 { v2 * v0 }, d21 { v2 * v1 };
+    double denom { d00 * d11 - d01 * d01 };
+
+    if (denom <= mth::Eps * d00 * d11)
+    {
+        u = v = w = 1.0 / 3.0;
+
+        return;
+    }
+
+    v = (d11 * d20 - d01 * d21) / denom;
+    w = (d00 * d21 - d01 * d20) / denom;
+    u = 1.0 - v - w;
+}
+
+/// \brief Intersect ray with triangle.
+///
+/// Two-sided intersection of ray o + t * d (t >= 0) with triangle.
+///
+/// source:
+/// Moller T., Trumbore B.
+/// Fast, minimum storage ray/triangle intersection.
+///
+/// \param[in]  o Ray origin.
+/// \param[in]  d Ray direction.
+/// \param[in]  a First point of triangle.
+/// \param[in]  b Second point of triangle.
+/// \param[in]  c Third point of triangle.
+/// \param[out] t Ray parameter of intersection point.
+///
+/// \return
+/// true - if ray intersects triangle,
+/// false - otherwise.
+bool
+triangle_ray_intersection(const Vector& o,
+                          const Vector& d,
+                          const Vector& a,
+                          const Vector& b,
+                          const Vector& c,
+                          double& t)
+{
+    Vector e1, e2, pv, tv, qv;
+
+    Vector::sub(b, a, e1);
+    Vector::sub(c, a, e2);
+    Vector::cross_product(d, e2, pv);
+
+    double det { e1 * pv };
+
+    // Ray is parallel to triangle plane.
+    if (abs(det) < mth::Eps * e1.mod() * e2.mod())
+    {
+        return false;
+    }
+
+    double inv_det { 1.0 / det };
+
+    Vector::sub(o, a, tv);
+
+    double u { (tv * pv) * inv_det };
+
+    if ((u < 0.0) || (u > 1.0))
+    {
+        return false;
+    }
+
+    Vector::cross_product(tv, e1, qv);
+
+    double v { (d * qv) * inv_det };
+
+    if ((v < 0.0) || (u + v > 1.0))
+    {
+        return false;
+    }
+
+    t = (e2 * qv) * inv_det;
+
+    return t >= 0.0;
+}
+
+/// \brief Check intersection of segment with triangle.
+///
+/// Check if segment [p, q] intersects triangle.
+///
+/// \param[in] p First point of segment.
+/// \param[in] q Second point of segment.
+/// \param[in] a First point of triangle.
+/// \param[in] b Second point of triangle.
+/// \param[in] c Third point of triangle.
+///
+/// \return
+/// true - if segment intersects triangle,
+/// false - otherwise.
+static bool
+segment_triangle_intersection(const Vector& p,
+                              const Vector& q,
+                              const Vector& a,
+                              const Vector& b,
+                              const Vector& c)
+{
+    Vector d;
+    double t { 0.0 };
+
+    Vector::sub(q, p, d);
+
+    return triangle_ray_intersection(p, d, a, b, c, t) && (t <= 1.0);
+}
+
+/// \brief Check intersection of two triangles.
+///
+/// Two non-coplanar triangles intersect if and only if
+/// some edge of one triangle intersects another triangle.
+/// Coplanar overlapping is not detected.
+///
+/// \param[in] a0 First point of first triangle.
+/// \param[in] a1 Second point of first triangle.
+/// \param[in] a2 Third point of first triangle.
+/// \param[in] b0 First point of second triangle.
+/// \param[in] b1 Second point of second triangle.
+/// \param[in] b2 Third point of second triangle.
+///
+/// \return
+/// true - if triangles intersect,
+/// false - otherwise.
+bool
+triangles_intersection(const Vector& a0,
+                       const Vector& a1,
+                       const Vector& a2,
+                       const Vector& b0,
+                       const Vector& b1,
+                       const Vector& b2)
+{
+    return segment_triangle_intersection(a0, a1, b0, b1, b2)
+           || segment_triangle_intersection(a1, a2, b0, b1, b2)
+           || segment_triangle_intersection(a2, a0, b0, b1, b2)
+           || segment_triangle_intersection(b0, b1, a0, a1, a2)
+           || segment_triangle_intersection(b1, b2, a0, a1, a2)
+           || segment_triangle_intersection(b2, b0, a0, a1, a2);
+}
+
+/// @}
+
+}
+
+}
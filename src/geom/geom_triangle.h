@@ -0,0 +1,62 @@
+/// \file
+/// \brief Triangle functions declaration.
+///
+/// Triangle functions declaration.
+
+#ifndef CAESAR_GEOM_TRIANGLE_H
+#define CAESAR_GEOM_TRIANGLE_H
+
+#include "geom_vector.h"
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+// Closest point of triangle.
+void
+triangle_closest_point(const Vector& p,
+                       const Vector& a,
+                       const Vector& b,
+                       const Vector& c,
+                       Vector& q);
+
+// Barycentric coordinates of point in triangle.
+void
+triangle_barycentric(const Vector& p,
+                     const Vector& a,
+                     const Vector& b,
+                     const Vector& c,
+                     double& u,
+                     double& v,
+                     double& w);
+
+// Intersect ray with triangle.
+bool
+triangle_ray_intersection(const Vector& o,
+                          const Vector& d,
+                          const Vector& a,
+                          const Vector& b,
+                          const Vector& c,
+                          double& t);
+
+// Check intersection of two triangles.
+bool
+triangles_intersection(const Vector& a0,
+                       const Vector& a1,
+                       const Vector& a2,
+                       const Vector& b0,
+                       const Vector& b1,
+                       const Vector& b2);
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_GEOM_TRIANGLE_H
@@ -0,0 +1,60 @@
+/// \file
+/// \brief Array of vectors implementation.
+///
+/// Array of vectors implementation.
+
+#include "geom_vectors_array.h"
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+/// \brief Default constructor.
+///
+/// Default constructor.
+VectorsArray::VectorsArray()
+{
+}
+
+/// \brief Constructor with size.
+///
+/// Create array of zero vectors.
+///
+/// \param[in] n Size of array.
+VectorsArray::VectorsArray(size_t n)
+    : x(n, 0.0),
+      y(n, 0.0),
+      z(n, 0.0)
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+VectorsArray::~VectorsArray()
+{
+}
+
+/// \brief Resize array.
+///
+/// Resize array.
+///
+/// \param[in] n New size.
+void
+VectorsArray::resize(size_t n)
+{
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+}
+
+/// @}
+
+}
+
+}
@@ -0,0 +1,102 @@
+/// \file
+/// \brief Array of vectors declaration.
+///
+/// Array of vectors in structure of arrays layout.
+
+#ifndef CAESAR_GEOM_VECTORS_ARRAY_H
+#define CAESAR_GEOM_VECTORS_ARRAY_H
+
+#include <vector>
+
+#include "geom_vector.h"
+
+using namespace std;
+
+namespace caesar
+{
+
+namespace geom
+{
+
+/// \addtogroup geom
+/// @{
+
+/// \brief Array of vectors.
+///
+/// Coordinates of vectors are stored in separate arrays,
+/// so batch kernels may be vectorized.
+class VectorsArray
+{
+
+public:
+
+    /// \brief X coordinates.
+    vector<double> x;
+
+    /// \brief Y coordinates.
+    vector<double> y;
+
+    /// \brief Z coordinates.
+    vector<double> z;
+
+    // Default constructor.
+    VectorsArray();
+
+    // Constructor with size.
+    explicit VectorsArray(size_t n);
+
+    // Default destructor.
+    ~VectorsArray();
+
+    /// \brief Size of array.
+    ///
+    /// Size of array.
+    ///
+    /// \return
+    /// Size of array.
+    inline size_t
+    size() const
+    {
+        return x.size();
+    }
+
+    // Resize array.
+    void
+    resize(size_t n);
+
+    /// \brief Set vector.
+    ///
+    /// Set vector in array.
+    ///
+    /// \param[in] i Index.
+    /// \param[in] v Vector.
+    inline void
+    set(size_t i,
+        const Vector& v)
+    {
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+
+    /// \brief Get vector.
+    ///
+    /// Get vector from array.
+    ///
+    /// \param[in]  i Index.
+    /// \param[out] v Vector.
+    inline void
+    get(size_t i,
+        Vector& v) const
+    {
+        v.set(x[i], y[i], z[i]);
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_GEOM_VECTORS_ARRAY_H
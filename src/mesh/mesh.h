@@ -8,8 +8,14 @@
 
 #include "mesh_mesh.h"
 #include "mesh_filer.h"
+#include "mesh_quality.h"
+#include "mesh_transfer.h"
+#include "mesh_topology.h"
 #include "mesh_remesher.h"
+#include "mesh_ensemble.h"
 #include "mesh_decomposer.h"
+#include "mesh_partitioner.h"
+#include "mesh_migrator.h"
 #include "mesh_edges_colorizer.h"
 
 #endif // !CAESAR_MESH_H
@@ -51,6 +51,318 @@ Boundaries::allocate()
     comm.allocate();
 }
 
+/// \brief Clear boundaries.
+///
+/// Remove all boundaries and communicator buffers, so boundaries may be allocated again.
+void
+Boundaries::clear()
+{
+    boundaries.clear();
+    comm.clear();
+}
+
+/// \brief Sort pairs of all boundaries by original identifiers of cells.
+///
+/// Sort pairs of all boundaries by original identifiers of cells.
+void
+Boundaries::sort_by_orig_ids()
+{
+    for (Boundary& b : boundaries)
+    {
+        b.sort_by_orig_ids();
+    }
+}
+
+/// \brief Add domain into sorted list of domains.
+///
+/// Add domain into sorted list of domains if it is not there.
+///
+/// \param[in,out] ds Domains.
+/// \param[in]     d  Domain.
+static void
+add_domain(vector<size_t>& ds,
+           size_t d)
+{
+    auto it = lower_bound(ds.begin(), ds.end(), d);
+
+    if ((it == ds.end()) || (*it != d))
+    {
+        ds.insert(it, d);
+    }
+}
+
+/// \brief Neighbours of cell for ghost layers.
+///
+/// Indices of cells adjacent to given cell.
+///
+/// \param[in]  c         Cell.
+/// \param[in]  adjacency Adjacency of cells.
+/// \param[out] ngh       Indices of neighbours.
+static void
+ghost_neighbours(Cell* c,
+                 GhostAdjacency adjacency,
+                 vector<size_t>& ngh)
+{
+    ngh.clear();
+
+    if (adjacency == GhostAdjacency::Edges)
+    {
+        for (size_t j = 0; j < c->edges_count(); ++j)
+        {
+            Edge* e { c->edge(j) };
+
+            if (e->is_inner())
+            {
+                Cell* nc { (e->cell(0) == c) ? e->cell(1) : e->cell(0) };
+
+                ngh.push_back(static_cast<size_t>(nc->get_id()));
+            }
+        }
+    }
+    else
+    {
+        for (size_t j = 0; j < c->nodes_count(); ++j)
+        {
+            Node* n { c->node(j) };
+
+            for (size_t k = 0; k < n->cells_count(); ++k)
+            {
+                Cell* nc { n->cell(k) };
+
+                if (nc != c)
+                {
+                    ngh.push_back(static_cast<size_t>(nc->get_id()));
+                }
+            }
+        }
+    }
+}
+
+/// \brief Spread domains of cells through ghost layers.
+///
+/// For each cell sorted list of domains which are reached from it
+/// in not more than depth steps is calculated (it includes domain of the cell).
+/// Cell is ghost for all domains of its list except its own one.
+/// Domains are spread from front: only cells which got new domains on previous layer
+/// give them to their neighbours (first front is cells with neighbours of other domains),
+/// so each layer processes only cells near boundaries.
+///
+/// \param[in]  all       All mesh elements.
+/// \param[in]  depth     Depth of ghost layers.
+/// \param[in]  adjacency Adjacency of cells.
+/// \param[out] ds        Lists of domains for cells.
+void
+Boundaries::spread_domains(NodesEdgesCellsHolder& all,
+                           size_t depth,
+                           GhostAdjacency adjacency,
+                           vector<vector<size_t>>& ds)
+{
+    size_t cc { all.cells_count() };
+    vector<vector<size_t>> added(cc), new_added;
+    vector<char> is_front(cc, 0);
+    vector<size_t> front, cands;
+
+    ds.assign(cc, vector<size_t>());
+
+    // Own domains and first front.
+    #pragma omp parallel
+    {
+        vector<size_t> ngh, local_front;
+
+        #pragma omp for
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { all.cell(i) };
+            size_t d { c->get_domain() };
+
+            ds[i].push_back(d);
+            ghost_neighbours(c, adjacency, ngh);
+
+            for (size_t ni : ngh)
+            {
+                if (all.cell(ni)->get_domain() != d)
+                {
+                    local_front.push_back(i);
+
+                    break;
+                }
+            }
+        }
+
+        #pragma omp critical
+        {
+            front.insert(front.end(), local_front.begin(), local_front.end());
+        }
+    }
+
+    sort(front.begin(), front.end());
+
+    #pragma omp parallel for
+    for (size_t fi = 0; fi < front.size(); ++fi)
+    {
+        size_t i { front[fi] };
+
+        is_front[i] = 1;
+        added[i] = ds[i];
+    }
+
+    // Spread domains through adjacent cells layer by layer.
+    for (size_t li = 0; (li < depth) && !front.empty(); ++li)
+    {
+        cands.clear();
+
+        // Candidates are neighbours of front cells.
+        #pragma omp parallel
+        {
+            vector<size_t> ngh, local_cands;
+
+            #pragma omp for
+            for (size_t fi = 0; fi < front.size(); ++fi)
+            {
+                ghost_neighbours(all.cell(front[fi]), adjacency, ngh);
+                local_cands.insert(local_cands.end(), ngh.begin(), ngh.end());
+            }
+
+            #pragma omp critical
+            {
+                cands.insert(cands.end(), local_cands.begin(), local_cands.end());
+            }
+        }
+
+        sort(cands.begin(), cands.end());
+        cands.erase(unique(cands.begin(), cands.end()), cands.end());
+
+        // New domains of candidates (lists of domains are not changed here).
+        new_added.assign(cands.size(), vector<size_t>());
+
+        #pragma omp parallel
+        {
+            vector<size_t> ngh;
+
+            #pragma omp for
+            for (size_t ci = 0; ci < cands.size(); ++ci)
+            {
+                size_t i { cands[ci] };
+
+                ghost_neighbours(all.cell(i), adjacency, ngh);
+
+                for (size_t ni : ngh)
+                {
+                    if (is_front[ni])
+                    {
+                        for (size_t d : added[ni])
+                        {
+                            if (!binary_search(ds[i].begin(), ds[i].end(), d))
+                            {
+                                add_domain(new_added[ci], d);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Old front is cleared.
+        #pragma omp parallel for
+        for (size_t fi = 0; fi < front.size(); ++fi)
+        {
+            size_t i { front[fi] };
+
+            is_front[i] = 0;
+            added[i].clear();
+        }
+
+        // New domains are added, cells with new domains form new front.
+        #pragma omp parallel for
+        for (size_t ci = 0; ci < cands.size(); ++ci)
+        {
+            size_t i { cands[ci] };
+
+            for (size_t d : new_added[ci])
+            {
+                add_domain(ds[i], d);
+            }
+
+            if (!new_added[ci].empty())
+            {
+                is_front[i] = 1;
+                added[i].swap(new_added[ci]);
+            }
+        }
+
+        front.clear();
+
+        for (size_t i : cands)
+        {
+            if (is_front[i])
+            {
+                front.push_back(i);
+            }
+        }
+    }
+}
+
+/// \brief Build ghost layers.
+///
+/// Domains of cells are spread through ghost layers.
+/// Own cell is sent to all these domains,
+/// cell of another domain is received if current domain is in its list.
+/// Lists are ordered by original identifiers of cells (by identifiers if they are not set),
+/// so they are the same in sending and receiving processes without handshake.
+/// For mesh part loaded from domain file depth must be not greater
+/// than count of ghost layers in file.
+///
+/// \param[in] all All mesh elements.
+void
+Boundaries::build_ghosts(NodesEdgesCellsHolder& all)
+{
+    DEBUG_CHECK_ERROR(is_allocated(), "boundaries are not allocated");
+
+    size_t r = parl::mpi_rank();
+    size_t cc { all.cells_count() };
+    vector<vector<size_t>> ds;
+
+    spread_domains(all, ghost_depth, ghost_adjacency, ds);
+
+    // Lists of cells.
+    for (Boundary& b : boundaries)
+    {
+        b.send_cells.clear();
+        b.recv_cells.clear();
+    }
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { all.cell(i) };
+        size_t d { c->get_domain() };
+
+        if (d == r)
+        {
+            for (size_t q : ds[i])
+            {
+                if (q != r)
+                {
+                    boundaries[q].send_cells.push_back(c);
+                }
+            }
+        }
+        else if (binary_search(ds[i].begin(), ds[i].end(), r))
+        {
+            boundaries[d].recv_cells.push_back(c);
+        }
+    }
+
+    // Numbering of cells may differ in processes (for mesh part),
+    // so lists are ordered by original identifiers.
+    for (Boundary& b : boundaries)
+    {
+        sort(b.send_cells.begin(), b.send_cells.end(), utils::IdsHolder::is_less_by_orig_id);
+        sort(b.recv_cells.begin(), b.recv_cells.end(), utils::IdsHolder::is_less_by_orig_id);
+    }
+
+    set_buffers_sizes();
+}
+
 /// \brief Print in current process.
 ///
 /// Print in current process.
@@ -100,7 +412,7 @@ Boundaries::set_buffers_sizes()
 
     for (size_t i = 0; i < s; ++i)
     {
-        comm.set_size(i, boundaries[i].size());
+        comm.set_size(i, boundaries[i].buffer_size());
     }
 }
 
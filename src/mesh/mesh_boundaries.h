@@ -7,6 +7,7 @@
 #define CAESAR_MESH_BOUNDARIES_H
 
 #include "mesh_boundary.h"
+#include "mesh_nodes_edges_cells_holder.h"
 #include "parl/parl.h"
 
 namespace caesar
@@ -18,7 +19,25 @@ namespace mesh
 /// \addtogroup mesh
 /// @{
 
+/// \brief Adjacency of cells for ghost layers.
+///
+/// Adjacency of cells for ghost layers.
+enum class GhostAdjacency
+{
+    /// \brief Cells with common edge.
+    Edges,
+
+    /// \brief Cells with common node.
+    Nodes
+};
+
 /// \brief Boundaries.
+///
+/// Pairs of cells on cross edges describe boundary between domains.
+/// Data is exchanged through ghost layers of given depth:
+/// cell of another domain is ghost if it is reached from own cell
+/// in not more than depth steps through adjacent cells.
+/// All ghost layers are exchanged with one message for each neighbour domain.
 class Boundaries
 {
 
@@ -27,6 +46,12 @@ private:
     /// \brief Vector of boundaries.
     vector<Boundary> boundaries;
 
+    /// \brief Depth of ghost layers.
+    size_t ghost_depth { 1 };
+
+    /// \brief Adjacency of cells for ghost layers.
+    GhostAdjacency ghost_adjacency { GhostAdjacency::Edges };
+
     /// \brief Comminicator.
     parl::AllToAllExchanger comm;
 
@@ -42,6 +67,10 @@ public:
     void
     allocate();
 
+    // Clear boundaries.
+    void
+    clear();
+
     /// \brief Add pair of cells into boundaries.
     ///
     /// Add pair of cell into boundaries.
@@ -57,6 +86,114 @@ public:
         boundaries[neighbour_domain].add(in_cell, neighbour_cell);
     }
 
+    /// \brief Check if boundaries are allocated.
+    ///
+    /// Check if boundaries are allocated.
+    ///
+    /// \return
+    /// true - if boundaries are allocated,
+    /// false - otherwise.
+    inline bool
+    is_allocated() const
+    {
+        return !boundaries.empty();
+    }
+
+    /// \brief Get count of pairs of cells on boundary with neighbour domain.
+    ///
+    /// Get count of pairs of cells on boundary with neighbour domain.
+    ///
+    /// \param[in] neighbour_domain Neighbour domain.
+    ///
+    /// \return
+    /// Count of pairs.
+    inline size_t
+    pairs_count(size_t neighbour_domain) const
+    {
+        return boundaries[neighbour_domain].size();
+    }
+
+    /// \brief Get count of ghost cells received from neighbour domain.
+    ///
+    /// Get count of ghost cells received from neighbour domain.
+    ///
+    /// \param[in] neighbour_domain Neighbour domain.
+    ///
+    /// \return
+    /// Count of ghost cells.
+    inline size_t
+    ghost_cells_count(size_t neighbour_domain) const
+    {
+        return boundaries[neighbour_domain].recv_cells.size();
+    }
+
+    /// \brief Get size of buffer for exchange with neighbour domain.
+    ///
+    /// Get size of buffer for exchange with neighbour domain.
+    ///
+    /// \param[in] neighbour_domain Neighbour domain.
+    ///
+    /// \return
+    /// Size of buffer.
+    inline size_t
+    buffer_size(size_t neighbour_domain) const
+    {
+        return boundaries[neighbour_domain].buffer_size();
+    }
+
+    /// \brief Get depth of ghost layers.
+    ///
+    /// Get depth of ghost layers.
+    ///
+    /// \return
+    /// Depth of ghost layers.
+    inline size_t
+    get_ghost_depth() const
+    {
+        return ghost_depth;
+    }
+
+    /// \brief Get adjacency of cells for ghost layers.
+    ///
+    /// Get adjacency of cells for ghost layers.
+    ///
+    /// \return
+    /// Adjacency.
+    inline GhostAdjacency
+    get_ghost_adjacency() const
+    {
+        return ghost_adjacency;
+    }
+
+    /// \brief Set ghost layers parameters.
+    ///
+    /// Ghost layers are built with these parameters in next build.
+    ///
+    /// \param[in] depth     Depth of ghost layers.
+    /// \param[in] adjacency Adjacency of cells.
+    inline void
+    set_ghost_layers(size_t depth,
+                     GhostAdjacency adjacency)
+    {
+        ghost_depth = depth;
+        ghost_adjacency = adjacency;
+    }
+
+    // Sort pairs of all boundaries by original identifiers of cells.
+    void
+    sort_by_orig_ids();
+
+    // Spread domains of cells through ghost layers.
+    static void
+    spread_domains(NodesEdgesCellsHolder& all,
+                   size_t depth,
+                   GhostAdjacency adjacency,
+                   vector<vector<size_t>>& ds);
+
+    // Build ghost layers.
+    void
+    build_ghosts(NodesEdgesCellsHolder& all);
+
     // Print in current process.
     void
     print(ostream& os = cout);
@@ -85,9 +222,11 @@ public:
         {
             vector<double>& buffer = comm.get_out_data(i);
 
-            for (size_t j = 0; j < boundaries[i].size(); ++j)
+            const vector<Cell*>& cells = boundaries[i].send_cells;
+
+            for (size_t j = 0; j < cells.size(); ++j)
             {
-                buffer[j] = boundaries[i].pairs[j].first->get_element<TData>(index);
+                buffer[j] = cells[j]->get_element<TData>(index);
             }
         }
     }
@@ -112,9 +251,11 @@ public:
         {
             vector<double>& buffer = comm.get_in_data(i);
 
-            for (size_t j = 0; j < boundaries[i].size(); ++j)
+            const vector<Cell*>& cells = boundaries[i].recv_cells;
+
+            for (size_t j = 0; j < cells.size(); ++j)
             {
-                boundaries[i].pairs[j].second->set_element<TData>(index, buffer[j]);
+                cells[j]->set_element<TData>(index, buffer[j]);
             }
         }
     }
@@ -36,6 +36,32 @@ Boundary::~Boundary()
 {
 }
 
+/// \brief Sort pairs by original identifiers of cells.
+///
+/// Pairs are sorted by original identifier of cell in lower domain,
+/// then by original identifier of cell in higher domain,
+/// so both domains get the same order of pairs without handshake.
+void
+Boundary::sort_by_orig_ids()
+{
+    bool is_own_lower { domain < neighbour_domain };
+
+    sort(pairs.begin(), pairs.end(),
+         [is_own_lower](const pair<Cell*, Cell*>& a, const pair<Cell*, Cell*>& b)
+         {
+             pair<int, int> ka { a.first->get_orig_id(), a.second->get_orig_id() };
+             pair<int, int> kb { b.first->get_orig_id(), b.second->get_orig_id() };
+
+             if (!is_own_lower)
+             {
+                 swap(ka.first, ka.second);
+                 swap(kb.first, kb.second);
+             }
+
+             return ka < kb;
+         });
+}
+
 /// \brief Print boundary.
 ///
 /// Print boundary in current process.
@@ -61,6 +87,7 @@ Boundary::print(ostream& os)
         }
 
         os << endl;
+        os << "    send " << send_cells.size() << " cells, recv " << recv_cells.size() << " cells" << endl;
     }
 }
 
@@ -38,6 +38,16 @@ public:
     /// second cell - cell in neighbour domain.
     vector<pair<Cell*, Cell*>> pairs;
 
+    /// \brief Own cells to send to neighbour domain.
+    ///
+    /// Each cell is sent once (for all ghost layers).
+    vector<Cell*> send_cells;
+
+    /// \brief Ghost cells to receive from neighbour domain.
+    ///
+    /// Each cell is received once (for all ghost layers).
+    vector<Cell*> recv_cells;
+
 public:
 
     // Default constructor.
@@ -72,6 +82,22 @@ public:
         pairs.push_back(pair<Cell*, Cell*> { in_cell, neighbour_cell });
     }
 
+    /// \brief Get size of buffer.
+    ///
+    /// Buffer is used both for sending and receiving.
+    ///
+    /// \return
+    /// Size of buffer.
+    inline size_t
+    buffer_size() const
+    {
+        return max(send_cells.size(), recv_cells.size());
+    }
+
+    // Sort pairs by original identifiers of cells.
+    void
+    sort_by_orig_ids();
+
     // Print boundary.
     void
     print(ostream& os = cout);
@@ -148,6 +148,34 @@ Cell::is_domain_border() const
     return false;
 }
 
+/// \brief Check if cells have common node.
+///
+/// Check if cells have at least one common node.
+///
+/// \param[in] c Another cell.
+///
+/// \return
+/// true - if cells have common node,
+/// false - otherwise.
+bool
+Cell::is_adjacent_by_node(const Cell* c) const
+{
+    size_t nc { nodes_count() }, cnc { c->nodes_count() };
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        for (size_t j = 0; j < cnc; ++j)
+        {
+            if (node(i) == c->node(j))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 //
 // Links manipulation.
 //
@@ -161,6 +161,9 @@ public:
     /// \brief Saved area.
     double saved_area { 0.0 };
 
+    /// \brief Work in last remeshing (count of steps in which cell is processed).
+    double work { 0.0 };
+
     //
     // Memory leak control.
     //
@@ -288,7 +291,14 @@ public:
                 break;
 
             case CellElement::CellId:
+                // Identifier from file is original one.
+                set_orig_id(static_cast<int>(v));
+                break;
+
             case CellElement::Domain:
+                domain = static_cast<size_t>(v);
+                break;
+
             case CellElement::DistFromBorder:
             case CellElement::DistFromCenter:
             case CellElement::Area:
@@ -325,6 +335,10 @@ public:
     bool
     is_domain_border() const;
 
+    // Check if cells have common node.
+    bool
+    is_adjacent_by_node(const Cell* c) const;
+
     /// \brief Get zone.
     ///
     /// Get zone.
@@ -404,6 +418,18 @@ public:
         return area_;
     }
 
+    /// \brief Get original area (m^2).
+    ///
+    /// Get original area (m^2).
+    ///
+    /// \return
+    /// Original area (m^2).
+    inline double
+    original_area() const
+    {
+        return original_area_;
+    }
+
     /// \brief Get center vector.
     ///
     /// Get center vector.
@@ -0,0 +1,87 @@
+/// \file
+/// \brief Buffers of batch kernels over cells.
+///
+/// Buffers of batch kernels over cells declaration.
+
+#ifndef CAESAR_MESH_CELLS_BATCH_H
+#define CAESAR_MESH_CELLS_BATCH_H
+
+#include "geom/geom.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Buffers of batch kernels over cells.
+///
+/// Geometry of cells is gathered into arrays of vectors before batch kernels.
+/// Buffers are held by holder of cells and are resized only when count of cells grows,
+/// so kernels which are called on each iteration of remeshing do not allocate memory.
+class CellsBatch
+{
+
+public:
+
+    /// \brief Points of first nodes.
+    geom::VectorsArray p1;
+
+    /// \brief Points of second nodes.
+    geom::VectorsArray p2;
+
+    /// \brief Points of third nodes.
+    geom::VectorsArray p3;
+
+    /// \brief Vectors of first nodes (directions or new points).
+    geom::VectorsArray q1;
+
+    /// \brief Vectors of second nodes (directions or new points).
+    geom::VectorsArray q2;
+
+    /// \brief Vectors of third nodes (directions or new points).
+    geom::VectorsArray q3;
+
+    /// \brief Normals of cells.
+    geom::VectorsArray n;
+
+    /// \brief First results.
+    vector<double> a;
+
+    /// \brief Second results.
+    vector<double> b;
+
+    /// \brief Third results.
+    vector<double> c;
+
+    /// \brief Resize buffers.
+    ///
+    /// Resize all buffers (memory is not reallocated if count is not greater than previous one).
+    ///
+    /// \param[in] cc Count of cells.
+    inline void
+    resize(size_t cc)
+    {
+        p1.resize(cc);
+        p2.resize(cc);
+        p3.resize(cc);
+        q1.resize(cc);
+        q2.resize(cc);
+        q3.resize(cc);
+        n.resize(cc);
+        a.resize(cc);
+        b.resize(cc);
+        c.resize(cc);
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_CELLS_BATCH_H
@@ -6,6 +6,9 @@
 #include "mesh_decomposer.h"
 
 #include <deque>
+#include <algorithm>
+#include <numeric>
+#include <omp.h>
 
 #include "parl/parl.h"
 
@@ -24,9 +27,54 @@ namespace mesh
 utils::Mapper<DecompositionType> MeshDecompositionTypeMapper
 {
     "mesh decomposition type",
-    vector<string> { "NO", "RANDOM", "LINEAR", "FARHAT" }
+    vector<string> { "NO", "RANDOM", "LINEAR", "FARHAT", "MULTILEVEL", "RCB", "HILBERT" }
 };
 
+/// \brief Domain of cell for ordered weighted cells.
+///
+/// Cells are ordered and each domain takes equal part of total weight,
+/// cell belongs to domain in which its middle is.
+///
+/// \param[in] before Weight of cells before cell.
+/// \param[in] w      Weight of cell.
+/// \param[in] total  Total weight.
+/// \param[in] dn     Number of domains.
+///
+/// \return
+/// Domain.
+static size_t
+domain_by_weight(double before,
+                 double w,
+                 double total,
+                 size_t dn)
+{
+    double d { (before + 0.5 * w) * static_cast<double>(dn) / total };
+
+    return min(static_cast<size_t>(max(d, 0.0)), dn - 1);
+}
+
+/// \brief Total weight of cells.
+///
+/// Total weight of cells.
+///
+/// \param[in] weights Weights of cells.
+///
+/// \return
+/// Total weight.
+static double
+total_weight(const vector<double>& weights)
+{
+    double total { 0.0 };
+
+    #pragma omp parallel for reduction(+:total)
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        total += weights[i];
+    }
+
+    return total;
+}
+
 /// \breif Set domain number to cells diapason.
 ///
 /// Set domain number to cells diapason.
@@ -91,14 +139,31 @@ Decomposer::decompose_random(Mesh& mesh,
 /// \brief Linear decomposition.
 ///
 /// Linear decomposition.
+/// If weights are given, each domain takes range of cells with equal weight.
 ///
-/// \param[out] mesh Mesh,
-/// \param[in]  dn   Number of domains.
+/// \param[out] mesh    Mesh,
+/// \param[in]  dn      Number of domains.
+/// \param[in]  weights Weights of cells (empty for equal weights).
 void
 Decomposer::decompose_linear(Mesh& mesh,
-                             size_t dn)
+                             size_t dn,
+                             const vector<double>& weights)
 {
     size_t n = mesh.all.cells_count();
+
+    if (!weights.empty())
+    {
+        double total { total_weight(weights) }, before { 0.0 };
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            mesh.all.cell(i)->domain = domain_by_weight(before, weights[i], total, dn);
+            before += weights[i];
+        }
+
+        return;
+    }
+
     size_t lo = 0, hi = 0;
     size_t cnt = n / dn, r = n % dn;
 
@@ -117,15 +182,20 @@ Decomposer::decompose_linear(Mesh& mesh,
 /// \brief Farhat decomposition.
 ///
 /// Farhat decomposition.
+/// If weights are given, each domain takes cells with equal weight.
 ///
-/// \param[out] mesh Mesh,
-/// \param[in]  dn   Number of domains.
+/// \param[out] mesh    Mesh,
+/// \param[in]  dn      Number of domains.
+/// \param[in]  weights Weights of cells (empty for equal weights).
 void
 Decomposer::decompose_farhat(Mesh& mesh,
-                             size_t dn)
+                             size_t dn,
+                             const vector<double>& weights)
 {
     size_t n { mesh.all.cells_count() };
     size_t cnt { n / dn }, r { n % dn };
+    bool is_weighted { !weights.empty() };
+    double total { is_weighted ? total_weight(weights) : 0.0 }, before { 0.0 };
 
     // Remove all cell marks.
     mesh.mark_cells([](Cell* c) { (void)c; return false; });
@@ -159,14 +229,25 @@ Decomposer::decompose_farhat(Mesh& mesh,
 
         q.pop_front();
         ++walked_cells;
-        c->domain = cur_domain;
-        --cur_cnt;
 
-        // Check domain change.
-        if (cur_cnt == 0)
+        if (is_weighted)
+        {
+            size_t ci { static_cast<size_t>(c->get_id()) };
+
+            c->domain = domain_by_weight(before, weights[ci], total, dn);
+            before += weights[ci];
+        }
+        else
         {
-            ++cur_domain;
-            cur_cnt = (cur_domain < r) ? (cnt + 1) : cnt;
+            c->domain = cur_domain;
+            --cur_cnt;
+
+            // Check domain change.
+            if (cur_cnt == 0)
+            {
+                ++cur_domain;
+                cur_cnt = (cur_domain < r) ? (cnt + 1) : cnt;
+            }
         }
 
         // Check all neighbours.
@@ -190,144 +271,1398 @@ Decomposer::decompose_farhat(Mesh& mesh,
     mesh.mark_cells([](Cell* c) { (void)c; return false; });
 }
 
-/// \brief Post decompose action.
+/// \brief Multilevel decomposition.
 ///
-/// 1. Form boundaries for all other domains.
-/// 2. Init vectors of own cells and ext cells.
+/// Dual graph of cells is partitioned with multilevel partitioner,
+/// so edge cut (and size of boundaries) is small and domains are compact.
 ///
-/// \param[out] mesh Mesh.
+/// \param[out] mesh    Mesh,
+/// \param[in]  dn      Number of domains.
+/// \param[in]  weights Weights of cells (empty for equal weights).
 void
-Decomposer::post_decompose(Mesh& mesh)
+Decomposer::decompose_multilevel(Mesh& mesh,
+                                 size_t dn,
+                                 const vector<double>& weights)
 {
-    size_t s = parl::mpi_size();
-    size_t r = parl::mpi_rank();
-    size_t ec { mesh.all.edges_count() }, cc { mesh.all.cells_count() };
-
-    // Clear old vectors.
-    mesh.own.clear_cells();
+    size_t cc { mesh.all.cells_count() };
+    PartitionGraph g;
+    vector<size_t> parts;
 
-    // Domains cells is matrix.
-    mesh.domains_cells.resize(s);
+    Partitioner::build_dual_graph(mesh.all, g);
+    Partitioner::set_weights(g, weights);
+    Partitioner::multilevel(g, dn, parts);
 
-    // Fill domain cells and own cells.
     for (size_t i = 0; i < cc; ++i)
     {
-        Cell* c { mesh.all.cell(i) };
-        size_t d = c->get_domain();
+        mesh.all.cell(i)->domain = parts[i];
+    }
+}
 
-        if (d == r)
+/// \brief Minimum count of cells for separate task in recursive coordinate bisection.
+static const size_t rcb_min_task_size { 4096 };
+
+/// \brief Bits count for each coordinate in Hilbert curve key.
+static const int hilbert_bits { 21 };
+
+/// \brief Recursive coordinate bisection of range of cells.
+///
+/// Range of cells is split by median of centers along the longest axis of its box,
+/// domains count of each half is proportional to its cells count.
+/// Halves are processed in separate tasks.
+///
+/// \param[out]    mesh         Mesh.
+/// \param[in]     centers      Centers of cells.
+/// \param[in,out] order        Order of cells.
+/// \param[in]     first        First position of range in order.
+/// \param[in]     count        Count of cells in range.
+/// \param[in]     first_domain First domain number for range.
+/// \param[in]     dn           Count of domains for range.
+/// \param[in]     weights      Weights of cells (empty for equal weights).
+void
+Decomposer::rcb(Mesh& mesh,
+                const vector<geom::Vector>& centers,
+                vector<size_t>& order,
+                size_t first,
+                size_t count,
+                size_t first_domain,
+                size_t dn,
+                const vector<double>& weights)
+{
+    if (dn == 1)
+    {
+        for (size_t i = first; i < first + count; ++i)
         {
-            mesh.own.add_cell(c);
+            mesh.all.cell(order[i])->domain = first_domain;
         }
 
-        mesh.domains_cells[d].push_back(c);
+        return;
     }
 
-    // Fill own edges list.
-    for (size_t i = 0; i < ec; ++i)
+    geom::Box box;
+
+    for (size_t i = first; i < first + count; ++i)
     {
-        Edge* e { mesh.all.edge(i) };
-        bool is_own { false };
+        box.extend(centers[order[i]]);
+    }
 
-        if ((e->cells_count() > 0) && (e->domain_0() == r))
+    int axis { box.longest_axis() };
+    size_t dn1 { dn / 2 };
+    size_t mid { first + count * dn1 / dn };
+
+    // Ties are broken with cell numbers, so result does not depend on threads.
+    auto less_on_axis = [&centers, axis](size_t a, size_t b)
+    {
+        double va { geom::Box::axis_value(centers[a], axis) };
+        double vb { geom::Box::axis_value(centers[b], axis) };
+
+        return (va < vb) || (!(va > vb) && (a < b));
+    };
+
+    if (weights.empty())
+    {
+        nth_element(order.begin() + static_cast<ptrdiff_t>(first),
+                    order.begin() + static_cast<ptrdiff_t>(mid),
+                    order.begin() + static_cast<ptrdiff_t>(first + count),
+                    less_on_axis);
+    }
+    else
+    {
+        // Range is sorted and split so that weight of first part is dn1 / dn of range weight.
+        sort(order.begin() + static_cast<ptrdiff_t>(first),
+             order.begin() + static_cast<ptrdiff_t>(first + count),
+             less_on_axis);
+
+        double total { 0.0 }, before { 0.0 };
+
+        for (size_t i = first; i < first + count; ++i)
         {
-            is_own = true;
+            total += weights[order[i]];
         }
 
-        if ((e->cells_count() > 1) && (e->domain_1() == r))
+        double target { total * static_cast<double>(dn1) / static_cast<double>(dn) };
+
+        mid = first;
+
+        while ((mid < first + count) && (before + 0.5 * weights[order[mid]] < target))
         {
-            is_own = true;
+            before += weights[order[mid]];
+            ++mid;
         }
 
-        if (is_own)
+        // Both parts are not empty if it is possible.
+        if (count > 1)
         {
-            mesh.own.add_edge(e);
+            mid = min(max(mid, first + 1), first + count - 1);
         }
     }
 
-    // Allocate boundaries.
-    mesh.boundaries.allocate();
+    if (count >= rcb_min_task_size)
+    {
+        #pragma omp task
+        rcb(mesh, centers, order, first, mid - first, first_domain, dn1, weights);
 
-    // Process boundary cells.
-    for (size_t i = 0; i < ec; ++i)
+        rcb(mesh, centers, order, mid, first + count - mid, first_domain + dn1, dn - dn1, weights);
+
+        #pragma omp taskwait
+    }
+    else
     {
-        Edge* e { mesh.all.edge(i) };
+        rcb(mesh, centers, order, first, mid - first, first_domain, dn1, weights);
+        rcb(mesh, centers, order, mid, first + count - mid, first_domain + dn1, dn - dn1, weights);
+    }
+}
 
-        if (e->is_cross())
-        {
-            size_t d0 = e->domain_0(), d1 = e->domain_1();
+/// \brief Recursive coordinate bisection decomposition.
+///
+/// Cells are split into domains with recursive coordinate bisection of their centers.
+/// It is much cheaper than graph partitioning and gives compact domains.
+/// If weights are given, halves are split by weight instead of cells count.
+///
+/// \param[out] mesh    Mesh,
+/// \param[in]  dn      Number of domains.
+/// \param[in]  weights Weights of cells (empty for equal weights).
+void
+Decomposer::decompose_rcb(Mesh& mesh,
+                          size_t dn,
+                          const vector<double>& weights)
+{
+    size_t cc { mesh.all.cells_count() };
+    vector<geom::Vector> centers(cc);
+    vector<size_t> order(cc);
 
-            if (d0 == r)
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        centers[i].set(mesh.all.cell(i)->center());
+        order[i] = i;
+    }
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        rcb(mesh, centers, order, 0, cc, 0, dn, weights);
+    }
+}
+
+/// \brief Hilbert curve key.
+///
+/// Position of point on 3D Hilbert curve.
+/// Coordinates are transformed to transposed Hilbert index,
+/// then its bits are interleaved.
+///
+/// source:
+/// Skilling J.
+/// Programming the Hilbert curve.
+///
+/// \param[in] x Integer coordinates (hilbert_bits bits each).
+///
+/// \return
+/// Key.
+static uint64_t
+hilbert_key(uint32_t x[3])
+{
+    const uint32_t m { 1U << (hilbert_bits - 1) };
+
+    // Inverse undo.
+    for (uint32_t q = m; q > 1; q >>= 1)
+    {
+        uint32_t p { q - 1 };
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            if (x[i] & q)
             {
-                // d1 - neighbour domain, c1 - ghost cell.
-                mesh.boundaries.add(d1, e->cell(0), e->cell(1));
+                x[0] ^= p;
             }
-            else if (d1 == r)
+            else
             {
-                // d0 - neighbour domain, c0 - ghost cell.
-                mesh.boundaries.add(d0, e->cell(1), e->cell(0));
+                uint32_t t { (x[0] ^ x[i]) & p };
+
+                x[0] ^= t;
+                x[i] ^= t;
             }
         }
     }
 
-    // Transfer sizes.
-    mesh.boundaries.set_buffers_sizes();
+    // Gray encode.
+    x[1] ^= x[0];
+    x[2] ^= x[1];
 
-    // Allocate gatherer for gather data in process 0.
-    mesh.gatherer.allocate();
+    uint32_t t { 0 };
 
-    // Allocate size for all gather buffers.
-    for (size_t i = 1; i < s; ++i)
+    for (uint32_t q = m; q > 1; q >>= 1)
     {
-        mesh.gatherer.set_size(i, mesh.domains_cells[i].size());
+        if (x[2] & q)
+        {
+            t ^= q - 1;
+        }
     }
 
-    // Init local identifiers.
-    mesh.init_local_identifiers();
+    for (size_t i = 0; i < 3; ++i)
+    {
+        x[i] ^= t;
+    }
+
+    // Interleave bits.
+    uint64_t key { 0 };
+
+    for (int b = hilbert_bits - 1; b >= 0; --b)
+    {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            key = (key << 1) | static_cast<uint64_t>((x[i] >> b) & 1U);
+        }
+    }
+
+    return key;
 }
 
-/// \brief Decompose mesh.
+/// \brief Parallel sort of keys.
 ///
-/// Decompose mesh.
+/// Chunks are sorted in parallel, then they are merged in pairs in parallel.
 ///
-/// \param[out] mesh Mesh.
-/// \param[in]  type Decomposition type.
-/// \param[in]  dn   Number of domains.
+/// \param[in,out] keys Keys with cells numbers.
+static void
+parallel_sort(vector<pair<uint64_t, size_t>>& keys)
+{
+    size_t n { keys.size() };
+    size_t chunks { static_cast<size_t>(max(omp_get_max_threads(), 1)) };
+    size_t chunk { (n + chunks - 1) / chunks };
+
+    if ((chunks == 1) || (chunk == 0))
+    {
+        sort(keys.begin(), keys.end());
+
+        return;
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < chunks; ++i)
+    {
+        size_t lo { min(i * chunk, n) }, hi { min(lo + chunk, n) };
+
+        sort(keys.begin() + static_cast<ptrdiff_t>(lo), keys.begin() + static_cast<ptrdiff_t>(hi));
+    }
+
+    for (size_t w = chunk; w < n; w *= 2)
+    {
+        size_t pairs { (n + 2 * w - 1) / (2 * w) };
+
+        #pragma omp parallel for
+        for (size_t i = 0; i < pairs; ++i)
+        {
+            size_t lo { i * 2 * w }, mid { min(lo + w, n) }, hi { min(lo + 2 * w, n) };
+
+            inplace_merge(keys.begin() + static_cast<ptrdiff_t>(lo),
+                          keys.begin() + static_cast<ptrdiff_t>(mid),
+                          keys.begin() + static_cast<ptrdiff_t>(hi));
+        }
+    }
+}
+
+/// \brief Hilbert curve decomposition.
+///
+/// Cells are ordered along Hilbert curve through their centers,
+/// then the order is split into ranges of equal size.
+/// It is much cheaper than graph partitioning, domains are compact
+/// and neighbour cells are close to each other in the order.
+/// If weights are given, ranges have equal weight instead of equal size.
+///
+/// \param[out] mesh    Mesh,
+/// \param[in]  dn      Number of domains.
+/// \param[in]  weights Weights of cells (empty for equal weights).
 void
-Decomposer::decompose(Mesh& mesh,
-                      DecompositionType type,
-                      size_t dn)
+Decomposer::decompose_hilbert(Mesh& mesh,
+                              size_t dn,
+                              const vector<double>& weights)
 {
-    switch (type)
+    size_t cc { mesh.all.cells_count() };
+    geom::Box box;
+
+    #pragma omp parallel
     {
-        case DecompositionType::No:
-            DEBUG_CHECK_ERROR(dn == 1,
-                              "it is needed to perform decomposition for domains count "
-                              + to_string(dn));
-            decompose_no(mesh);
-            break;
+        geom::Box local_box;
 
-        case DecompositionType::Random:
-            decompose_random(mesh, dn);
-            break;
+        #pragma omp for
+        for (size_t i = 0; i < cc; ++i)
+        {
+            local_box.extend(mesh.all.cell(i)->center());
+        }
 
-        case DecompositionType::Linear:
-            decompose_linear(mesh, dn);
-            break;
+        #pragma omp critical
+        box.extend(local_box);
+    }
 
-        case DecompositionType::Farhat:
-            decompose_farhat(mesh, dn);
-            break;
+    // The same scale for all axes.
+    double side { max(max(box.hi.x - box.lo.x, box.hi.y - box.lo.y), box.hi.z - box.lo.z) };
+    double scale { (side > 0.0) ? (static_cast<double>((1U << hilbert_bits) - 1) / side) : 0.0 };
+    vector<pair<uint64_t, size_t>> keys(cc);
 
-        default:
-            DEBUG_ERROR("unexpected mesh decomposition type");
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        const geom::Vector& c { mesh.all.cell(i)->center() };
+        uint32_t x[3] { static_cast<uint32_t>((c.x - box.lo.x) * scale),
+                        static_cast<uint32_t>((c.y - box.lo.y) * scale),
+                        static_cast<uint32_t>((c.z - box.lo.z) * scale) };
+
+        keys[i] = make_pair(hilbert_key(x), i);
     }
 
-    // Post decompose (only if processes count is equal to domains count).
-    if (parl::mpi_size() == dn)
+    parallel_sort(keys);
+
+    if (!weights.empty())
     {
-        post_decompose(mesh);
+        double total { total_weight(weights) }, before { 0.0 };
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            size_t ci { keys[i].second };
+
+            mesh.all.cell(ci)->domain = domain_by_weight(before, weights[ci], total, dn);
+            before += weights[ci];
+        }
+
+        return;
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        mesh.all.cell(keys[i].second)->domain = i * dn / cc;
+    }
+}
+
+/// \brief Refine decomposition.
+///
+/// Boundary cells are moved between domains with Fiduccia-Mattheyses refinement
+/// of cells dual graph, so count of cross edges and count of neighbour domains decrease.
+/// Domains do not become heavier than 3% over average.
+///
+/// \param[out] mesh    Mesh.
+/// \param[in]  dn      Number of domains.
+/// \param[in]  weights Weights of cells (empty for equal weights).
+void
+Decomposer::refine(Mesh& mesh,
+                   size_t dn,
+                   const vector<double>& weights)
+{
+    size_t cc { mesh.all.cells_count() };
+    PartitionGraph g;
+    vector<size_t> parts(cc);
+
+    Partitioner::build_dual_graph(mesh.all, g);
+    Partitioner::set_weights(g, weights);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        parts[i] = mesh.all.cell(i)->domain;
+    }
+
+    Partitioner::refine_fm(g, dn, 1.03, parts);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        mesh.all.cell(i)->domain = parts[i];
+    }
+}
+
+/// \brief Cells of domain file.
+///
+/// Own cells of domain and layers of cells adjacent by nodes.
+/// Cells are ordered by identifiers.
+///
+/// \param[in]  mesh         Mesh.
+/// \param[in]  d            Domain.
+/// \param[in]  ghost_layers Count of ghost layers.
+/// \param[out] cells        Cells.
+void
+Decomposer::domain_file_cells(Mesh& mesh,
+                              size_t d,
+                              size_t ghost_layers,
+                              vector<Cell*>& cells)
+{
+    size_t cc { mesh.all.cells_count() };
+    vector<bool> is_taken(cc, false);
+
+    cells.clear();
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        if (c->get_domain() == d)
+        {
+            is_taken[i] = true;
+            cells.push_back(c);
+        }
+    }
+
+    // Layers of ghost cells.
+    size_t beg { 0 };
+
+    for (size_t li = 0; li < ghost_layers; ++li)
+    {
+        size_t end { cells.size() };
+
+        for (size_t i = beg; i < end; ++i)
+        {
+            Cell* c { cells[i] };
+
+            for (size_t j = 0; j < c->nodes_count(); ++j)
+            {
+                Node* n { c->node(j) };
+
+                for (size_t k = 0; k < n->cells_count(); ++k)
+                {
+                    Cell* ngh { n->cell(k) };
+                    size_t ni { static_cast<size_t>(ngh->get_id()) };
+
+                    if (!is_taken[ni])
+                    {
+                        is_taken[ni] = true;
+                        cells.push_back(ngh);
+                    }
+                }
+            }
+        }
+
+        beg = end;
     }
+
+    sort(cells.begin(), cells.end(),
+         [](const Cell* a, const Cell* b)
+         {
+             return a->get_id() < b->get_id();
+         });
+}
+
+/// \brief Variables of domain file.
+///
+/// Variables of mesh with added NodeId, CellId and Domain (if they are not there).
+///
+/// \param[in]  mesh                     Mesh.
+/// \param[out] variables_names          Names of variables.
+/// \param[out] varlocation_cellcentered Position of cellcentered data.
+void
+Decomposer::domain_file_variables(const Mesh& mesh,
+                                  vector<string>& variables_names,
+                                  pair<size_t, size_t>& varlocation_cellcentered)
+{
+    const vector<string>& vs { mesh.variables_names };
+    size_t nv { (mesh.varlocation_cellcentered.first > 0)
+                ? (mesh.varlocation_cellcentered.first - 1)
+                : vs.size() };
+    vector<string> nodes_names(vs.begin(), vs.begin() + static_cast<ptrdiff_t>(nv));
+    vector<string> cells_names(vs.begin() + static_cast<ptrdiff_t>(nv), vs.end());
+
+    if (find(nodes_names.begin(), nodes_names.end(), "NodeId") == nodes_names.end())
+    {
+        nodes_names.push_back("NodeId");
+    }
+
+    for (const char* name : { "CellId", "Domain" })
+    {
+        if (find(cells_names.begin(), cells_names.end(), name) == cells_names.end())
+        {
+            cells_names.push_back(name);
+        }
+    }
+
+    variables_names = nodes_names;
+    variables_names.insert(variables_names.end(), cells_names.begin(), cells_names.end());
+    varlocation_cellcentered = make_pair(nodes_names.size() + 1, variables_names.size());
+}
+
+/// \brief Init mesh part loaded from domain file.
+///
+/// Nodes and cells are ordered by original identifiers,
+/// so all processes hold common objects in the same order
+/// (as for replicated mesh).
+///
+/// \param[in,out] mesh Mesh.
+void
+Decomposer::init_domain_part(Mesh& mesh)
+{
+    sort(mesh.all.nodes().begin(), mesh.all.nodes().end(), utils::IdsHolder::is_less_by_orig_id);
+    sort(mesh.all.cells().begin(), mesh.all.cells().end(), utils::IdsHolder::is_less_by_orig_id);
+    mesh.init_global_identifiers();
+    mesh.is_domain_part_ = true;
+}
+
+/// \brief Renumber mesh elements by blocks.
+///
+/// Cells of each domain are split into blocks with multilevel partitioner,
+/// then cells are ordered by domains and blocks, so each block is contiguous.
+/// Nodes and edges are ordered by first cells which hold them.
+/// Blocks of all domains are built for replicated mesh (all processes get the same numbering),
+/// only blocks of own domain are built for mesh part.
+/// Ranges of blocks cells and nodes are stored in mesh.
+/// Elements can not be renumbered while ensembles hold data indexed with their identifiers.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in]     bn   Count of blocks in domain.
+void
+Decomposer::renumber_blocks(Mesh& mesh,
+                            size_t bn)
+{
+    CHECK_ERROR(mesh.ensembles_count_ == 0,
+                "mesh elements can not be renumbered while ensemble holds data indexed with them");
+
+    size_t r = parl::mpi_rank();
+    size_t nc { mesh.all.nodes_count() }, ec { mesh.all.edges_count() }, cc { mesh.all.cells_count() };
+    size_t dn { 0 };
+    PartitionGraph g;
+
+    Partitioner::build_dual_graph(mesh.all, g);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        dn = max(dn, mesh.all.cell(i)->get_domain() + 1);
+    }
+
+    // Cells of domains.
+    vector<vector<size_t>> domains_cells(dn);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        domains_cells[mesh.all.cell(i)->get_domain()].push_back(i);
+    }
+
+    // Blocks inside domains.
+    vector<size_t> blocks(cc, 0), loc(cc);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t d = 0; d < dn; ++d)
+    {
+        if (mesh.is_domain_part() && (d != r))
+        {
+            continue;
+        }
+
+        const vector<size_t>& dcs { domains_cells[d] };
+        PartitionGraph dg;
+        vector<size_t> parts;
+
+        for (size_t k = 0; k < dcs.size(); ++k)
+        {
+            loc[dcs[k]] = k;
+        }
+
+        // Graph of domain cells.
+        dg.weights.assign(dcs.size(), 1);
+
+        for (size_t i : dcs)
+        {
+            for (size_t j = g.offsets[i]; j < g.offsets[i + 1]; ++j)
+            {
+                size_t v { g.adj[j] };
+
+                if (mesh.all.cell(v)->get_domain() == d)
+                {
+                    dg.adj.push_back(loc[v]);
+                    dg.adj_weights.push_back(g.adj_weights[j]);
+                }
+            }
+
+            dg.offsets.push_back(dg.adj.size());
+        }
+
+        Partitioner::multilevel(dg, bn, parts, 1.01);
+
+        for (size_t k = 0; k < dcs.size(); ++k)
+        {
+            blocks[dcs[k]] = parts[k];
+        }
+    }
+
+    // New order of cells.
+    vector<size_t> order(cc);
+
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(),
+                [&mesh, &blocks](size_t a, size_t b)
+                {
+                    size_t da { mesh.all.cell(a)->get_domain() }, db { mesh.all.cell(b)->get_domain() };
+
+                    return (da < db) || ((da == db) && (blocks[a] < blocks[b]));
+                });
+
+    vector<Cell*> cells(cc);
+    vector<Node*> nodes;
+    vector<Edge*> edges;
+    vector<bool> is_node_taken(nc, false), is_edge_taken(ec, false);
+
+    for (size_t k = 0; k < cc; ++k)
+    {
+        cells[k] = mesh.all.cell(order[k]);
+    }
+
+    // Blocks which are split (all blocks for replicated mesh, own blocks for mesh part).
+    auto is_split = [&mesh, r](size_t d)
+    {
+        return !mesh.is_domain_part() || (d == r);
+    };
+
+    mesh.blocks_cells_offsets_.assign(dn, vector<size_t>());
+    mesh.blocks_nodes_offsets_.assign(dn, vector<size_t>());
+
+    // Nodes and edges in order of first cells.
+    for (size_t k = 0; k < cc; ++k)
+    {
+        Cell* c { cells[k] };
+        size_t d { c->get_domain() };
+
+        // Begin of block (end of previous one).
+        if (is_split(d))
+        {
+            vector<size_t>& cs_offs { mesh.blocks_cells_offsets_[d] };
+            vector<size_t>& ns_offs { mesh.blocks_nodes_offsets_[d] };
+
+            while (cs_offs.size() <= blocks[order[k]])
+            {
+                cs_offs.push_back(k);
+                ns_offs.push_back(nodes.size());
+            }
+        }
+
+        for (size_t j = 0; j < c->nodes_count(); ++j)
+        {
+            size_t ni { static_cast<size_t>(c->node(j)->get_id()) };
+
+            if (!is_node_taken[ni])
+            {
+                is_node_taken[ni] = true;
+                nodes.push_back(c->node(j));
+            }
+        }
+
+        for (size_t j = 0; j < c->edges_count(); ++j)
+        {
+            size_t ei { static_cast<size_t>(c->edge(j)->get_id()) };
+
+            if (!is_edge_taken[ei])
+            {
+                is_edge_taken[ei] = true;
+                edges.push_back(c->edge(j));
+            }
+        }
+
+        // End of domain (empty blocks in the end).
+        if (is_split(d) && ((k + 1 == cc) || (cells[k + 1]->get_domain() != d)))
+        {
+            vector<size_t>& cs_offs { mesh.blocks_cells_offsets_[d] };
+            vector<size_t>& ns_offs { mesh.blocks_nodes_offsets_[d] };
+
+            while (cs_offs.size() <= bn)
+            {
+                cs_offs.push_back(k + 1);
+                ns_offs.push_back(nodes.size());
+            }
+        }
+    }
+
+    // Nodes and edges without cells.
+    for (size_t i = 0; i < nc; ++i)
+    {
+        if (!is_node_taken[i])
+        {
+            nodes.push_back(mesh.all.node(i));
+        }
+    }
+
+    for (size_t i = 0; i < ec; ++i)
+    {
+        if (!is_edge_taken[i])
+        {
+            edges.push_back(mesh.all.edge(i));
+        }
+    }
+
+    mesh.all.nodes() = nodes;
+    mesh.all.edges() = edges;
+    mesh.all.cells() = cells;
+    mesh.init_global_identifiers();
+
+    // Patches are built for old order.
+    mesh.patches.clear();
+}
+
+/// \brief Post decompose action.
+///
+/// 1. Form boundaries for all other domains.
+/// 2. Init vectors of own cells and ext cells.
+/// 3. Build halo of own domain.
+///
+/// \param[out] mesh Mesh.
+void
+Decomposer::post_decompose(Mesh& mesh)
+{
+    size_t s = parl::mpi_size();
+    size_t r = parl::mpi_rank();
+    size_t ec { mesh.all.edges_count() }, cc { mesh.all.cells_count() };
+
+    // Domains are changed, so blocks are built again.
+    if (mesh.blocks_count() > 0)
+    {
+        renumber_blocks(mesh, mesh.blocks_count());
+    }
+
+    // Clear old vectors (post decompose may be repeated after rebalancing).
+    mesh.own.clear_cells();
+    mesh.own.clear_edges();
+    mesh.clear_own_edges_colors();
+
+    // Domains cells is matrix.
+    mesh.domains_cells.assign(s, vector<Cell*>());
+
+    // Fill domain cells and own cells.
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+        size_t d = c->get_domain();
+
+        if (d == r)
+        {
+            mesh.own.add_cell(c);
+        }
+
+        // Mesh part holds only several layers of other domains cells.
+        if (!mesh.is_domain_part() || (d == r))
+        {
+            mesh.domains_cells[d].push_back(c);
+        }
+    }
+
+    // Fill own edges list.
+    for (size_t i = 0; i < ec; ++i)
+    {
+        Edge* e { mesh.all.edge(i) };
+        bool is_own { false };
+
+        if ((e->cells_count() > 0) && (e->domain_0() == r))
+        {
+            is_own = true;
+        }
+
+        if ((e->cells_count() > 1) && (e->domain_1() == r))
+        {
+            is_own = true;
+        }
+
+        if (is_own)
+        {
+            mesh.own.add_edge(e);
+        }
+    }
+
+    // Allocate boundaries.
+    mesh.boundaries.clear();
+    mesh.boundaries.allocate();
+
+    // Process boundary cells.
+    for (size_t i = 0; i < ec; ++i)
+    {
+        Edge* e { mesh.all.edge(i) };
+
+        if (e->is_cross())
+        {
+            size_t d0 = e->domain_0(), d1 = e->domain_1();
+
+            if (d0 == r)
+            {
+                // d1 - neighbour domain, c1 - ghost cell.
+                mesh.boundaries.add(d1, e->cell(0), e->cell(1));
+            }
+            else if (d1 == r)
+            {
+                // d0 - neighbour domain, c0 - ghost cell.
+                mesh.boundaries.add(d0, e->cell(1), e->cell(0));
+            }
+        }
+    }
+
+    // Order of cells in mesh part differs from other processes,
+    // so boundaries are ordered by original identifiers.
+    if (mesh.is_domain_part())
+    {
+        mesh.boundaries.sort_by_orig_ids();
+    }
+
+    // Ghost layers.
+    mesh.boundaries.build_ghosts(mesh.all);
+
+    // Allocate gatherer for gather data in process 0
+    // (not possible for mesh part).
+    mesh.gatherer.clear();
+
+    if (!mesh.is_domain_part())
+    {
+        mesh.gatherer.allocate();
+
+        // Allocate size for all gather buffers.
+        for (size_t i = 1; i < s; ++i)
+        {
+            mesh.gatherer.set_size(i, mesh.domains_cells[i].size());
+        }
+    }
+
+    // Halo for distributed processing.
+    mesh.halo.build(mesh.all, r, s);
+
+    // Init local identifiers.
+    mesh.init_local_identifiers();
+}
+
+/// \brief Split cells of domains into blocks for threads.
+///
+/// Cells of each domain are split into blocks (one block for each thread)
+/// and mesh elements are renumbered so each block is contiguous.
+/// Ranges of blocks are stored in mesh, loops over cells and nodes by blocks
+/// give to each thread its own block, so threads work with compact parts of domain
+/// (better cache reuse, less false sharing).
+/// Blocks are built again after each decomposition or rebalancing.
+/// Data which is indexed with identifiers of mesh elements must be stored after splitting,
+/// blocks can not be built while ensembles over mesh exist.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in]     bn   Count of blocks in domain (0 - count of threads).
+void
+Decomposer::build_blocks(Mesh& mesh,
+                         size_t bn)
+{
+    CHECK_ERROR(mesh.ensembles_count_ == 0,
+                "mesh elements can not be renumbered while ensemble holds data indexed with them");
+
+    mesh.blocks_count_ = (bn > 0) ? bn : static_cast<size_t>(max(omp_get_max_threads(), 1));
+
+    if (mesh.boundaries.is_allocated())
+    {
+        post_decompose(mesh);
+    }
+    else
+    {
+        renumber_blocks(mesh, mesh.blocks_count_);
+    }
+}
+
+/// \brief Name of domain file.
+///
+/// Name of domain file.
+///
+/// \param[in] prefix Prefix of files names.
+/// \param[in] d      Domain.
+///
+/// \return
+/// Name of file.
+string
+Decomposer::domain_file_name(const string& prefix,
+                             size_t d)
+{
+    return prefix + "_" + to_string(d) + ".dat";
+}
+
+/// \brief Decompose mesh.
+///
+/// Decompose mesh.
+/// Initial decomposition is refined before post decompose action (if it is needed).
+///
+/// \param[out] mesh      Mesh.
+/// \param[in]  type      Decomposition type.
+/// \param[in]  dn        Number of domains.
+/// \param[in]  is_refine Refine decomposition.
+void
+Decomposer::decompose(Mesh& mesh,
+                      DecompositionType type,
+                      size_t dn,
+                      bool is_refine)
+{
+    decompose(mesh, type, dn, vector<double>(), is_refine);
+}
+
+/// \brief Decompose mesh with weights of cells.
+///
+/// Decompose mesh so that domains have equal total weight of cells.
+/// Weights are used by all decomposition types except random one.
+/// Empty weights mean equal weights of cells.
+/// Whole mesh is needed, so mesh part loaded from domain file can not be decomposed.
+///
+/// \param[out] mesh      Mesh.
+/// \param[in]  type      Decomposition type.
+/// \param[in]  dn        Number of domains.
+/// \param[in]  weights   Weights of cells.
+/// \param[in]  is_refine Refine decomposition.
+void
+Decomposer::decompose(Mesh& mesh,
+                      DecompositionType type,
+                      size_t dn,
+                      const vector<double>& weights,
+                      bool is_refine)
+{
+    CHECK_ERROR(!mesh.is_domain_part(), "mesh part loaded from domain file can not be decomposed");
+    DEBUG_CHECK_ERROR(weights.empty() || (weights.size() == mesh.all.cells_count()),
+                      "wrong count of cells weights");
+
+    switch (type)
+    {
+        case DecompositionType::No:
+            DEBUG_CHECK_ERROR(dn == 1,
+                              "it is needed to perform decomposition for domains count "
+                              + to_string(dn));
+            decompose_no(mesh);
+            break;
+
+        case DecompositionType::Random:
+            decompose_random(mesh, dn);
+            break;
+
+        case DecompositionType::Linear:
+            decompose_linear(mesh, dn, weights);
+            break;
+
+        case DecompositionType::Farhat:
+            decompose_farhat(mesh, dn, weights);
+            break;
+
+        case DecompositionType::Multilevel:
+            decompose_multilevel(mesh, dn, weights);
+            break;
+
+        case DecompositionType::RCB:
+            decompose_rcb(mesh, dn, weights);
+            break;
+
+        case DecompositionType::Hilbert:
+            decompose_hilbert(mesh, dn, weights);
+            break;
+
+        default:
+            DEBUG_ERROR("unexpected mesh decomposition type");
+    }
+
+    // Multilevel decomposition is already refined.
+    if (is_refine && (dn > 1) && (type != DecompositionType::Multilevel))
+    {
+        refine(mesh, dn, weights);
+    }
+
+    // Post decompose (only if processes count is equal to domains count).
+    if (parl::mpi_size() == dn)
+    {
+        post_decompose(mesh);
+    }
+}
+
+/// \brief New domains for rebalancing.
+///
+/// Imbalance is ratio of maximum time of processes to average one.
+/// If it is not less than threshold, time of each process is distributed between
+/// its cells proportionally to their estimated weights, so cost of each cell is known,
+/// and partition is rebalanced with diffusion (new domains are close to old ones).
+/// Result is the same in all processes.
+/// Mesh must be replicated (mesh part loaded from domain file can not be rebalanced).
+///
+/// \param[out] mesh        Mesh.
+/// \param[in]  time        Time of current process.
+/// \param[in]  threshold   Imbalance which triggers rebalancing.
+/// \param[out] old_domains Old domains of cells.
+/// \param[out] r           Report.
+///
+/// \return
+/// true - if domains are changed,
+/// false - otherwise.
+bool
+Decomposer::rebalance_domains(Mesh& mesh,
+                              double time,
+                              double threshold,
+                              vector<size_t>& old_domains,
+                              RebalanceReport& r)
+{
+    CHECK_ERROR(!mesh.is_domain_part(), "mesh part loaded from domain file can not be rebalanced");
+
+    size_t s { parl::mpi_size() }, cc { mesh.all.cells_count() };
+    vector<double> times(s, 0.0);
+
+    times[parl::mpi_rank()] = time;
+    parl::mpi_allreduce_sum(times);
+
+    double avg { accumulate(times.begin(), times.end(), 0.0) / static_cast<double>(s) };
+
+    r.is_rebalanced = false;
+    r.time_imbalance = (avg > 0.0) ? (*max_element(times.begin(), times.end()) / avg) : 1.0;
+    r.predicted_imbalance = r.time_imbalance;
+    r.moved_cells = 0;
+
+    if ((s == 1) || (r.time_imbalance < threshold))
+    {
+        return false;
+    }
+
+    DEBUG_CHECK_ERROR(mesh.halo.is_built(), "mesh must be decomposed before rebalancing");
+
+    // Costs of cells.
+    vector<double> weights, dw(s, 0.0);
+
+    estimate_weights(mesh, weights);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        dw[mesh.all.cell(i)->get_domain()] += weights[i];
+    }
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        size_t d { mesh.all.cell(i)->get_domain() };
+
+        weights[i] *= times[d] / dw[d];
+    }
+
+    // Rebalance partition.
+    PartitionGraph g;
+    vector<size_t> parts(cc);
+
+    Partitioner::build_dual_graph(mesh.all, g);
+    Partitioner::set_weights(g, weights);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        parts[i] = mesh.all.cell(i)->get_domain();
+    }
+
+    old_domains = parts;
+    Partitioner::rebalance(g, s, 1.03, parts);
+
+    vector<double> pt(s, 0.0);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        pt[parts[i]] += weights[i];
+
+        if (parts[i] != old_domains[i])
+        {
+            mesh.all.cell(i)->domain = parts[i];
+            ++r.moved_cells;
+        }
+    }
+
+    r.predicted_imbalance = *max_element(pt.begin(), pt.end()) / avg;
+    r.is_rebalanced = (r.moved_cells > 0);
+
+    return r.is_rebalanced;
+}
+
+/// \brief Finish rebalancing report.
+///
+/// Counts of sent objects and bytes are summed over processes,
+/// time is maximum over processes.
+///
+/// \param[in]  migrator    Migrator.
+/// \param[in]  cells_width Count of values of one cell.
+/// \param[in]  nodes_width Count of values of one node.
+/// \param[in]  time        Time of rebalancing in current process.
+/// \param[out] r           Report.
+void
+Decomposer::rebalance_report(const Migrator& migrator,
+                             size_t cells_width,
+                             size_t nodes_width,
+                             double time,
+                             RebalanceReport& r)
+{
+    vector<double> sums { 0.0, 0.0 }, times { time };
+
+    if (r.is_rebalanced)
+    {
+        sums[0] = static_cast<double>(migrator.send_cells_count());
+        sums[1] = static_cast<double>(migrator.send_nodes_count());
+    }
+
+    parl::mpi_allreduce_sum(sums);
+    parl::mpi_allreduce_max(times);
+
+    r.sent_cells = static_cast<size_t>(sums[0]);
+    r.sent_nodes = static_cast<size_t>(sums[1]);
+    r.sent_bytes = (r.sent_cells * cells_width + r.sent_nodes * nodes_width) * sizeof(double);
+    r.time = times[0];
+}
+
+/// \brief Estimate weights of cells.
+///
+/// Weight of cell is estimated from its work in last remeshing
+/// (count of steps in which cell is processed): 1 + work_fact * work.
+/// If mesh is processed distributed, each process knows actual work only for
+/// cells of own domain, so weights are gathered with reduction
+/// and all processes get the same weights.
+/// Mesh must be replicated (not part loaded from domain file).
+///
+/// \param[in]  mesh      Mesh.
+/// \param[out] weights   Weights of cells.
+/// \param[in]  work_fact Factor of work in weight.
+void
+Decomposer::estimate_weights(Mesh& mesh,
+                             vector<double>& weights,
+                             double work_fact)
+{
+    CHECK_ERROR(!mesh.is_domain_part(), "weights can not be estimated for mesh part loaded from domain file");
+
+    size_t cc { mesh.all.cells_count() }, r { parl::mpi_rank() };
+    bool is_dist { (parl::mpi_size() > 1) && mesh.halo.is_built() };
+
+    weights.assign(cc, 0.0);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        if (!is_dist || (c->get_domain() == r))
+        {
+            weights[i] = 1.0 + work_fact * c->work;
+        }
+    }
+
+    if (is_dist)
+    {
+        parl::mpi_allreduce_sum(weights);
+    }
+}
+
+/// \brief Decomposition report.
+///
+/// Metrics are calculated from domains of all cells in one parallel pass over cells
+/// and one parallel pass over edges.
+/// Mesh must be replicated (not part loaded from domain file).
+/// If boundaries are built, pairs of current domain are taken from them.
+/// Ghost layers are taken with depth and adjacency of boundaries.
+/// Buffer of exchange with neighbour holds one value of type double for each cell
+/// and its size is maximum of counts of sent and received cells.
+///
+/// \param[in]  mesh Mesh.
+/// \param[out] r    Report.
+void
+Decomposer::report(Mesh& mesh,
+                   DecompositionReport& r)
+{
+    CHECK_ERROR(!mesh.is_domain_part(), "report can not be calculated for mesh part loaded from domain file");
+
+    size_t cc { mesh.all.cells_count() }, ec { mesh.all.edges_count() };
+    size_t dn { 0 };
+
+    #pragma omp parallel for reduction(max:dn)
+    for (size_t i = 0; i < cc; ++i)
+    {
+        dn = max(dn, mesh.all.cell(i)->get_domain() + 1);
+    }
+
+    r.domains_count = dn;
+    r.cells.assign(dn, 0);
+    r.cut_edges = 0;
+    r.boundary_pairs.assign(dn, vector<size_t>(dn, 0));
+
+    #pragma omp parallel
+    {
+        vector<size_t> cells(dn, 0);
+        vector<vector<size_t>> pairs(dn, vector<size_t>(dn, 0));
+
+        #pragma omp for
+        for (size_t i = 0; i < cc; ++i)
+        {
+            ++cells[mesh.all.cell(i)->get_domain()];
+        }
+
+        #pragma omp for
+        for (size_t i = 0; i < ec; ++i)
+        {
+            Edge* e { mesh.all.edge(i) };
+
+            if (e->is_cross())
+            {
+                ++pairs[e->domain_0()][e->domain_1()];
+                ++pairs[e->domain_1()][e->domain_0()];
+            }
+        }
+
+        #pragma omp critical
+        {
+            for (size_t d = 0; d < dn; ++d)
+            {
+                r.cells[d] += cells[d];
+
+                for (size_t q = 0; q < dn; ++q)
+                {
+                    r.boundary_pairs[d][q] += pairs[d][q];
+                }
+            }
+        }
+    }
+
+    // Ghost cells sent by each domain to each neighbour.
+    vector<vector<size_t>> ds;
+    vector<vector<size_t>> sent(dn, vector<size_t>(dn, 0));
+
+    Boundaries::spread_domains(mesh.all,
+                               mesh.boundaries.get_ghost_depth(),
+                               mesh.boundaries.get_ghost_adjacency(),
+                               ds);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        size_t d { mesh.all.cell(i)->get_domain() };
+
+        for (size_t q : ds[i])
+        {
+            if (q != d)
+            {
+                ++sent[d][q];
+            }
+        }
+    }
+
+    // Pairs of current domain from boundaries.
+    size_t rank { parl::mpi_rank() };
+
+    if (mesh.boundaries.is_allocated() && (rank < dn) && (parl::mpi_size() == dn))
+    {
+        for (size_t q = 0; q < dn; ++q)
+        {
+            DEBUG_CHECK_ERROR(mesh.boundaries.pairs_count(q) == r.boundary_pairs[rank][q],
+                              "boundaries do not correspond to domains of cells");
+            DEBUG_CHECK_ERROR(mesh.boundaries.buffer_size(q) == max(sent[rank][q], sent[q][rank]),
+                              "ghost layers do not correspond to domains of cells");
+            r.boundary_pairs[rank][q] = mesh.boundaries.pairs_count(q);
+        }
+    }
+
+    size_t max_cells { 0 };
+
+    r.neighbours.assign(dn, 0);
+    r.exchange_bytes.assign(dn, 0);
+    r.total_exchange_bytes = 0;
+    r.max_exchange_bytes = 0;
+
+    for (size_t d = 0; d < dn; ++d)
+    {
+        size_t pairs { 0 }, buffer { 0 };
+
+        for (size_t q = 0; q < dn; ++q)
+        {
+            size_t b { max(sent[d][q], sent[q][d]) };
+
+            if (b > 0)
+            {
+                ++r.neighbours[d];
+                buffer += b;
+            }
+
+            pairs += r.boundary_pairs[d][q];
+        }
+
+        max_cells = max(max_cells, r.cells[d]);
+        r.cut_edges += pairs;
+        r.exchange_bytes[d] = buffer * sizeof(double);
+        r.total_exchange_bytes += r.exchange_bytes[d];
+        r.max_exchange_bytes = max(r.max_exchange_bytes, r.exchange_bytes[d]);
+    }
+
+    // Each cross edge is counted for both domains.
+    r.cut_edges /= 2;
+    r.imbalance = (cc > 0)
+                  ? (static_cast<double>(max_cells) * static_cast<double>(dn) / static_cast<double>(cc))
+                  : 0.0;
+}
+
+/// \brief Print in CSV format.
+///
+/// Print one line for each domain (header is in the first line).
+/// Neighbours are given as list of neighbour:pairs separated by spaces.
+///
+/// \param[out] os Out stream.
+void
+DecompositionReport::print_csv(ostream& os) const
+{
+    os << "domain,cells,neighbours,boundary_pairs,exchange_bytes,neighbours_pairs" << endl;
+
+    for (size_t d = 0; d < domains_count; ++d)
+    {
+        size_t pairs { 0 };
+        bool is_first { true };
+
+        for (size_t q = 0; q < domains_count; ++q)
+        {
+            pairs += boundary_pairs[d][q];
+        }
+
+        os << d << "," << cells[d] << "," << neighbours[d] << "," << pairs << ","
+           << exchange_bytes[d] << ",";
+
+        for (size_t q = 0; q < domains_count; ++q)
+        {
+            if (boundary_pairs[d][q] > 0)
+            {
+                os << (is_first ? "" : " ") << q << ":" << boundary_pairs[d][q];
+                is_first = false;
+            }
+        }
+
+        os << endl;
+    }
+}
+
+/// \brief Print function.
+///
+/// Print summary of decomposition report.
+///
+/// \param[out] os Out stream.
+/// \param[in]  r  Report.
+///
+/// \return
+/// Out stream.
+ostream&
+operator<<(ostream& os,
+           const DecompositionReport& r)
+{
+    size_t min_cells { 0 }, max_cells { 0 }, min_ngh { 0 }, max_ngh { 0 };
+
+    if (r.domains_count > 0)
+    {
+        min_cells = *min_element(r.cells.begin(), r.cells.end());
+        max_cells = *max_element(r.cells.begin(), r.cells.end());
+        min_ngh = *min_element(r.neighbours.begin(), r.neighbours.end());
+        max_ngh = *max_element(r.neighbours.begin(), r.neighbours.end());
+    }
+
+    os << "decomposition (" << r.domains_count << " domains):" << endl
+       << "    cells : min " << min_cells << ", max " << max_cells
+       << ", imbalance " << r.imbalance << endl
+       << "    cut edges : " << r.cut_edges << endl
+       << "    neighbours : min " << min_ngh << ", max " << max_ngh << endl
+       << "    exchange bytes : total " << r.total_exchange_bytes
+       << ", max " << r.max_exchange_bytes << endl;
+
+    return os;
+}
+
+/// \brief Print function.
+///
+/// Print rebalancing report.
+///
+/// \param[out] os Out stream.
+/// \param[in]  r  Report.
+///
+/// \return
+/// Out stream.
+ostream&
+operator<<(ostream& os,
+           const RebalanceReport& r)
+{
+    os << "rebalancing (" << (r.is_rebalanced ? "done" : "not needed") << "):" << endl
+       << "    time imbalance : " << r.time_imbalance
+       << ", predicted " << r.predicted_imbalance << endl
+       << "    moved cells : " << r.moved_cells << endl
+       << "    sent : cells " << r.sent_cells << ", nodes " << r.sent_nodes
+       << ", bytes " << r.sent_bytes << endl
+       << "    time : " << r.time << endl;
+
+    return os;
 }
 
 /// @}
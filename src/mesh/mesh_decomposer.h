@@ -7,6 +7,9 @@
 #define CAESAR_MESH_DECOMPOSER_H
 
 #include "mesh_mesh.h"
+#include "mesh_filer.h"
+#include "mesh_partitioner.h"
+#include "mesh_migrator.h"
 
 namespace caesar
 {
@@ -37,8 +40,17 @@ enum class DecompositionType
     /// \brief Farhat decomposition.
     Farhat,
 
+    /// \brief Multilevel partition of cells dual graph.
+    Multilevel,
+
+    /// \brief Recursive coordinate bisection of cells centers.
+    RCB,
+
+    /// \brief Ranges of cells ordered along Hilbert curve.
+    Hilbert,
+
     /// \brief Last element.
-    Last = Farhat
+    Last = Hilbert
 };
 
 /// \brief Mesh decomposition type mapper.
@@ -46,6 +58,83 @@ enum class DecompositionType
 /// Mesh decomposition type mapper.
 extern utils::Mapper<DecompositionType> MeshDecompositionTypeMapper;
 
+/// \brief Decomposition report.
+///
+/// Quality metrics of decomposition.
+struct DecompositionReport
+{
+    /// \brief Domains count.
+    size_t domains_count { 0 };
+
+    /// \brief Cells count of each domain.
+    vector<size_t> cells;
+
+    /// \brief Imbalance (ratio of maximum domain cells count to average one).
+    double imbalance { 0.0 };
+
+    /// \brief Count of cross edges.
+    size_t cut_edges { 0 };
+
+    /// \brief Pairs of cells on boundaries of domains (for each domain and neighbour).
+    vector<vector<size_t>> boundary_pairs;
+
+    /// \brief Count of neighbour domains of each domain.
+    vector<size_t> neighbours;
+
+    /// \brief Bytes sent by each domain in one exchange of cells data.
+    vector<size_t> exchange_bytes;
+
+    /// \brief Total bytes sent in one exchange of cells data.
+    size_t total_exchange_bytes { 0 };
+
+    /// \brief Maximum bytes sent by domain in one exchange of cells data.
+    size_t max_exchange_bytes { 0 };
+
+    // Print in CSV format.
+    void
+    print_csv(ostream& os = cout) const;
+
+    // Print function.
+    friend ostream&
+    operator<<(ostream& os,
+               const DecompositionReport& r);
+};
+
+/// \brief Rebalancing report.
+///
+/// Result and cost of rebalancing.
+struct RebalanceReport
+{
+    /// \brief Flag of performed rebalancing.
+    bool is_rebalanced { false };
+
+    /// \brief Imbalance of processes times (ratio of maximum time to average one).
+    double time_imbalance { 0.0 };
+
+    /// \brief Predicted imbalance after rebalancing (from estimated costs of cells).
+    double predicted_imbalance { 0.0 };
+
+    /// \brief Count of cells which changed domain.
+    size_t moved_cells { 0 };
+
+    /// \brief Count of cells sent between processes.
+    size_t sent_cells { 0 };
+
+    /// \brief Count of nodes sent between processes.
+    size_t sent_nodes { 0 };
+
+    /// \brief Bytes sent between processes.
+    size_t sent_bytes { 0 };
+
+    /// \brief Time of rebalancing (maximum among processes, s).
+    double time { 0.0 };
+
+    // Print function.
+    friend ostream&
+    operator<<(ostream& os,
+               const RebalanceReport& r);
+};
+
 /// \brief Decomposer class.
 ///
 /// Decomposer type.
@@ -81,24 +170,349 @@ private:
     // Linear decomposition.
     static void
     decompose_linear(Mesh& mesh,
-                     size_t dn);
+                     size_t dn,
+                     const vector<double>& weights);
 
     // Farhat decomposition.
     static void
     decompose_farhat(Mesh& mesh,
-                     size_t dn);
+                     size_t dn,
+                     const vector<double>& weights);
+
+    // Multilevel decomposition.
+    static void
+    decompose_multilevel(Mesh& mesh,
+                         size_t dn,
+                         const vector<double>& weights);
+
+    // Recursive coordinate bisection of range of cells.
+    static void
+    rcb(Mesh& mesh,
+        const vector<geom::Vector>& centers,
+        vector<size_t>& order,
+        size_t first,
+        size_t count,
+        size_t first_domain,
+        size_t dn,
+        const vector<double>& weights);
+
+    // Recursive coordinate bisection decomposition.
+    static void
+    decompose_rcb(Mesh& mesh,
+                  size_t dn,
+                  const vector<double>& weights);
+
+    // Hilbert curve decomposition.
+    static void
+    decompose_hilbert(Mesh& mesh,
+                      size_t dn,
+                      const vector<double>& weights);
+
+    // Refine decomposition.
+    static void
+    refine(Mesh& mesh,
+           size_t dn,
+           const vector<double>& weights);
 
     // Post decompose action.
     static void
     post_decompose(Mesh& mesh);
 
+    // New domains for rebalancing.
+    static bool
+    rebalance_domains(Mesh& mesh,
+                      double time,
+                      double threshold,
+                      vector<size_t>& old_domains,
+                      RebalanceReport& r);
+
+    // Finish rebalancing report.
+    static void
+    rebalance_report(const Migrator& migrator,
+                     size_t cells_width,
+                     size_t nodes_width,
+                     double time,
+                     RebalanceReport& r);
+
+    // Cells of domain file.
+    static void
+    domain_file_cells(Mesh& mesh,
+                      size_t d,
+                      size_t ghost_layers,
+                      vector<Cell*>& cells);
+
+    // Variables of domain file.
+    static void
+    domain_file_variables(const Mesh& mesh,
+                          vector<string>& variables_names,
+                          pair<size_t, size_t>& varlocation_cellcentered);
+
+    // Init mesh part loaded from domain file.
+    static void
+    init_domain_part(Mesh& mesh);
+
+    // Renumber mesh elements by blocks.
+    static void
+    renumber_blocks(Mesh& mesh,
+                    size_t bn);
+
 public:
 
     // Decompose mesh.
     static void
     decompose(Mesh& mesh,
               DecompositionType type,
-              size_t dn);
+              size_t dn,
+              bool is_refine = true);
+
+    // Decompose mesh with weights of cells.
+    static void
+    decompose(Mesh& mesh,
+              DecompositionType type,
+              size_t dn,
+              const vector<double>& weights,
+              bool is_refine = true);
+
+    /// \brief Decompose mesh with weights of cells from cell data.
+    ///
+    /// Decompose mesh with weights of cells from cell data element.
+    ///
+    /// \tparam TCellData Cell data type.
+    ///
+    /// \param[out] mesh      Mesh.
+    /// \param[in]  type      Decomposition type.
+    /// \param[in]  dn        Number of domains.
+    /// \param[in]  index     Index of cell data element with weight.
+    /// \param[in]  is_refine Refine decomposition.
+    template<typename TCellData>
+    static void
+    decompose(Mesh& mesh,
+              DecompositionType type,
+              size_t dn,
+              int index,
+              bool is_refine = true)
+    {
+        size_t cc { mesh.all.cells_count() };
+        vector<double> weights(cc);
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            weights[i] = mesh.all.cell(i)->get_element<TCellData>(index);
+        }
+
+        decompose(mesh, type, dn, weights, is_refine);
+    }
+
+    // Split cells of domains into blocks for threads.
+    static void
+    build_blocks(Mesh& mesh,
+                 size_t bn = 0);
+
+    // Name of domain file.
+    static string
+    domain_file_name(const string& prefix,
+                     size_t d);
+
+    /// \brief Store domains files.
+    ///
+    /// Mesh must be decomposed (domains of cells are set) and replicated
+    /// (not part loaded from domain file).
+    /// For each domain file holds its own cells and several layers of ghost cells
+    /// adjacent by nodes (two layers are needed for distributed remeshing).
+    /// Original identifiers of nodes and cells and domains of cells are stored
+    /// as data elements NodeId, CellId and Domain.
+    ///
+    /// \tparam    TNodeData    Node data.
+    /// \tparam    TCellData    Cell data.
+    /// \param[in] mesh         Mesh.
+    /// \param[in] prefix       Prefix of files names.
+    /// \param[in] ghost_layers Count of ghost layers.
+    ///
+    /// \return
+    /// true - if all files are stored,
+    /// false - otherwise.
+    template<typename TNodeData,
+             typename TCellData>
+    static bool
+    store_domains(Mesh& mesh,
+                  const string& prefix,
+                  size_t ghost_layers = 2)
+    {
+        CHECK_ERROR(!mesh.is_domain_part(), "domains files can not be stored from mesh part");
+
+        size_t dn { 0 };
+        vector<string> variables_names;
+        pair<size_t, size_t> varlocation_cellcentered;
+
+        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        {
+            dn = max(dn, mesh.all.cell(i)->get_domain() + 1);
+        }
+
+        domain_file_variables(mesh, variables_names, varlocation_cellcentered);
+
+        for (size_t d = 0; d < dn; ++d)
+        {
+            vector<Cell*> cells;
+
+            domain_file_cells(mesh, d, ghost_layers, cells);
+
+            if (!Filer::store_cells<TNodeData, TCellData>(mesh,
+                                                          cells,
+                                                          variables_names,
+                                                          varlocation_cellcentered,
+                                                          domain_file_name(prefix, d)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /// \brief Load domain file.
+    ///
+    /// Each process loads only file of its own domain,
+    /// so memory of process does not depend on size of whole mesh.
+    /// Boundaries are built with original identifiers of cells,
+    /// own lists and halo are built as after decomposition.
+    /// Data is not gathered in process 0 for mesh part.
+    /// Mesh part can not be decomposed, rebalanced or reported
+    /// (these operations need whole mesh).
+    ///
+    /// \tparam        TNodeData Node data.
+    /// \tparam        TEdgeData Edge data.
+    /// \tparam        TCellData Cell data.
+    /// \param[in,out] mesh      Mesh.
+    /// \param[in]     prefix    Prefix of files names.
+    ///
+    /// \return
+    /// true - if domain file is loaded,
+    /// false - otherwise.
+    template<typename TNodeData,
+             typename TEdgeData,
+             typename TCellData>
+    static bool
+    load_domain(Mesh& mesh,
+                const string& prefix)
+    {
+        if (!Filer::load_mesh<TNodeData, TEdgeData, TCellData>(mesh,
+                                                               domain_file_name(prefix,
+                                                                                parl::mpi_rank())))
+        {
+            return false;
+        }
+
+        init_domain_part(mesh);
+        post_decompose(mesh);
+
+        return true;
+    }
+
+    // Estimate weights of cells from their work in last remeshing.
+    static void
+    estimate_weights(Mesh& mesh,
+                     vector<double>& weights,
+                     double work_fact = 1.0);
+
+    // Decomposition report.
+    static void
+    report(Mesh& mesh,
+           DecompositionReport& r);
+
+    /// \brief Rebalance distributed mesh.
+    ///
+    /// Imbalance is detected from times of processes.
+    /// If it is not less than threshold, new domains are calculated
+    /// close to current ones, data of cells and nodes is migrated to new processes
+    /// (remesher data of cells, cell data elements and nodes points),
+    /// then boundaries, own lists, domains cells, gatherer and halo are rebuilt.
+    /// All processes must call it (with their own times).
+    /// Mesh must be replicated, mesh part loaded from domain file can not be rebalanced.
+    ///
+    /// \tparam    TCellData Cell data type.
+    ///
+    /// \param[out] mesh      Mesh.
+    /// \param[in]  time      Time of work of current process (for example, last step).
+    /// \param[in]  threshold Imbalance of times which triggers rebalancing.
+    /// \param[out] r         Report.
+    ///
+    /// \return
+    /// true - if mesh is rebalanced,
+    /// false - otherwise.
+    template<typename TCellData>
+    static bool
+    rebalance(Mesh& mesh,
+              double time,
+              double threshold,
+              RebalanceReport& r)
+    {
+        utils::Timer timer;
+        vector<size_t> old_domains;
+        Migrator migrator;
+        vector<string> names;
+        vector<int> indices;
+
+        TCellData::mapper.append_names_to(names);
+
+        for (const string& name : names)
+        {
+            indices.push_back(static_cast<int>(TCellData::mapper.num(name)));
+        }
+
+        size_t cw { 2 + indices.size() };
+
+        timer.start();
+
+        if (rebalance_domains(mesh, time, threshold, old_domains, r))
+        {
+            migrator.build(mesh.all, old_domains, parl::mpi_rank(), parl::mpi_size());
+
+            migrator.exchange_cells(cw,
+                                    [&indices](const Cell* c, double* v)
+                                    {
+                                        v[0] = c->ice_shift;
+                                        v[1] = c->work;
+
+                                        for (size_t k = 0; k < indices.size(); ++k)
+                                        {
+                                            v[2 + k] = c->get_element<TCellData>(indices[k]);
+                                        }
+                                    },
+                                    [&indices](Cell* c, const double* v)
+                                    {
+                                        c->ice_shift = v[0];
+                                        c->work = v[1];
+
+                                        for (size_t k = 0; k < indices.size(); ++k)
+                                        {
+                                            c->set_element<TCellData>(indices[k], v[2 + k]);
+                                        }
+                                    });
+
+            migrator.exchange_nodes(3,
+                                    [](const Node* n, double* v)
+                                    {
+                                        const geom::Vector& p { n->point() };
+
+                                        v[0] = p.x;
+                                        v[1] = p.y;
+                                        v[2] = p.z;
+                                    },
+                                    [](Node* n, const double* v)
+                                    {
+                                        n->set_point(geom::Vector(v[0], v[1], v[2]));
+                                    });
+
+            post_decompose(mesh);
+            mesh.calc_geometry(mesh.halo.part);
+        }
+
+        timer.stop();
+        rebalance_report(migrator, cw, 3, timer.get(), r);
+
+        return r.is_rebalanced;
+    }
 };
 
 /// @}
@@ -155,6 +155,18 @@ public:
         return length_;
     }
 
+    /// \brief Get original length.
+    ///
+    /// Get original length.
+    ///
+    /// \return
+    /// Original length.
+    inline double
+    original_length() const
+    {
+        return original_length_;
+    }
+
 private:
 
     /// \brief Calculate length.
@@ -24,17 +24,22 @@ namespace mesh
 void
 EdgesColorizer::colorize_edges(Mesh& mesh)
 {
+    size_t r { parl::mpi_rank() };
     size_t occ { mesh.own.cells_count() };
+    size_t oec { mesh.own.edges_count() };
     graph::Graph* g = graph::GraphFactory::create_edgeless_graph(occ);
 
+    // Forget previous colorization.
+    mesh.clear_own_edges_colors();
+
     // Add all edges.
-    for (size_t i = 0; i < occ; ++i)
+    for (size_t i = 0; i < oec; ++i)
     {
         Edge* e { mesh.own.edge(i) };
 
         DEBUG_CHECK_ERROR(e->cells_count() > 0, "mesh edge without cells is detected");
 
-        if (e->cells_count() > 1)
+        if ((e->cells_count() > 1) && (e->domain_0() == r) && (e->domain_1() == r))
         {
             // Inner edge.
             g->add_edge(static_cast<size_t>(e->cell(0)->get_loc_id()),
@@ -45,10 +50,11 @@ EdgesColorizer::colorize_edges(Mesh& mesh)
             // Edge, one of incident cells of which is not own cell.
             // Add new vertex for this outer cell.
 
+            Cell* c { (e->domain_0() == r) ? e->cell(0) : e->cell(1) };
             graph::Vertex* v = g->new_vertex();
 
             // Now add new edge.
-            g->add_edge(static_cast<size_t>(e->cell(0)->get_loc_id()),
+            g->add_edge(static_cast<size_t>(c->get_loc_id()),
                         static_cast<size_t>(v->get_id()));
         }
     }
@@ -0,0 +1,413 @@
+/// \file
+/// \brief Ensemble remeshing.
+///
+/// Ensemble remeshing implementation.
+
+#include "mesh_ensemble.h"
+
+#include <omp.h>
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Constructor.
+///
+/// Current points of mesh nodes become base points of all members.
+/// Ensemble is registered in mesh, so mesh elements are not renumbered while it exists.
+///
+/// \param[in] mesh_ Mesh.
+Ensemble::Ensemble(Mesh& mesh_)
+    : mesh(mesh_)
+{
+    mesh.get_nodes_points(base_points);
+    ++mesh.ensembles_count_;
+}
+
+/// \brief Destructor.
+///
+/// Unregister ensemble in mesh.
+Ensemble::~Ensemble()
+{
+    --mesh.ensembles_count_;
+}
+
+/// \brief Add member with ice heights of mesh cells.
+///
+/// Current ice heights of mesh cells are copied into member.
+///
+/// \param[in] opts_ Remesh options.
+///
+/// \return
+/// Member number.
+size_t
+Ensemble::add_member(const RemeshOptions& opts_)
+{
+    size_t cc { mesh.all.cells_count() };
+    vector<double> hs(cc);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        hs[i] = mesh.all.cell(i)->ice_shift;
+    }
+
+    return add_member(opts_, hs);
+}
+
+/// \brief Add member.
+///
+/// Add member with given options and ice heights.
+///
+/// \param[in] opts_       Remesh options.
+/// \param[in] ice_shifts_ Ice heights of cells (index is cell global identifier).
+///
+/// \return
+/// Member number.
+size_t
+Ensemble::add_member(const RemeshOptions& opts_,
+                     const vector<double>& ice_shifts_)
+{
+    DEBUG_CHECK_ERROR(ice_shifts_.size() == mesh.all.cells_count(), "wrong count of ice heights");
+
+    opts.push_back(opts_);
+    ice_shifts.push_back(ice_shifts_);
+    points.push_back(vector<geom::Vector>());
+
+    // Topology is shared, so it can not be changed.
+    if (opts.back().is_improve_quality)
+    {
+        WARNING("quality improvement is not supported for ensemble member");
+        opts.back().is_improve_quality = false;
+    }
+
+    return opts.size() - 1;
+}
+
+/// \brief Process which remeshes member.
+///
+/// If remeshing is distributed (or there is only one process),
+/// all processes remesh all members, so current process is returned.
+/// Otherwise members are distributed among processes cyclically.
+///
+/// \param[in] m Member.
+///
+/// \return
+/// Process.
+size_t
+Ensemble::member_process(size_t m) const
+{
+    size_t s { static_cast<size_t>(parl::mpi_size()) };
+
+    if ((s == 1) || Remesher::is_distributed(mesh))
+    {
+        return static_cast<size_t>(parl::mpi_rank());
+    }
+
+    return m % s;
+}
+
+/// \brief Save state of mesh elements.
+///
+/// Save all values of mesh elements which are changed by remesher.
+///
+/// \param[in]  m  Mesh.
+/// \param[out] st State.
+void
+Ensemble::save_state(const Mesh& m,
+                     ElementsState& st)
+{
+    const size_t cv { 7 };
+    size_t nc { m.all.nodes_count() }, ec { m.all.edges_count() }, cc { m.all.cells_count() };
+
+    st.cells_values.resize(cv * cc);
+    st.cells_dirs.resize(cc);
+    st.cells_marks.resize(cc);
+    st.nodes_points.resize(nc);
+    st.nodes_dirs.resize(nc);
+    st.nodes_shifts.resize(nc);
+    st.nodes_ice_shifts.resize(nc);
+    st.nodes_marks.resize(nc);
+    st.edges_marks.resize(ec);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        const Cell* c { m.all.cell(i) };
+        double* v { &st.cells_values[cv * i] };
+
+        v[0] = c->target_ice;
+        v[1] = c->rest_ice;
+        v[2] = c->ice_chunk;
+        v[3] = c->loc_ice_chunk;
+        v[4] = c->ice_shift;
+        v[5] = c->saved_area;
+        v[6] = c->work;
+        st.cells_dirs[i].set(c->ice_dir);
+        st.cells_marks[i] = c->get_mark();
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < nc; ++i)
+    {
+        const Node* n { m.all.node(i) };
+
+        st.nodes_points[i].set(n->point());
+        st.nodes_dirs[i].set(n->ice_dir);
+        st.nodes_shifts[i].set(n->shift);
+        st.nodes_ice_shifts[i] = n->ice_shift;
+        st.nodes_marks[i] = n->get_mark();
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < ec; ++i)
+    {
+        st.edges_marks[i] = m.all.edge(i)->get_mark();
+    }
+}
+
+/// \brief Restore state of mesh elements.
+///
+/// Restore all values of mesh elements which are changed by remesher
+/// and recalculate geometry.
+///
+/// \param[in,out] m  Mesh.
+/// \param[in]     st State.
+void
+Ensemble::restore_state(Mesh& m,
+                        const ElementsState& st)
+{
+    const size_t cv { 7 };
+    size_t nc { m.all.nodes_count() }, ec { m.all.edges_count() }, cc { m.all.cells_count() };
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { m.all.cell(i) };
+        const double* v { &st.cells_values[cv * i] };
+
+        c->target_ice = v[0];
+        c->rest_ice = v[1];
+        c->ice_chunk = v[2];
+        c->loc_ice_chunk = v[3];
+        c->ice_shift = v[4];
+        c->saved_area = v[5];
+        c->work = v[6];
+        c->ice_dir.set(st.cells_dirs[i]);
+        c->set_mark(st.cells_marks[i]);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < nc; ++i)
+    {
+        Node* n { m.all.node(i) };
+
+        n->set_point(st.nodes_points[i]);
+        n->ice_dir.set(st.nodes_dirs[i]);
+        n->shift.set(st.nodes_shifts[i]);
+        n->ice_shift = st.nodes_ice_shifts[i];
+        n->set_mark(st.nodes_marks[i]);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < ec; ++i)
+    {
+        m.all.edge(i)->set_mark(st.edges_marks[i]);
+    }
+
+    m.calc_geometry();
+}
+
+/// \brief Remesh member in mesh or worker.
+///
+/// Base points and member ice are loaded into mesh (or worker),
+/// it is remeshed with member options and points of nodes are saved.
+///
+/// \param[in,out] w Mesh or worker (copy of mesh topology).
+/// \param[in]     m Member.
+void
+Ensemble::remesh_member(Mesh& w,
+                        size_t m)
+{
+    size_t cc { w.all.cells_count() };
+    const vector<double>& hs { ice_shifts[m] };
+
+    w.set_nodes_points(base_points);
+    w.calc_geometry();
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        w.all.cell(i)->ice_shift = hs[i];
+    }
+
+    Remesher::remesh(w, opts[m]);
+    w.get_nodes_points(points[m]);
+}
+
+/// \brief Remesh all members.
+///
+/// If remeshing is not distributed, members of current process run concurrently:
+/// each member is an OpenMP task which is remeshed on worker of its thread
+/// (threads are shared between concurrent members, remeshing of member is nested parallel).
+/// State of worker is restored before each member, so result of member
+/// does not depend on other members.
+/// If remeshing is distributed, members are remeshed in mesh one after another
+/// and state of mesh elements is restored before each member and in the end.
+/// Then points of members are gathered in all processes.
+void
+Ensemble::remesh()
+{
+    size_t nc { mesh.all.nodes_count() };
+    size_t rank { static_cast<size_t>(parl::mpi_rank()) };
+    bool is_dist { Remesher::is_distributed(mesh) };
+    bool is_gather { (parl::mpi_size() > 1) && !is_dist };
+    vector<size_t> ms;
+
+    for (size_t m = 0; m < members_count(); ++m)
+    {
+        if (member_process(m) == rank)
+        {
+            ms.push_back(m);
+        }
+    }
+
+    if (is_dist)
+    {
+        ElementsState st;
+
+        save_state(mesh, st);
+
+        for (size_t m : ms)
+        {
+            restore_state(mesh, st);
+            remesh_member(mesh, m);
+        }
+
+        restore_state(mesh, st);
+    }
+    else if (!ms.empty())
+    {
+        size_t tn { static_cast<size_t>(max(omp_get_max_threads(), 1)) };
+        size_t wn { min(ms.size(), tn) };
+        int inner { static_cast<int>(max(tn / wn, static_cast<size_t>(1))) };
+        int levels { omp_get_max_active_levels() };
+        vector<Mesh> workers(wn);
+        ElementsState st;
+
+        // Elements are created and deleted sequentially (elements counters are not atomic).
+        for (Mesh& w : workers)
+        {
+            w.copy_topology(mesh);
+        }
+
+        save_state(workers[0], st);
+        omp_set_max_active_levels(max(levels, 2));
+
+        #pragma omp parallel num_threads(static_cast<int>(wn))
+        {
+            #pragma omp single
+            {
+                for (size_t m : ms)
+                {
+                    // Task is tied to its thread, so worker of thread is used by one task at once.
+                    #pragma omp task firstprivate(m) shared(workers, st)
+                    {
+                        Mesh& w { workers[static_cast<size_t>(omp_get_thread_num())] };
+
+                        omp_set_num_threads(inner);
+                        restore_state(w, st);
+                        remesh_member(w, m);
+                    }
+                }
+            }
+        }
+
+        omp_set_max_active_levels(levels);
+
+        for (Mesh& w : workers)
+        {
+            w.clear();
+        }
+    }
+
+    // Points of members are summed, only process of member gives nonzero values.
+    if (is_gather)
+    {
+        vector<double> buf(3 * nc);
+
+        for (size_t m = 0; m < members_count(); ++m)
+        {
+            bool is_my { member_process(m) == rank };
+
+            #pragma omp parallel for
+            for (size_t i = 0; i < nc; ++i)
+            {
+                const geom::Vector& p { is_my ? points[m][i] : base_points[i] };
+                double k { is_my ? 1.0 : 0.0 };
+
+                buf[3 * i] = k * p.x;
+                buf[3 * i + 1] = k * p.y;
+                buf[3 * i + 2] = k * p.z;
+            }
+
+            parl::mpi_allreduce_sum(buf);
+            points[m].resize(nc);
+
+            #pragma omp parallel for
+            for (size_t i = 0; i < nc; ++i)
+            {
+                points[m][i].set(buf[3 * i], buf[3 * i + 1], buf[3 * i + 2]);
+            }
+        }
+    }
+}
+
+/// \brief Load member geometry into mesh.
+///
+/// Set points of nodes of member and recalculate geometry.
+///
+/// \param[in] m Member.
+void
+Ensemble::load_member(size_t m)
+{
+    mesh.set_nodes_points(get_points(m));
+    mesh.calc_geometry();
+}
+
+/// \brief Load base geometry into mesh.
+///
+/// Set base points of nodes and recalculate geometry.
+void
+Ensemble::load_base()
+{
+    mesh.set_nodes_points(base_points);
+    mesh.calc_geometry();
+}
+
+/// \brief Memory of member state (bytes).
+///
+/// Only options, ice heights and points are stored for member.
+///
+/// \param[in] m Member.
+///
+/// \return
+/// Memory (bytes).
+size_t
+Ensemble::member_memory(size_t m) const
+{
+    return sizeof(RemeshOptions)
+           + ice_shifts[m].capacity() * sizeof(double)
+           + points[m].capacity() * sizeof(geom::Vector);
+}
+
+/// @}
+
+}
+
+}
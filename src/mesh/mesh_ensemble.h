@@ -0,0 +1,229 @@
+/// \file
+/// \brief Ensemble remeshing.
+///
+/// Ensemble remeshing declaration.
+
+#ifndef CAESAR_MESH_ENSEMBLE_H
+#define CAESAR_MESH_ENSEMBLE_H
+
+#include "mesh_remesher.h"
+#include "mesh_filer.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Ensemble remeshing.
+///
+/// Ensemble is a set of members which remesh the same mesh with different options and ice.
+/// Topology (nodes, edges, cells and links between them) is shared by all members,
+/// each member keeps only its ice heights and nodes points.
+/// If remeshing is not distributed, members are distributed among processes
+/// and members of process run concurrently as OpenMP tasks,
+/// otherwise all processes run all members one by one.
+/// After remeshing all processes have results of all members.
+/// Members can not change topology (quality improvement is off)
+/// and mesh elements can not be renumbered while ensemble exists
+/// (data of members is indexed with identifiers of elements).
+///
+/// Remesher keeps its state (ice heights, directions and chunks, nodes shifts) in mesh elements,
+/// so concurrent members are remeshed on workers: copies of topology, one for each thread
+/// (count of workers is not greater than count of threads, not count of members).
+/// Mesh itself is not changed by concurrent remeshing.
+/// For distributed remeshing members are remeshed in mesh,
+/// state of its elements is saved before and restored after remeshing.
+class Ensemble
+{
+
+private:
+
+    /// \brief State of mesh elements changed by remesher.
+    ///
+    /// Values are indexed with identifiers of elements.
+    struct ElementsState
+    {
+        /// \brief Cells scalars (target ice, rest ice, ice chunk, local ice chunk,
+        /// ice shift, saved area, work for each cell).
+        vector<double> cells_values;
+
+        /// \brief Cells ice directions.
+        vector<geom::Vector> cells_dirs;
+
+        /// \brief Cells marks.
+        vector<int> cells_marks;
+
+        /// \brief Nodes points.
+        vector<geom::Vector> nodes_points;
+
+        /// \brief Nodes ice directions.
+        vector<geom::Vector> nodes_dirs;
+
+        /// \brief Nodes shifts.
+        vector<geom::Vector> nodes_shifts;
+
+        /// \brief Nodes ice shifts.
+        vector<double> nodes_ice_shifts;
+
+        /// \brief Nodes marks.
+        vector<int> nodes_marks;
+
+        /// \brief Edges marks.
+        vector<int> edges_marks;
+    };
+
+    /// \brief Mesh (shared topology).
+    Mesh& mesh;
+
+    /// \brief Base points of nodes.
+    ///
+    /// All members start from these points.
+    vector<geom::Vector> base_points;
+
+    /// \brief Options of members.
+    vector<RemeshOptions> opts;
+
+    /// \brief Ice heights of cells (for each member).
+    vector<vector<double>> ice_shifts;
+
+    /// \brief Points of nodes after remeshing (for each member).
+    vector<vector<geom::Vector>> points;
+
+public:
+
+    // Constructor.
+    Ensemble(Mesh& mesh_);
+
+    // Ensemble is registered in mesh, so it is not copied.
+    Ensemble(const Ensemble&) = delete;
+
+    // Destructor.
+    ~Ensemble();
+
+    // Add member with ice heights of mesh cells.
+    size_t
+    add_member(const RemeshOptions& opts_);
+
+    // Add member.
+    size_t
+    add_member(const RemeshOptions& opts_,
+               const vector<double>& ice_shifts_);
+
+    /// \brief Get members count.
+    ///
+    /// Get members count.
+    ///
+    /// \return
+    /// Members count.
+    inline size_t
+    members_count() const
+    {
+        return opts.size();
+    }
+
+    /// \brief Get options of member.
+    ///
+    /// Get options of member.
+    ///
+    /// \param[in] m Member.
+    ///
+    /// \return
+    /// Options.
+    inline const RemeshOptions&
+    get_options(size_t m) const
+    {
+        return opts[m];
+    }
+
+    /// \brief Get points of member nodes.
+    ///
+    /// Get points of member nodes (base points before remeshing).
+    ///
+    /// \param[in] m Member.
+    ///
+    /// \return
+    /// Points.
+    inline const vector<geom::Vector>&
+    get_points(size_t m) const
+    {
+        return points[m].empty() ? base_points : points[m];
+    }
+
+    // Process which remeshes member.
+    size_t
+    member_process(size_t m) const;
+
+private:
+
+    // Save state of mesh elements.
+    static void
+    save_state(const Mesh& m,
+               ElementsState& st);
+
+    // Restore state of mesh elements.
+    static void
+    restore_state(Mesh& m,
+                  const ElementsState& st);
+
+    // Remesh member in mesh or worker.
+    void
+    remesh_member(Mesh& w,
+                  size_t m);
+
+public:
+
+    // Remesh all members.
+    void
+    remesh();
+
+    // Load member geometry into mesh.
+    void
+    load_member(size_t m);
+
+    // Load base geometry into mesh.
+    void
+    load_base();
+
+    // Memory of member state (bytes).
+    size_t
+    member_memory(size_t m) const;
+
+    /// \brief Store member mesh.
+    ///
+    /// Load member geometry into mesh, store mesh and load base geometry back.
+    ///
+    /// \tparam    TNodeData Node data.
+    /// \tparam    TCellData Cell data.
+    /// \param[in] m         Member.
+    /// \param[in] fn        Name of file.
+    ///
+    /// \return
+    /// true - if store is complete,
+    /// false - otherwise.
+    template<typename TNodeData,
+             typename TCellData>
+    bool
+    store_member(size_t m,
+                 const string& fn)
+    {
+        load_member(m);
+
+        bool res { Filer::store_mesh<TNodeData, TCellData>(mesh, fn) };
+
+        load_base();
+
+        return res;
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_ENSEMBLE_H
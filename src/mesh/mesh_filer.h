@@ -226,6 +226,7 @@ public:
     {
         // Clear mesh before load it again.
         mesh.clear<TNodeData, TEdgeData, TCellData>();
+        mesh.set_data_types<TNodeData, TEdgeData, TCellData>();
 
         ifstream f(fn);
         string line { "" };
@@ -436,6 +437,54 @@ public:
         }
     }
 
+    /// \brief Store zone.
+    ///
+    /// Store zone header, data and links.
+    ///
+    /// \tparam    TNodeData                Node data.
+    /// \tparam    TCellData                Cell data.
+    /// \param[in] zone                     Zone.
+    /// \param[in] variables_names          Names of variables.
+    /// \param[in] varlocation_cellcentered Position of cellcentered data.
+    /// \param[in] f                        File stream.
+    template<typename TNodeData,
+             typename TCellData>
+    static void
+    store_zone(Zone* zone,
+               const vector<string>& variables_names,
+               const pair<size_t, size_t>& varlocation_cellcentered,
+               ofstream& f)
+    {
+        // Zone name line.
+        f << "ZONE T=\"" << zone->name << "\"" << endl;
+
+        // Nodes count line.
+        f << "NODES=" << zone->nodes_count() << endl;
+
+        // Elements count line.
+        f << "ELEMENTS=" << zone->cells_count() << endl;
+
+        // Datapacking line.
+        f << "DATAPACKING=BLOCK" << endl;
+
+        // Zone type line.
+        f << "ZONETYPE=FETRIANGLE" << endl;
+
+        // Varlocation line.
+        f << "VARLOCATION=(["
+          << varlocation_cellcentered.first << "-"
+          << varlocation_cellcentered.second << "]=CELLCENTERED)" << endl;
+
+        // Store all data.
+        store_zone_data<TNodeData, TCellData>(zone,
+                                              variables_names,
+                                              varlocation_cellcentered,
+                                              f);
+
+        // Store links.
+        store_zone_links(zone, f);
+    }
+
     /// \brief Store mesh.
     ///
     /// \tparam    TNodeData                Node data.
@@ -480,36 +529,105 @@ public:
         // Store all zones.
         for (size_t i = 0; i < mesh.zones_count(); ++i)
         {
-            Zone* current_zone = mesh.get_zones()[i];
+            store_zone<TNodeData, TCellData>(mesh.get_zones()[i],
+                                             variables_names,
+                                             varlocation_cellcentered,
+                                             f);
+        }
+
+        f.close();
+
+        return true;
+    }
+
+    /// \brief Store cells of mesh.
+    ///
+    /// Store only given cells and their nodes.
+    /// Cells are stored in zones of mesh (empty zones are not stored),
+    /// order of cells and nodes in each zone is order of their identifiers.
+    ///
+    /// \tparam    TNodeData                Node data.
+    /// \tparam    TCellData                Cell data.
+    /// \param[in] mesh                     Mesh.
+    /// \param[in] cells                    Cells to be stored.
+    /// \param[in] variables_names          List of variables names to store.
+    /// \param[in] varlocation_cellcentered Position of cellcentered data.
+    /// \param[in] fn                       Name of file.
+    ///
+    /// \return
+    /// true - if store is complete,
+    /// false - otherwise.
+    template<typename TNodeData,
+             typename TCellData>
+    static bool
+    store_cells(Mesh& mesh,
+                const vector<Cell*>& cells,
+                const vector<string>& variables_names,
+                const pair<size_t, size_t>& varlocation_cellcentered,
+                const string& fn)
+    {
+        ofstream f(fn);
+
+        if (!f.is_open())
+        {
+            return false;
+        }
+
+        // Header is the same as for whole mesh.
+        f << "# crys export" << endl;
+        f << "TITLE=\"" << mesh.title << "\"" << endl;
+        store_mesh_variables_names(variables_names, f);
+
+        for (size_t i = 0; i < mesh.zones_count(); ++i)
+        {
+            Zone* mesh_zone { mesh.get_zones()[i] };
+            Zone zone;
+            vector<Cell*> zone_cells;
+            vector<Node*> zone_nodes;
 
-            // Zone name line.
-            f << "ZONE T=\"" << current_zone->name << "\"" << endl;
+            for (Cell* c : cells)
+            {
+                if (c->get_zone() == mesh_zone)
+                {
+                    zone_cells.push_back(c);
 
-            // Nodes count line.
-            f << "NODES=" << current_zone->nodes_count() << endl;
+                    for (size_t j = 0; j < c->nodes_count(); ++j)
+                    {
+                        zone_nodes.push_back(c->node(j));
+                    }
+                }
+            }
 
-            // Elements count line.
-            f << "ELEMENTS=" << current_zone->cells_count() << endl;
+            if (zone_cells.empty())
+            {
+                continue;
+            }
+
+            auto by_id = [](const utils::IdsHolder* a, const utils::IdsHolder* b)
+            {
+                return a->get_id() < b->get_id();
+            };
 
-            // Datapacking line.
-            f << "DATAPACKING=BLOCK" << endl;
+            sort(zone_cells.begin(), zone_cells.end(), by_id);
+            sort(zone_nodes.begin(), zone_nodes.end(), by_id);
+            zone_nodes.erase(unique(zone_nodes.begin(), zone_nodes.end()), zone_nodes.end());
 
-            // Zone type line.
-            f << "ZONETYPE=FETRIANGLE" << endl;
+            zone.name = mesh_zone->name;
 
-            // Varlocation line.
-            f << "VARLOCATION=(["
-              << varlocation_cellcentered.first << "-"
-             << varlocation_cellcentered.second << "]=CELLCENTERED)" << endl;
+            for (Node* n : zone_nodes)
+            {
+                zone.add_node(n);
+            }
 
-            // Store all data.
-            store_zone_data<TNodeData, TCellData>(current_zone,
-                                                  variables_names,
-                                                  varlocation_cellcentered,
-                                                  f);
+            for (Cell* c : zone_cells)
+            {
+                zone.add_cell(c);
+            }
 
-            // Store links.
-            store_zone_links(current_zone, f);
+            store_zone<TNodeData, TCellData>(&zone,
+                                             variables_names,
+                                             varlocation_cellcentered,
+                                             f);
         }
 
         f.close();
@@ -0,0 +1,294 @@
+/// \file
+/// \brief Halo of domain.
+///
+/// Halo of domain implementation.
+
+#include "mesh_halo.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Add domain into sorted list of domains.
+///
+/// Add domain into sorted list of domains if it is not there.
+///
+/// \param[in,out] ds Domains.
+/// \param[in]     d  Domain.
+static void
+add_domain(vector<size_t>& ds,
+           size_t d)
+{
+    auto it = lower_bound(ds.begin(), ds.end(), d);
+
+    if ((it == ds.end()) || (*it != d))
+    {
+        ds.insert(it, d);
+    }
+}
+
+/// \brief Check if domain is in sorted list of domains.
+///
+/// Check if domain is in sorted list of domains.
+///
+/// \param[in] ds Domains.
+/// \param[in] d  Domain.
+///
+/// \return
+/// true - if domain is in list,
+/// false - otherwise.
+static bool
+has_domain(const vector<size_t>& ds,
+           size_t d)
+{
+    return binary_search(ds.begin(), ds.end(), d);
+}
+
+/// \brief Default constructor.
+///
+/// Default constructor.
+Halo::Halo()
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+Halo::~Halo()
+{
+}
+
+/// \brief Calculate domains around nodes and cells.
+///
+/// For each node - sorted list of domains of its incident cells.
+/// For each cell - sorted list of domains of cells adjacent by nodes (including cell itself).
+///
+/// \param[in]  all           All mesh elements.
+/// \param[in]  domains       Domains of cells.
+/// \param[out] nodes_domains Domains around nodes.
+/// \param[out] cells_domains Domains around cells.
+void
+Halo::calc_domains(NodesEdgesCellsHolder& all,
+                   const vector<size_t>& domains,
+                   vector<vector<size_t>>& nodes_domains,
+                   vector<vector<size_t>>& cells_domains)
+{
+    size_t nc { all.nodes_count() }, cc { all.cells_count() };
+
+    nodes_domains.assign(nc, vector<size_t>());
+    cells_domains.assign(cc, vector<size_t>());
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        Node* n { all.node(i) };
+
+        for (size_t j = 0; j < n->cells_count(); ++j)
+        {
+            add_domain(nodes_domains[i], domains[static_cast<size_t>(n->cell(j)->get_id())]);
+        }
+    }
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { all.cell(i) };
+
+        for (size_t j = 0; j < c->nodes_count(); ++j)
+        {
+            for (size_t d : nodes_domains[static_cast<size_t>(c->node(j)->get_id())])
+            {
+                add_domain(cells_domains[i], d);
+            }
+        }
+    }
+}
+
+/// \brief Build halo.
+///
+/// Build lists of ghost cells and far nodes for given process
+/// and lists of own cells and nodes which other processes need.
+/// Also build part of mesh (own and ghost cells, their edges and nodes).
+/// Cells domains must be set.
+///
+/// \param[in] all  All mesh elements.
+/// \param[in] rank Process rank.
+/// \param[in] size Processes count.
+void
+Halo::build(NodesEdgesCellsHolder& all,
+            size_t rank,
+            size_t size)
+{
+    size_t nc { all.nodes_count() }, ec { all.edges_count() }, cc { all.cells_count() };
+
+    clear();
+    send_cells.resize(size);
+    recv_cells.resize(size);
+    send_nodes.resize(size);
+    recv_nodes.resize(size);
+
+    // Domains of incident cells for each node
+    // and domains of cells adjacent by nodes for each cell.
+    vector<size_t> domains(cc);
+    vector<vector<size_t>> nodes_domains, cells_domains;
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        domains[i] = all.cell(i)->get_domain();
+    }
+
+    calc_domains(all, domains, nodes_domains, cells_domains);
+
+    // Cells.
+    // Cell of domain d is ghost for process q != d
+    // if it is adjacent by node with some cell of domain q.
+    vector<bool> is_part_cell(cc, false);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { all.cell(i) };
+        size_t d { c->get_domain() };
+
+        if (d == rank)
+        {
+            is_part_cell[i] = true;
+
+            for (size_t q : cells_domains[i])
+            {
+                if (q != rank)
+                {
+                    send_cells[q].push_back(c);
+                }
+            }
+        }
+        else if (has_domain(cells_domains[i], rank))
+        {
+            is_part_cell[i] = true;
+            recv_cells[d].push_back(c);
+        }
+    }
+
+    // Nodes.
+    // Node is far for process q if there is no incident cell of domain q,
+    // but some incident cell is ghost for q.
+    for (size_t i = 0; i < nc; ++i)
+    {
+        Node* n { all.node(i) };
+        const vector<size_t>& nds { nodes_domains[i] };
+
+        if (nds.empty())
+        {
+            continue;
+        }
+
+        size_t owner { nds.front() };
+        vector<size_t> far_for;
+
+        for (size_t j = 0; j < n->cells_count(); ++j)
+        {
+            for (size_t q : cells_domains[static_cast<size_t>(n->cell(j)->get_id())])
+            {
+                if (!has_domain(nds, q))
+                {
+                    add_domain(far_for, q);
+                }
+            }
+        }
+
+        if (owner == rank)
+        {
+            for (size_t q : far_for)
+            {
+                send_nodes[q].push_back(n);
+            }
+        }
+        else if (has_domain(far_for, rank))
+        {
+            recv_nodes[owner].push_back(n);
+        }
+    }
+
+    // Numbering of objects may differ in processes (for mesh part),
+    // so lists are ordered by original identifiers.
+    for (size_t q = 0; q < size; ++q)
+    {
+        sort(send_cells[q].begin(), send_cells[q].end(), utils::IdsHolder::is_less_by_orig_id);
+        sort(recv_cells[q].begin(), recv_cells[q].end(), utils::IdsHolder::is_less_by_orig_id);
+        sort(send_nodes[q].begin(), send_nodes[q].end(), utils::IdsHolder::is_less_by_orig_id);
+        sort(recv_nodes[q].begin(), recv_nodes[q].end(), utils::IdsHolder::is_less_by_orig_id);
+    }
+
+    // Part of mesh.
+    vector<bool> is_part_node(nc, false), is_part_edge(ec, false);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        if (!is_part_cell[i])
+        {
+            continue;
+        }
+
+        Cell* c { all.cell(i) };
+
+        part.add_cell(c);
+
+        for (size_t j = 0; j < c->nodes_count(); ++j)
+        {
+            is_part_node[static_cast<size_t>(c->node(j)->get_id())] = true;
+        }
+
+        for (size_t j = 0; j < c->edges_count(); ++j)
+        {
+            is_part_edge[static_cast<size_t>(c->edge(j)->get_id())] = true;
+        }
+    }
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        if (is_part_node[i])
+        {
+            part.add_node(all.node(i));
+        }
+    }
+
+    for (size_t i = 0; i < ec; ++i)
+    {
+        if (is_part_edge[i])
+        {
+            part.add_edge(all.edge(i));
+        }
+    }
+
+    // Communicators are allocated for current processes.
+    if (cells_comm.buffers.empty())
+    {
+        cells_comm.allocate();
+        nodes_comm.allocate();
+    }
+
+    is_built_ = true;
+}
+
+/// \brief Clear halo.
+///
+/// Clear lists and part of mesh.
+/// Communicators are kept.
+void
+Halo::clear()
+{
+    send_cells.clear();
+    recv_cells.clear();
+    send_nodes.clear();
+    recv_nodes.clear();
+    part.clear();
+    is_built_ = false;
+}
+
+/// @}
+
+}
+
+}
@@ -0,0 +1,252 @@
+/// \file
+/// \brief Halo of domain.
+///
+/// Halo of domain declaration.
+
+#ifndef CAESAR_MESH_HALO_H
+#define CAESAR_MESH_HALO_H
+
+#include "mesh_node.h"
+#include "mesh_cell.h"
+#include "mesh_nodes_edges_cells_holder.h"
+#include "parl/parl.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Halo of domain.
+///
+/// Ghost cells are cells of other domains which have common nodes with own cells.
+/// Far nodes are nodes of ghost cells which are not nodes of own cells.
+/// Data of ghost cells is received from their domains.
+/// Data of far nodes is received from their owners
+/// (owner of node is minimal domain among domains of its incident cells).
+/// All lists are ordered by original identifiers (by identifiers if they are not set)
+/// in the same way in all processes, so no handshake is needed.
+class Halo
+{
+
+private:
+
+    /// \brief Flag of built halo.
+    bool is_built_ { false };
+
+    /// \brief Own cells to send (for each process).
+    vector<vector<Cell*>> send_cells;
+
+    /// \brief Ghost cells to receive (for each process).
+    vector<vector<Cell*>> recv_cells;
+
+    /// \brief Own nodes to send (for each process).
+    vector<vector<Node*>> send_nodes;
+
+    /// \brief Far nodes to receive (for each process).
+    vector<vector<Node*>> recv_nodes;
+
+    /// \brief Communicator for cells data.
+    parl::AllToAllExchanger cells_comm;
+
+    /// \brief Communicator for nodes data.
+    parl::AllToAllExchanger nodes_comm;
+
+public:
+
+    /// \brief Part of mesh.
+    ///
+    /// Own and ghost cells, their edges and nodes.
+    NodesEdgesCellsHolder part;
+
+    // Default constructor.
+    Halo();
+
+    // Default destructor.
+    ~Halo();
+
+    // Calculate domains around nodes and cells.
+    static void
+    calc_domains(NodesEdgesCellsHolder& all,
+                 const vector<size_t>& domains,
+                 vector<vector<size_t>>& nodes_domains,
+                 vector<vector<size_t>>& cells_domains);
+
+    // Build halo.
+    void
+    build(NodesEdgesCellsHolder& all,
+          size_t rank,
+          size_t size);
+
+    // Clear halo.
+    void
+    clear();
+
+    /// \brief Check if halo is built.
+    ///
+    /// Check if halo is built.
+    ///
+    /// \return
+    /// true - if halo is built,
+    /// false - otherwise.
+    inline bool
+    is_built() const
+    {
+        return is_built_;
+    }
+
+    /// \brief Get own cells to send.
+    ///
+    /// Get own cells to send.
+    ///
+    /// \param[in] i Process.
+    ///
+    /// \return
+    /// Cells.
+    inline const vector<Cell*>&
+    get_send_cells(size_t i) const
+    {
+        return send_cells[i];
+    }
+
+    /// \brief Get ghost cells to receive.
+    ///
+    /// Get ghost cells to receive.
+    ///
+    /// \param[in] i Process.
+    ///
+    /// \return
+    /// Cells.
+    inline const vector<Cell*>&
+    get_recv_cells(size_t i) const
+    {
+        return recv_cells[i];
+    }
+
+    /// \brief Get own nodes to send.
+    ///
+    /// Get own nodes to send.
+    ///
+    /// \param[in] i Process.
+    ///
+    /// \return
+    /// Nodes.
+    inline const vector<Node*>&
+    get_send_nodes(size_t i) const
+    {
+        return send_nodes[i];
+    }
+
+    /// \brief Get far nodes to receive.
+    ///
+    /// Get far nodes to receive.
+    ///
+    /// \param[in] i Process.
+    ///
+    /// \return
+    /// Nodes.
+    inline const vector<Node*>&
+    get_recv_nodes(size_t i) const
+    {
+        return recv_nodes[i];
+    }
+
+    /// \brief Exchange cells data.
+    ///
+    /// Send data of own cells, receive data of ghost cells.
+    ///
+    /// \tparam    TGet  Type of get function.
+    /// \tparam    TSet  Type of set function.
+    /// \param[in] width Count of values of one cell.
+    /// \param[in] get   Function writes cell values to buffer.
+    /// \param[in] set   Function reads cell values from buffer.
+    template<typename TGet, typename TSet>
+    void
+    exchange_cells(size_t width,
+                   TGet get,
+                   TSet set)
+    {
+        exchange(send_cells, recv_cells, cells_comm, width, get, set);
+    }
+
+    /// \brief Exchange nodes data.
+    ///
+    /// Send data of owned nodes, receive data of far nodes.
+    ///
+    /// \tparam    TGet  Type of get function.
+    /// \tparam    TSet  Type of set function.
+    /// \param[in] width Count of values of one node.
+    /// \param[in] get   Function writes node values to buffer.
+    /// \param[in] set   Function reads node values from buffer.
+    template<typename TGet, typename TSet>
+    void
+    exchange_nodes(size_t width,
+                   TGet get,
+                   TSet set)
+    {
+        exchange(send_nodes, recv_nodes, nodes_comm, width, get, set);
+    }
+
+    /// \brief Exchange data.
+    ///
+    /// Objects lists must be built in the same order in sending and receiving processes.
+    /// Buffers sizes for process are maximum of send and receive sizes.
+    ///
+    /// \tparam        T     Type of objects.
+    /// \tparam        TGet  Type of get function.
+    /// \tparam        TSet  Type of set function.
+    /// \param[in]     send  Objects to send.
+    /// \param[in]     recv  Objects to receive.
+    /// \param[in,out] comm  Communicator.
+    /// \param[in]     width Count of values of one object.
+    /// \param[in]     get   Function writes object values to buffer.
+    /// \param[in]     set   Function reads object values from buffer.
+    template<typename T, typename TGet, typename TSet>
+    static void
+    exchange(vector<vector<T*>>& send,
+             vector<vector<T*>>& recv,
+             parl::AllToAllExchanger& comm,
+             size_t width,
+             TGet get,
+             TSet set)
+    {
+        size_t s { send.size() };
+
+        DEBUG_CHECK_ERROR(s == comm.buffers.size(), "lists are built not for current processes");
+
+        for (size_t i = 0; i < s; ++i)
+        {
+            comm.set_size(i, width * max(send[i].size(), recv[i].size()));
+
+            vector<double>& buffer = comm.get_out_data(i);
+
+            for (size_t j = 0; j < send[i].size(); ++j)
+            {
+                get(send[i][j], &buffer[width * j]);
+            }
+        }
+
+        comm.exchange();
+
+        for (size_t i = 0; i < s; ++i)
+        {
+            vector<double>& buffer = comm.get_in_data(i);
+
+            for (size_t j = 0; j < recv[i].size(); ++j)
+            {
+                set(recv[i][j], &buffer[width * j]);
+            }
+        }
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_HALO_H
@@ -228,6 +228,116 @@ Mesh::init_local_identifiers()
     }
 }
 
+//
+// Blocks.
+//
+
+/// \brief Find own blocks in part of mesh.
+///
+/// Elements of part of mesh are in order of all elements (identifiers increase),
+/// so first element of own blocks is found with binary search.
+/// Own blocks are used only if part holds all their elements contiguously.
+///
+/// \tparam     F       Function type.
+/// \param[in]  offsets Offsets of own blocks in all elements.
+/// \param[in]  count   Count of elements in part of mesh.
+/// \param[in]  id      Identifier of element of part of mesh.
+/// \param[out] begin   Index of first element of own blocks in part of mesh.
+///
+/// \return
+/// true - if own blocks are found,
+/// false - otherwise.
+template<typename F>
+static bool
+find_blocks(const vector<size_t>& offsets,
+            size_t count,
+            F id,
+            size_t& begin)
+{
+    if (offsets.size() < 2)
+    {
+        return false;
+    }
+
+    size_t first { offsets.front() }, n { offsets.back() - offsets.front() };
+
+    if ((n == 0) || (n > count))
+    {
+        return false;
+    }
+
+    size_t lo { 0 }, hi { count };
+
+    while (lo < hi)
+    {
+        size_t mid { lo + (hi - lo) / 2 };
+
+        if (id(mid) < first)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if ((lo + n > count) || (id(lo) != first) || (id(lo + n - 1) != first + n - 1))
+    {
+        return false;
+    }
+
+    begin = lo;
+
+    return true;
+}
+
+/// \brief Find own blocks of cells in part of mesh.
+///
+/// Find own blocks of cells in part of mesh (all mesh, own cells or halo part).
+///
+/// \param[in]  h     Part of mesh.
+/// \param[out] begin Index of first cell of own blocks in part of mesh.
+///
+/// \return
+/// Offsets of own blocks in all cells or nullptr if part does not hold them.
+const vector<size_t>*
+Mesh::find_own_cells_blocks(const NodesEdgesCellsHolder& h,
+                            size_t& begin) const
+{
+    const vector<size_t>& offsets { blocks_cells_offsets(parl::mpi_rank()) };
+    auto id = [&h](size_t i)
+    {
+        return static_cast<size_t>(h.cell(i)->get_id());
+    };
+
+    return find_blocks(offsets, h.cells_count(), id, begin) ? &offsets : nullptr;
+}
+
+/// \brief Find own blocks of nodes in part of mesh.
+///
+/// Find own blocks of nodes in part of mesh (all mesh or halo part).
+///
+/// \param[in]  h     Part of mesh.
+/// \param[out] begin Index of first node of own blocks in part of mesh.
+///
+/// \return
+/// Offsets of own blocks in all nodes or nullptr if part does not hold them.
+const vector<size_t>*
+Mesh::find_own_nodes_blocks(const NodesEdgesCellsHolder& h,
+                            size_t& begin) const
+{
+    static const vector<size_t> empty;
+    size_t r = parl::mpi_rank();
+    const vector<size_t>& offsets { (r < blocks_nodes_offsets_.size()) ? blocks_nodes_offsets_[r] : empty };
+    auto id = [&h](size_t i)
+    {
+        return static_cast<size_t>(h.node(i)->get_id());
+    };
+
+    return find_blocks(offsets, h.nodes_count(), id, begin) ? &offsets : nullptr;
+}
+
 /// \brief Register edge's color.
 ///
 /// Set color to the edges.
@@ -271,6 +381,33 @@ Mesh::is_own_edges_colors_distribution_correct() const
     return (cnt == vec_cnt) && (cnt == hist_cnt);
 }
 
+/// \brief Clear own edges colors.
+///
+/// Clear vectors of own edges by colors and colors histogram.
+/// Size of own_edges_by_colors and own_edges_colors_histogram must be constant (issue #39).
+void
+Mesh::clear_own_edges_colors()
+{
+    for (size_t i = 0; i < max_edges_colors_count; ++i)
+    {
+        own_edges_by_colors[i].clear();
+        own_edges_colors_histogram[i] = 0;
+    }
+}
+
+/// \brief Check if all own edges are colored.
+///
+/// Check if own edges are colored and colors distribution is correct.
+///
+/// \return
+/// true - if own edges are colored,
+/// false - otherwise.
+bool
+Mesh::is_own_edges_colored() const
+{
+    return (own.edges_count() > 0) && is_own_edges_colors_distribution_correct();
+}
+
 //
 // Set variables names for mesh storing.
 //
@@ -446,24 +583,116 @@ Mesh::mark_mesh_border_nodes_and_cells()
 // Geometry.
 //
 
+/// \brief Mark self-intersecting cells.
+///
+/// Find all cells which intersect other non-adjacent cells (cells without common nodes).
+/// Such cells are marked with 1, all other cells are marked with 0.
+/// Candidates pairs are found with cells BVH.
+/// If BVH is already built for cells of the mesh it is refitted to current points
+/// (so BVH may be kept between checks while topology of the mesh is not changed),
+/// otherwise it is built.
+///
+/// \param[in,out] bvh Cells BVH.
+///
+/// \return
+/// Count of marked cells.
+size_t
+Mesh::mark_self_intersecting_cells(geom::BVH& bvh)
+{
+    size_t cc { all.cells_count() };
+    size_t marked { 0 };
+
+    if ((bvh.nodes_count() > 0) && (bvh.triangles_count() == cc))
+    {
+        refit_cells_bvh(bvh);
+    }
+    else
+    {
+        build_cells_bvh(bvh);
+    }
+
+    #pragma omp parallel
+    {
+        vector<size_t> candidates;
+
+        #pragma omp for schedule(dynamic, 256) reduction(+:marked)
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { all.cell(i) };
+            bool is_intersect { false };
+
+            bvh.find_triangles_in_box(bvh.triangle_box(i), candidates);
+
+            for (size_t j : candidates)
+            {
+                Cell* nc { all.cell(j) };
+
+                if ((j == i) || c->is_adjacent_by_node(nc))
+                {
+                    continue;
+                }
+
+                if (geom::triangles_intersection(c->node(0)->point(),
+                                                 c->node(1)->point(),
+                                                 c->node(2)->point(),
+                                                 nc->node(0)->point(),
+                                                 nc->node(1)->point(),
+                                                 nc->node(2)->point()))
+                {
+                    is_intersect = true;
+
+                    break;
+                }
+            }
+
+            c->set_mark(is_intersect ? 1 : 0);
+
+            if (is_intersect)
+            {
+                ++marked;
+            }
+        }
+    }
+
+    return marked;
+}
+
+/// \brief Mark self-intersecting cells.
+///
+/// Mark self-intersecting cells with new cells BVH.
+///
+/// \return
+/// Count of marked cells.
+size_t
+Mesh::mark_self_intersecting_cells()
+{
+    geom::BVH bvh;
+
+    return mark_self_intersecting_cells(bvh);
+}
+
 /// \brief Calculate geometry.
 ///
-/// Calculate geometry.
+/// Calculate geometry of edges, cells and nodes of part of mesh.
+/// Nodes normals are calculated after cells normals,
+/// so incident cells of nodes which are not in the part must have actual geometry.
+///
+/// \param[in,out] h Part of mesh.
 void
-Mesh::calc_geometry()
+Mesh::calc_geometry(NodesEdgesCellsHolder& h)
 {
     #pragma omp parallel for
-    for (size_t i = 0; i < all.edges_count(); ++i)
+    for (size_t i = 0; i < h.edges_count(); ++i)
     {
-        Edge* e { all.edge(i) };
+        Edge* e { h.edge(i) };
 
         e->calc_geometry();
     }
 
     #pragma omp parallel for
-    for (size_t i = 0; i < all.cells_count(); ++i)
+    for (size_t i = 0; i < h.cells_count(); ++i)
     {
-        Cell* c { all.cell(i) };
+        Cell* c { h.cell(i) };
 
         c->calc_geometry();
     }
@@ -471,9 +700,9 @@ Mesh::calc_geometry()
     // Normal of node can be calculated only after
     // normals of all incindent cells.
     #pragma omp parallel for
-    for (size_t i = 0; i < all.nodes_count(); ++i)
+    for (size_t i = 0; i < h.nodes_count(); ++i)
     {
-        Node* n { all.node(i) };
+        Node* n { h.node(i) };
 
         n->calc_geometry();
     }
@@ -541,6 +770,221 @@ Mesh::restore_geometry()
     }
 }
 
+/// \brief Get points of all nodes.
+///
+/// Get points of all nodes (index of point is node global identifier).
+///
+/// \param[out] ps Points.
+void
+Mesh::get_nodes_points(vector<geom::Vector>& ps) const
+{
+    size_t nc { all.nodes_count() };
+
+    ps.clear();
+    ps.reserve(nc);
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        ps.push_back(all.node(i)->point());
+    }
+}
+
+/// \brief Set points of all nodes.
+///
+/// Set points of all nodes (index of point is node global identifier).
+/// Geometry is not recalculated.
+///
+/// \param[in] ps Points.
+void
+Mesh::set_nodes_points(const vector<geom::Vector>& ps)
+{
+    size_t nc { all.nodes_count() };
+
+    DEBUG_CHECK_ERROR(ps.size() == nc, "wrong count of points");
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < nc; ++i)
+    {
+        all.node(i)->set_point(ps[i]);
+    }
+}
+
+/// \brief Copy topology of mesh.
+///
+/// Nodes (with their current points), edges and cells of mesh are copied
+/// with all links between them in the same order,
+/// so elements of copy have the same identifiers as elements of mesh.
+/// Data of elements, zones, domains and remesher state are not copied
+/// (elements get data stubs).
+/// Identifiers of mesh elements must be equal to their indices, this mesh must be empty.
+///
+/// \param[in] m Mesh.
+void
+Mesh::copy_topology(const Mesh& m)
+{
+    DEBUG_CHECK_ERROR(all.nodes_count() + all.edges_count() + all.cells_count() == 0,
+                      "topology is copied only into empty mesh");
+
+    size_t nc { m.all.nodes_count() }, ec { m.all.edges_count() }, cc { m.all.cells_count() };
+
+    // Elements.
+    for (size_t i = 0; i < nc; ++i)
+    {
+        const geom::Vector& p { m.all.node(i)->point() };
+        Node* n = new Node(p.x, p.y, p.z);
+
+        n->allocate_data<NodeDataStub>();
+        all.add_node(n);
+    }
+
+    for (size_t i = 0; i < ec; ++i)
+    {
+        Edge* e = new Edge();
+
+        e->allocate_data<EdgeDataStub>();
+        all.add_edge(e);
+    }
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c = new Cell();
+
+        c->allocate_data<CellDataStub>();
+        all.add_cell(c);
+    }
+
+    init_global_identifiers();
+
+    // Links (in the same order as in mesh).
+    auto id = [](const utils::IdsHolder* x)
+    {
+        DEBUG_CHECK_ERROR(x->get_id() >= 0, "wrong identifier");
+
+        return static_cast<size_t>(x->get_id());
+    };
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        const Node* mn { m.all.node(i) };
+        Node* n { all.node(id(mn)) };
+
+        for (size_t j = 0; j < mn->edges_count(); ++j)
+        {
+            n->add_edge(all.edge(id(mn->edge(j))));
+        }
+
+        for (size_t j = 0; j < mn->cells_count(); ++j)
+        {
+            n->add_cell(all.cell(id(mn->cell(j))));
+        }
+    }
+
+    for (size_t i = 0; i < ec; ++i)
+    {
+        const Edge* me { m.all.edge(i) };
+        Edge* e { all.edge(id(me)) };
+
+        for (size_t j = 0; j < me->nodes_count(); ++j)
+        {
+            e->add_node(all.node(id(me->node(j))));
+        }
+
+        for (size_t j = 0; j < me->cells_count(); ++j)
+        {
+            e->add_cell(all.cell(id(me->cell(j))));
+        }
+    }
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        const Cell* mc { m.all.cell(i) };
+        Cell* c { all.cell(id(mc)) };
+
+        for (size_t j = 0; j < mc->nodes_count(); ++j)
+        {
+            c->add_node(all.node(id(mc->node(j))));
+        }
+
+        for (size_t j = 0; j < mc->edges_count(); ++j)
+        {
+            c->add_edge(all.edge(id(mc->edge(j))));
+        }
+    }
+
+    init_cells_neighbourhoods();
+    initial_calc_geometry();
+}
+
+/// \brief Build cells BVH.
+///
+/// Build bounding volume hierarchy over all mesh cells.
+/// Index of triangle in BVH is equal to cell global identifier.
+///
+/// \param[out] bvh Bounding volume hierarchy.
+void
+Mesh::build_cells_bvh(geom::BVH& bvh) const
+{
+    size_t cc { all.cells_count() };
+    vector<geom::Vector> ps;
+    vector<size_t> ts(3 * cc);
+
+    get_nodes_points(ps);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        const Cell* c { all.cell(i) };
+
+        for (size_t j = 0; j < 3; ++j)
+        {
+            ts[3 * i + j] = static_cast<size_t>(c->node(j)->get_id());
+        }
+    }
+
+    bvh.build(ps, ts);
+}
+
+/// \brief Refit cells BVH.
+///
+/// Refit bounding volume hierarchy after nodes moving.
+/// Topology of the mesh must be the same as while building.
+///
+/// \param[in,out] bvh Bounding volume hierarchy.
+void
+Mesh::refit_cells_bvh(geom::BVH& bvh) const
+{
+    vector<geom::Vector> ps;
+
+    get_nodes_points(ps);
+    bvh.refit(ps);
+}
+
+//
+// Data transfers.
+//
+
+/// \brief Set ghost layers for exchanges.
+///
+/// Cells of other domains which are reached from own cells in not more than depth steps
+/// are received in each exchange, so stencils of this depth may be processed
+/// on borders of domains without additional exchanges.
+/// If mesh is already decomposed ghost layers are rebuilt at once,
+/// otherwise they are built after decomposition.
+///
+/// \param[in] depth     Depth of ghost layers.
+/// \param[in] adjacency Adjacency of cells (by edges or by nodes).
+void
+Mesh::set_ghost_layers(size_t depth,
+                       GhostAdjacency adjacency)
+{
+    boundaries.set_ghost_layers(depth, adjacency);
+
+    if (boundaries.is_allocated())
+    {
+        boundaries.build_ghosts(all);
+    }
+}
+
 /// @}
 
 }
@@ -6,9 +6,13 @@
 #ifndef CAESAR_MESH_MESH_H
 #define CAESAR_MESH_MESH_H
 
+#include <omp.h>
+
 #include "utils/utils.h"
 #include "mesh_zone.h"
 #include "mesh_boundaries.h"
+#include "mesh_halo.h"
+#include "mesh_patches.h"
 #include "mesh_nodes_edges_cells_holder.h"
 #include "mesh_node_data_stub.h"
 #include "mesh_edge_data_stub.h"
@@ -30,6 +34,8 @@ class Mesh
 {
     friend class Remesher;
     friend class Decomposer;
+    friend class Topology;
+    friend class Ensemble;
 
 private:
 
@@ -76,9 +82,57 @@ private:
     /// \brief Information about borders.
     Boundaries boundaries;
 
+    /// \brief Halo of own domain (ghost cells and far nodes).
+    Halo halo;
+
+    /// \brief Patches for smoothing.
+    Patches patches;
+
+    /// \brief Flag of mesh part loaded from domain file.
+    ///
+    /// Part holds only own cells of process and several layers of ghost cells.
+    bool is_domain_part_ { false };
+
+    /// \brief Count of blocks of domain cells (0 if cells are not split into blocks).
+    size_t blocks_count_ { 0 };
+
+    /// \brief Offsets of blocks of domains cells in all cells.
+    ///
+    /// Blocks count + 1 offsets for each domain (empty for domain which is not split).
+    vector<vector<size_t>> blocks_cells_offsets_;
+
+    /// \brief Offsets of blocks of domains nodes in all nodes.
+    ///
+    /// Node belongs to block of its first cell.
+    vector<vector<size_t>> blocks_nodes_offsets_;
+
+    /// \brief Count of ensembles over mesh.
+    ///
+    /// Ensembles hold data indexed with identifiers of mesh elements,
+    /// so elements can not be renumbered while ensembles exist.
+    size_t ensembles_count_ { 0 };
+
     /// \brief Data gatherrer.
     parl::OneToAllExchanger gatherer;
 
+    /// \brief Copy node data (for nodes created while topology changes).
+    void (*copy_node_data)(Node* to, const Node* from) { nullptr };
+
+    /// \brief Copy edge data (for edges created while topology changes).
+    void (*copy_edge_data)(Edge* to, const Edge* from) { nullptr };
+
+    /// \brief Copy cell data (for cells created while topology changes).
+    void (*copy_cell_data)(Cell* to, const Cell* from) { nullptr };
+
+    /// \brief Free node data (for nodes removed while topology changes).
+    void (*free_node_data)(Node* n) { nullptr };
+
+    /// \brief Free edge data (for edges removed while topology changes).
+    void (*free_edge_data)(Edge* e) { nullptr };
+
+    /// \brief Free cell data (for cells removed while topology changes).
+    void (*free_cell_data)(Cell* c) { nullptr };
+
 public:
 
     //
@@ -136,6 +190,65 @@ public:
     // Free data.
     //
 
+private:
+
+    /// \brief Copy data of object.
+    ///
+    /// Allocate data for object and copy data from another object.
+    ///
+    /// \tparam     T     Type of object.
+    /// \tparam     TData Type of data.
+    /// \param[out] to    Object to copy data to.
+    /// \param[in]  from  Object to copy data from.
+    template<typename T,
+             typename TData>
+    static void
+    copy_object_data(T* to,
+                     const T* from)
+    {
+        to->template allocate_data<TData>();
+        *(to->template get_data<TData>()) = *(from->template get_data<TData>());
+    }
+
+    /// \brief Free data of object.
+    ///
+    /// Free data of object if it is not null.
+    ///
+    /// \tparam        T     Type of object.
+    /// \tparam        TData Type of data.
+    /// \param[in,out] x     Object.
+    template<typename T,
+             typename TData>
+    static void
+    free_object_data(T* x)
+    {
+        x->template free_data_if_not_null<TData>();
+    }
+
+public:
+
+    /// \brief Set types of data.
+    ///
+    /// Remember types of nodes, edges and cells data,
+    /// so topology changes can create and remove objects with data.
+    ///
+    /// \tparam TNodeData Node data type.
+    /// \tparam TEdgeData Edge data type.
+    /// \tparam TCellData Cell data type.
+    template<typename TNodeData,
+             typename TEdgeData,
+             typename TCellData>
+    void
+    set_data_types()
+    {
+        copy_node_data = &copy_object_data<Node, TNodeData>;
+        copy_edge_data = &copy_object_data<Edge, TEdgeData>;
+        copy_cell_data = &copy_object_data<Cell, TCellData>;
+        free_node_data = &free_object_data<Node, TNodeData>;
+        free_edge_data = &free_object_data<Edge, TEdgeData>;
+        free_cell_data = &free_object_data<Cell, TCellData>;
+    }
+
 private:
 
     /// \brief Free data if not null.
@@ -235,16 +348,15 @@ public:
         all.clear();
         own.clear();
 
-        // issue #39
-        // Do not clear own edges by colors vector and histogram.
-        // Size of own_edges_by_colors and own_edges_colors_histogram must be constant.
-        for (size_t i = 0; i < max_edges_colors_count; ++i)
-        {
-            own_edges_by_colors[i].clear();
-            own_edges_colors_histogram[i] = 0;
-        }
+        clear_own_edges_colors();
 
         domains_cells.clear();
+        halo.clear();
+        patches.clear();
+        is_domain_part_ = false;
+        blocks_count_ = 0;
+        blocks_cells_offsets_.clear();
+        blocks_nodes_offsets_.clear();
     }
 
     /// \brief Clear mesh.
@@ -304,6 +416,166 @@ public:
         return zones.size();
     }
 
+    /// \brief Check if mesh is part loaded from domain file.
+    ///
+    /// Check if mesh is part loaded from domain file.
+    ///
+    /// \return
+    /// true - if mesh is part of whole mesh loaded from domain file,
+    /// false - otherwise.
+    inline bool
+    is_domain_part() const
+    {
+        return is_domain_part_;
+    }
+
+    /// \brief Get count of blocks of domain cells.
+    ///
+    /// Get count of blocks of domain cells.
+    ///
+    /// \return
+    /// Count of blocks (0 if cells are not split into blocks).
+    inline size_t
+    blocks_count() const
+    {
+        return blocks_count_;
+    }
+
+    /// \brief Get offsets of blocks of domain cells.
+    ///
+    /// Get offsets of blocks of domain cells in all cells
+    /// (block b holds cells from offsets[b] to offsets[b + 1]).
+    ///
+    /// \param[in] d Domain.
+    ///
+    /// \return
+    /// Offsets (empty if domain is not split into blocks).
+    inline const vector<size_t>&
+    blocks_cells_offsets(size_t d) const
+    {
+        static const vector<size_t> empty;
+
+        return (d < blocks_cells_offsets_.size()) ? blocks_cells_offsets_[d] : empty;
+    }
+
+    // Find own blocks of cells in part of mesh.
+    const vector<size_t>*
+    find_own_cells_blocks(const NodesEdgesCellsHolder& h,
+                          size_t& begin) const;
+
+    // Find own blocks of nodes in part of mesh.
+    const vector<size_t>*
+    find_own_nodes_blocks(const NodesEdgesCellsHolder& h,
+                          size_t& begin) const;
+
+private:
+
+    /// \brief Process elements by own blocks.
+    ///
+    /// Thread with number t processes blocks t, t + threads count, ...
+    /// (block t if there are as many threads as blocks),
+    /// elements outside of own blocks (ghost elements) are processed with static schedule.
+    /// If there are no own blocks in part of mesh all elements are processed with static schedule.
+    ///
+    /// \tparam    F       Function type.
+    /// \param[in] count   Count of elements in part of mesh.
+    /// \param[in] offsets Offsets of own blocks or nullptr.
+    /// \param[in] begin   Index of first element of own blocks in part of mesh.
+    /// \param[in] f       Function for element processing (gets index of element in part of mesh).
+    template<typename F>
+    static void
+    for_each_by_blocks(size_t count,
+                       const vector<size_t>* offsets,
+                       size_t begin,
+                       F f)
+    {
+        if (offsets == nullptr)
+        {
+            #pragma omp parallel for
+            for (size_t i = 0; i < count; ++i)
+            {
+                f(i);
+            }
+
+            return;
+        }
+
+        const vector<size_t>& offs { *offsets };
+        size_t bn { offs.size() - 1 };
+        size_t end { begin + offs[bn] - offs[0] };
+
+        #pragma omp parallel
+        {
+            size_t t { static_cast<size_t>(omp_get_thread_num()) };
+            size_t nt { static_cast<size_t>(omp_get_num_threads()) };
+
+            for (size_t b = t; b < bn; b += nt)
+            {
+                size_t lo { begin + offs[b] - offs[0] }, hi { begin + offs[b + 1] - offs[0] };
+
+                for (size_t i = lo; i < hi; ++i)
+                {
+                    f(i);
+                }
+            }
+
+            // Elements outside of own blocks.
+            #pragma omp for nowait
+            for (size_t i = 0; i < begin; ++i)
+            {
+                f(i);
+            }
+
+            #pragma omp for nowait
+            for (size_t i = end; i < count; ++i)
+            {
+                f(i);
+            }
+        }
+    }
+
+public:
+
+    /// \brief Process cells of part of mesh by own blocks.
+    ///
+    /// Each thread processes cells of its own block,
+    /// so threads work with compact parts of domain.
+    /// Cells must be processed independently.
+    ///
+    /// \tparam    F Function type.
+    /// \param[in] h Part of mesh.
+    /// \param[in] f Function for cell processing (gets index of cell in part of mesh).
+    template<typename F>
+    void
+    for_each_cell_by_blocks(const NodesEdgesCellsHolder& h,
+                            F f) const
+    {
+        size_t begin { 0 };
+        const vector<size_t>* offsets { find_own_cells_blocks(h, begin) };
+
+        for_each_by_blocks(h.cells_count(), offsets, begin, f);
+    }
+
+    /// \brief Process nodes of part of mesh by own blocks.
+    ///
+    /// Each thread processes nodes of its own block,
+    /// so threads work with compact parts of domain.
+    /// Nodes must be processed independently.
+    ///
+    /// \tparam    F Function type.
+    /// \param[in] h Part of mesh.
+    /// \param[in] f Function for node processing (gets index of node in part of mesh).
+    template<typename F>
+    void
+    for_each_node_by_blocks(const NodesEdgesCellsHolder& h,
+                            F f) const
+    {
+        size_t begin { 0 };
+        const vector<size_t>* offsets { find_own_nodes_blocks(h, begin) };
+
+        for_each_by_blocks(h.nodes_count(), offsets, begin, f);
+    }
+
     /// \brief Get mean data of cells around the node.
     ///
     /// Get mean data of cells around the node.
@@ -365,6 +637,42 @@ public:
     bool
     is_own_edges_colors_distribution_correct() const;
 
+    // Clear own edges colors.
+    void
+    clear_own_edges_colors();
+
+    // Check if all own edges are colored.
+    bool
+    is_own_edges_colored() const;
+
+    /// \brief Process own edges color by color.
+    ///
+    /// Colors are processed one after another,
+    /// edges of one color are processed in parallel.
+    /// Edges of one color do not share cells,
+    /// so function may write to both incident cells without atomics.
+    ///
+    /// \tparam    F Function type.
+    /// \param[in] f Function for edge processing.
+    template<typename F>
+    void
+    for_each_edge_colored(F f)
+    {
+        DEBUG_CHECK_ERROR(is_own_edges_colored(), "own edges are not colored");
+
+        for (size_t ci = 0; ci < max_edges_colors_count; ++ci)
+        {
+            vector<Edge*>& es { own_edges_by_colors[ci] };
+            size_t ec { es.size() };
+
+            #pragma omp parallel for
+            for (size_t i = 0; i < ec; ++i)
+            {
+                f(es[i]);
+            }
+        }
+    }
+
     //
     // Set variables names for mesh storing.
     //
@@ -455,13 +763,30 @@ public:
     void
     mark_mesh_border_nodes_and_cells();
 
+    // Mark self-intersecting cells.
+    size_t
+    mark_self_intersecting_cells(geom::BVH& bvh);
+
+    // Mark self-intersecting cells.
+    size_t
+    mark_self_intersecting_cells();
+
     //
     // Geometry.
     //
 
     // Calculate geometry.
     void
-    calc_geometry();
+    calc_geometry(NodesEdgesCellsHolder& h);
+
+    /// \brief Calculate geometry.
+    ///
+    /// Calculate geometry of all mesh objects.
+    inline void
+    calc_geometry()
+    {
+        calc_geometry(all);
+    }
 
     // Save geometry.
     void
@@ -471,6 +796,30 @@ public:
     void
     restore_geometry();
 
+    //
+    // Search structures.
+    //
+
+    // Get points of all nodes.
+    void
+    get_nodes_points(vector<geom::Vector>& ps) const;
+
+    // Set points of all nodes.
+    void
+    set_nodes_points(const vector<geom::Vector>& ps);
+
+    // Copy topology of mesh.
+    void
+    copy_topology(const Mesh& m);
+
+    // Build cells BVH.
+    void
+    build_cells_bvh(geom::BVH& bvh) const;
+
+    // Refit cells BVH.
+    void
+    refit_cells_bvh(geom::BVH& bvh) const;
+
     //
     // Layers.
     //
@@ -692,6 +1041,25 @@ public:
     // Data transfers.
     //
 
+    // Set ghost layers for exchanges.
+    void
+    set_ghost_layers(size_t depth,
+                     GhostAdjacency adjacency);
+
+    /// \brief Get count of ghost cells received from neighbour domain.
+    ///
+    /// Get count of ghost cells received from neighbour domain.
+    ///
+    /// \param[in] neighbour_domain Neighbour domain.
+    ///
+    /// \return
+    /// Count of ghost cells.
+    inline size_t
+    ghost_cells_count(size_t neighbour_domain) const
+    {
+        return boundaries.ghost_cells_count(neighbour_domain);
+    }
+
     /// \brief Exchanges of data.
     ///
     /// Data exchnages through boundaries.
@@ -0,0 +1,205 @@
+/// \file
+/// \brief Migrator of cells between domains.
+///
+/// Migrator of cells between domains implementation.
+
+#include "mesh_migrator.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Domains of halo parts which hold nodes.
+///
+/// Node is in halo part of domain if some its incident cell is in it.
+///
+/// \param[in]  all           All mesh elements.
+/// \param[in]  cells_domains Domains around cells.
+/// \param[out] nodes_parts   Sorted domains of halo parts for each node.
+static void
+calc_nodes_parts(NodesEdgesCellsHolder& all,
+                 const vector<vector<size_t>>& cells_domains,
+                 vector<vector<size_t>>& nodes_parts)
+{
+    size_t nc { all.nodes_count() };
+
+    nodes_parts.assign(nc, vector<size_t>());
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        Node* n { all.node(i) };
+        vector<size_t>& ps { nodes_parts[i] };
+
+        for (size_t j = 0; j < n->cells_count(); ++j)
+        {
+            const vector<size_t>& cds { cells_domains[static_cast<size_t>(n->cell(j)->get_id())] };
+
+            ps.insert(ps.end(), cds.begin(), cds.end());
+        }
+
+        sort(ps.begin(), ps.end());
+        ps.erase(unique(ps.begin(), ps.end()), ps.end());
+    }
+}
+
+/// \brief Default constructor.
+///
+/// Default constructor.
+Migrator::Migrator()
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+Migrator::~Migrator()
+{
+}
+
+/// \brief Build migration lists.
+///
+/// Cell (node) is sent to process if it is in new halo part of process,
+/// but it is not in its old halo part.
+/// New domains must be already set to cells.
+///
+/// \param[in] all         All mesh elements.
+/// \param[in] old_domains Old domains of cells.
+/// \param[in] rank        Process rank.
+/// \param[in] size        Processes count.
+void
+Migrator::build(NodesEdgesCellsHolder& all,
+                const vector<size_t>& old_domains,
+                size_t rank,
+                size_t size)
+{
+    size_t nc { all.nodes_count() }, cc { all.cells_count() };
+    vector<size_t> new_domains(cc);
+    vector<vector<size_t>> old_nodes_domains, old_cells_domains, new_nodes_domains, new_cells_domains;
+    vector<vector<size_t>> old_nodes_parts, new_nodes_parts;
+
+    send_cells.assign(size, vector<Cell*>());
+    recv_cells.assign(size, vector<Cell*>());
+    send_nodes.assign(size, vector<Node*>());
+    recv_nodes.assign(size, vector<Node*>());
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        new_domains[i] = all.cell(i)->get_domain();
+    }
+
+    Halo::calc_domains(all, old_domains, old_nodes_domains, old_cells_domains);
+    Halo::calc_domains(all, new_domains, new_nodes_domains, new_cells_domains);
+
+    // Cells.
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { all.cell(i) };
+        size_t from { old_domains[i] };
+
+        for (size_t q : new_cells_domains[i])
+        {
+            if (binary_search(old_cells_domains[i].begin(), old_cells_domains[i].end(), q))
+            {
+                continue;
+            }
+
+            if (from == rank)
+            {
+                send_cells[q].push_back(c);
+            }
+            else if (q == rank)
+            {
+                recv_cells[from].push_back(c);
+            }
+        }
+    }
+
+    // Nodes.
+    calc_nodes_parts(all, old_cells_domains, old_nodes_parts);
+    calc_nodes_parts(all, new_cells_domains, new_nodes_parts);
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        Node* n { all.node(i) };
+
+        if (old_nodes_domains[i].empty())
+        {
+            continue;
+        }
+
+        size_t from { old_nodes_domains[i].front() };
+
+        for (size_t q : new_nodes_parts[i])
+        {
+            if (binary_search(old_nodes_parts[i].begin(), old_nodes_parts[i].end(), q))
+            {
+                continue;
+            }
+
+            if (from == rank)
+            {
+                send_nodes[q].push_back(n);
+            }
+            else if (q == rank)
+            {
+                recv_nodes[from].push_back(n);
+            }
+        }
+    }
+
+    // Communicators are allocated for current processes.
+    if (cells_comm.buffers.empty())
+    {
+        cells_comm.allocate();
+        nodes_comm.allocate();
+    }
+}
+
+/// \brief Count of cells to send.
+///
+/// Count of cells to send to all processes.
+///
+/// \return
+/// Count of cells.
+size_t
+Migrator::send_cells_count() const
+{
+    size_t cnt { 0 };
+
+    for (const vector<Cell*>& cs : send_cells)
+    {
+        cnt += cs.size();
+    }
+
+    return cnt;
+}
+
+/// \brief Count of nodes to send.
+///
+/// Count of nodes to send to all processes.
+///
+/// \return
+/// Count of nodes.
+size_t
+Migrator::send_nodes_count() const
+{
+    size_t cnt { 0 };
+
+    for (const vector<Node*>& ns : send_nodes)
+    {
+        cnt += ns.size();
+    }
+
+    return cnt;
+}
+
+/// @}
+
+}
+
+}
@@ -0,0 +1,117 @@
+/// \file
+/// \brief Migrator of cells between domains.
+///
+/// Migrator of cells between domains declaration.
+
+#ifndef CAESAR_MESH_MIGRATOR_H
+#define CAESAR_MESH_MIGRATOR_H
+
+#include "mesh_halo.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Migrator of cells between domains.
+///
+/// When domains of cells are changed, each process needs actual data of cells and nodes
+/// of its new halo part which were not in its old halo part.
+/// Data of cell is sent by its old domain.
+/// Data of node is sent by its old owner (minimal old domain among domains of its incident cells).
+/// All lists are built from replicated mesh in the same order in all processes,
+/// so no handshake is needed.
+class Migrator
+{
+
+private:
+
+    /// \brief Cells to send (for each process).
+    vector<vector<Cell*>> send_cells;
+
+    /// \brief Cells to receive (for each process).
+    vector<vector<Cell*>> recv_cells;
+
+    /// \brief Nodes to send (for each process).
+    vector<vector<Node*>> send_nodes;
+
+    /// \brief Nodes to receive (for each process).
+    vector<vector<Node*>> recv_nodes;
+
+    /// \brief Communicator for cells data.
+    parl::AllToAllExchanger cells_comm;
+
+    /// \brief Communicator for nodes data.
+    parl::AllToAllExchanger nodes_comm;
+
+public:
+
+    // Default constructor.
+    Migrator();
+
+    // Default destructor.
+    ~Migrator();
+
+    // Build migration lists.
+    void
+    build(NodesEdgesCellsHolder& all,
+          const vector<size_t>& old_domains,
+          size_t rank,
+          size_t size);
+
+    // Count of cells to send.
+    size_t
+    send_cells_count() const;
+
+    // Count of nodes to send.
+    size_t
+    send_nodes_count() const;
+
+    /// \brief Exchange cells data.
+    ///
+    /// Send data of cells from old domain, receive data of new cells of halo part.
+    ///
+    /// \tparam    TGet  Type of get function.
+    /// \tparam    TSet  Type of set function.
+    /// \param[in] width Count of values of one cell.
+    /// \param[in] get   Function writes cell values to buffer.
+    /// \param[in] set   Function reads cell values from buffer.
+    template<typename TGet, typename TSet>
+    void
+    exchange_cells(size_t width,
+                   TGet get,
+                   TSet set)
+    {
+        Halo::exchange(send_cells, recv_cells, cells_comm, width, get, set);
+    }
+
+    /// \brief Exchange nodes data.
+    ///
+    /// Send data of nodes from old owner, receive data of new nodes of halo part.
+    ///
+    /// \tparam    TGet  Type of get function.
+    /// \tparam    TSet  Type of set function.
+    /// \param[in] width Count of values of one node.
+    /// \param[in] get   Function writes node values to buffer.
+    /// \param[in] set   Function reads node values from buffer.
+    template<typename TGet, typename TSet>
+    void
+    exchange_nodes(size_t width,
+                   TGet get,
+                   TSet set)
+    {
+        Halo::exchange(send_nodes, recv_nodes, nodes_comm, width, get, set);
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_MIGRATOR_H
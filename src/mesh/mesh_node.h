@@ -257,7 +257,8 @@ public:
                 break;
 
             case NodeElement::NodeId:
-                DEBUG_ERROR("unable to set node data element " + mapper.name(ne));
+                // Identifier from file is original one.
+                set_orig_id(static_cast<int>(v));
                 break;
 
             default:
@@ -322,6 +323,17 @@ public:
         point_.add(v);
     }
 
+    /// \brief Set point.
+    ///
+    /// Set point.
+    ///
+    /// \param[in] p Point.
+    inline void
+    set_point(const geom::Vector& p)
+    {
+        point_.set(p);
+    }
+
 private:
 
     // Calculate normal.
@@ -9,6 +9,7 @@
 #include "mesh_nodes_holder.h"
 #include "mesh_edges_holder.h"
 #include "mesh_cells_holder.h"
+#include "mesh_cells_batch.h"
 
 namespace caesar
 {
@@ -22,6 +23,7 @@ namespace mesh
 /// \brief Nodes, edges, cells holder.
 ///
 /// Class that holds all objects - nodes, edges, cells.
+/// Holder also keeps buffers of batch kernels over its cells.
 class NodesEdgesCellsHolder
     : public NodesHolder,
       public EdgesHolder,
@@ -30,6 +32,9 @@ class NodesEdgesCellsHolder
 
 public:
 
+    /// \brief Buffers of batch kernels over cells.
+    CellsBatch batch;
+
     /// \brief Clear all elements.
     ///
     /// Clear all elements.
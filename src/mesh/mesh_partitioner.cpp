@@ -0,0 +1,1378 @@
+/// \file
+/// \brief Graph partitioner.
+///
+/// Multilevel graph partitioner implementation.
+
+#include "mesh_partitioner.h"
+
+#include <queue>
+
+#include "mesh_edge.h"
+#include "mesh_cell.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief No vertex.
+static const size_t npos { static_cast<size_t>(-1) };
+
+/// \brief Total weight of vertices.
+///
+/// Total weight of vertices.
+///
+/// \return
+/// Total weight.
+size_t
+PartitionGraph::total_weight() const
+{
+    size_t w { 0 };
+
+    for (size_t x : weights)
+    {
+        w += x;
+    }
+
+    return w;
+}
+
+/// \brief Deterministic permutation of vertices.
+///
+/// Fisher-Yates shuffle with xorshift generator with fixed seed,
+/// so all processes get the same permutation.
+///
+/// \param[in]  n     Vertices count.
+/// \param[out] order Permutation.
+static void
+deterministic_permutation(size_t n,
+                          vector<size_t>& order)
+{
+    uint64_t x { 88172645463325252ULL };
+
+    order.resize(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        order[i] = i;
+    }
+
+    for (size_t i = n; i > 1; --i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        swap(order[i - 1], order[static_cast<size_t>(x % static_cast<uint64_t>(i))]);
+    }
+}
+
+/// \brief Coarsen graph with heavy edge matching.
+///
+/// Vertices are visited in pseudorandom order,
+/// each unmatched vertex is matched with unmatched neighbour with the heaviest link.
+/// Matched pairs become vertices of coarse graph.
+///
+/// \param[in]  g          Graph.
+/// \param[in]  max_weight Maximum weight of coarse vertex.
+/// \param[out] cg         Coarse graph.
+/// \param[out] cmap       Map from vertices of graph to vertices of coarse graph.
+void
+Partitioner::coarsen(const PartitionGraph& g,
+                     size_t max_weight,
+                     PartitionGraph& cg,
+                     vector<size_t>& cmap)
+{
+    size_t n { g.vertices_count() };
+    vector<size_t> order, match(n, npos);
+
+    deterministic_permutation(n, order);
+
+    // Heavy edge matching.
+    for (size_t v : order)
+    {
+        if (match[v] != npos)
+        {
+            continue;
+        }
+
+        size_t best { v }, best_w { 0 };
+
+        for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            size_t u { g.adj[k] };
+
+            if ((match[u] == npos) && (u != v)
+                && (g.weights[v] + g.weights[u] <= max_weight)
+                && (g.adj_weights[k] > best_w))
+            {
+                best = u;
+                best_w = g.adj_weights[k];
+            }
+        }
+
+        match[v] = best;
+        match[best] = v;
+    }
+
+    // Numbers of coarse vertices.
+    vector<size_t> reps;
+
+    cmap.assign(n, npos);
+
+    for (size_t v = 0; v < n; ++v)
+    {
+        if (cmap[v] == npos)
+        {
+            cmap[v] = reps.size();
+            cmap[match[v]] = reps.size();
+            reps.push_back(v);
+        }
+    }
+
+    // Coarse graph.
+    size_t cn { reps.size() };
+    vector<size_t> pos(cn, npos);
+
+    cg.offsets.assign(1, 0);
+    cg.adj.clear();
+    cg.adj_weights.clear();
+    cg.weights.assign(cn, 0);
+
+    for (size_t c = 0; c < cn; ++c)
+    {
+        size_t start { cg.adj.size() };
+        size_t fs[2] { reps[c], match[reps[c]] };
+
+        for (size_t fi = 0; fi < ((fs[0] == fs[1]) ? 1 : 2); ++fi)
+        {
+            size_t f { fs[fi] };
+
+            cg.weights[c] += g.weights[f];
+
+            for (size_t k = g.offsets[f]; k < g.offsets[f + 1]; ++k)
+            {
+                size_t cu { cmap[g.adj[k]] };
+
+                if (cu == c)
+                {
+                    continue;
+                }
+
+                if ((pos[cu] != npos) && (pos[cu] >= start))
+                {
+                    cg.adj_weights[pos[cu]] += g.adj_weights[k];
+                }
+                else
+                {
+                    pos[cu] = cg.adj.size();
+                    cg.adj.push_back(cu);
+                    cg.adj_weights.push_back(g.adj_weights[k]);
+                }
+            }
+        }
+
+        cg.offsets.push_back(cg.adj.size());
+    }
+}
+
+/// \brief Bisect set of vertices with greedy graph growing.
+///
+/// Region is grown from pseudo-peripheral vertex of the set,
+/// vertex with the heaviest links to region is added first,
+/// until region takes its part of weight.
+/// Then both halves are bisected recursively.
+/// All vertices of the set must have first_part number in parts.
+///
+/// \param[in]     g          Graph.
+/// \param[in]     vs         Set of vertices.
+/// \param[in]     first_part First part number for the set.
+/// \param[in]     dn         Parts count for the set.
+/// \param[in,out] parts      Parts of vertices.
+void
+Partitioner::bisect(const PartitionGraph& g,
+                    const vector<size_t>& vs,
+                    size_t first_part,
+                    size_t dn,
+                    vector<size_t>& parts)
+{
+    if ((dn == 1) || vs.empty())
+    {
+        return;
+    }
+
+    size_t dn1 { dn / 2 };
+    size_t second_part { first_part + dn1 };
+    size_t total { 0 };
+
+    // All vertices go to the second half, then region of the first half is grown.
+    for (size_t v : vs)
+    {
+        parts[v] = second_part;
+        total += g.weights[v];
+    }
+
+    size_t target { total * dn1 / dn };
+
+    // Pseudo-peripheral vertex: the last reached one in breadth first search.
+    size_t seed { vs[0] };
+
+    for (size_t t = 0; t < 2; ++t)
+    {
+        vector<size_t> q { seed };
+
+        parts[seed] = npos;
+
+        for (size_t head = 0; head < q.size(); ++head)
+        {
+            size_t v { q[head] };
+
+            for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+            {
+                size_t u { g.adj[k] };
+
+                if (parts[u] == second_part)
+                {
+                    parts[u] = npos;
+                    q.push_back(u);
+                }
+            }
+        }
+
+        for (size_t v : q)
+        {
+            parts[v] = second_part;
+        }
+
+        seed = q.back();
+    }
+
+    // Grow region.
+    vector<size_t> gains(g.vertices_count(), 0);
+    priority_queue<pair<size_t, size_t>> front;
+    size_t w { 0 }, next { 0 };
+
+    front.push(make_pair(0, seed));
+
+    while (w < target)
+    {
+        size_t v { npos };
+
+        // The heaviest linked vertex (old records are skipped).
+        while (!front.empty())
+        {
+            pair<size_t, size_t> top { front.top() };
+
+            front.pop();
+
+            if ((parts[top.second] == second_part) && (top.first == gains[top.second]))
+            {
+                v = top.second;
+                break;
+            }
+        }
+
+        // Another connected component.
+        if (v == npos)
+        {
+            while ((next < vs.size()) && (parts[vs[next]] != second_part))
+            {
+                ++next;
+            }
+
+            if (next == vs.size())
+            {
+                break;
+            }
+
+            v = vs[next];
+        }
+
+        // Stop if weight is closer to target without vertex.
+        if ((w > 0) && (w + g.weights[v] > target) && (w + g.weights[v] - target > target - w))
+        {
+            break;
+        }
+
+        parts[v] = first_part;
+        w += g.weights[v];
+
+        for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            size_t u { g.adj[k] };
+
+            if (parts[u] == second_part)
+            {
+                gains[u] += g.adj_weights[k];
+                front.push(make_pair(gains[u], u));
+            }
+        }
+    }
+
+    // Recursive bisection of halves.
+    vector<size_t> vs1, vs2;
+
+    for (size_t v : vs)
+    {
+        if (parts[v] == first_part)
+        {
+            vs1.push_back(v);
+        }
+        else
+        {
+            vs2.push_back(v);
+        }
+    }
+
+    bisect(g, vs1, first_part, dn1, parts);
+    bisect(g, vs2, second_part, dn - dn1, parts);
+}
+
+/// \brief Initial partition.
+///
+/// Initial partition with recursive bisection.
+///
+/// \param[in]  g     Graph.
+/// \param[in]  dn    Parts count.
+/// \param[out] parts Parts of vertices.
+void
+Partitioner::initial_partition(const PartitionGraph& g,
+                               size_t dn,
+                               vector<size_t>& parts)
+{
+    size_t n { g.vertices_count() };
+    vector<size_t> vs(n);
+
+    parts.assign(n, 0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        vs[i] = i;
+    }
+
+    bisect(g, vs, 0, dn, parts);
+}
+
+/// \brief Refine partition.
+///
+/// Greedy refinement of boundary vertices.
+/// Vertex is moved to neighbour part if edge cut decreases (or does not change
+/// but balance becomes better) and weight of part does not exceed permitted one.
+/// Vertices of overweighted parts are moved even if edge cut increases.
+/// Parts are never emptied.
+///
+/// \param[in]     g         Graph.
+/// \param[in]     dn        Parts count.
+/// \param[in]     imbalance Permitted ratio of part weight to average weight.
+/// \param[in,out] parts     Parts of vertices.
+void
+Partitioner::refine(const PartitionGraph& g,
+                    size_t dn,
+                    double imbalance,
+                    vector<size_t>& parts)
+{
+    const size_t max_passes { 8 };
+    size_t n { g.vertices_count() };
+    size_t total { g.total_weight() }, max_vw { 0 };
+    vector<size_t> pw(dn, 0);
+
+    for (size_t v = 0; v < n; ++v)
+    {
+        pw[parts[v]] += g.weights[v];
+        max_vw = max(max_vw, g.weights[v]);
+    }
+
+    // Heavy coarse vertices can not be balanced precisely.
+    double avg { static_cast<double>(total) / static_cast<double>(dn) };
+    size_t max_pw { max(static_cast<size_t>(imbalance * avg), static_cast<size_t>(avg) + max_vw) };
+    vector<size_t> conn(dn, 0), touched;
+
+    for (size_t pass = 0; pass < max_passes; ++pass)
+    {
+        size_t moved { 0 };
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            size_t p { parts[v] }, vw { g.weights[v] };
+
+            touched.clear();
+
+            for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+            {
+                size_t q { parts[g.adj[k]] };
+
+                if (conn[q] == 0)
+                {
+                    touched.push_back(q);
+                }
+
+                conn[q] += g.adj_weights[k];
+            }
+
+            bool is_over { pw[p] > max_pw };
+            long long in { static_cast<long long>(conn[p]) };
+            size_t best { p };
+            long long best_gain { 0 };
+
+            if (pw[p] > vw)
+            {
+                for (size_t q : touched)
+                {
+                    if ((q == p) || (pw[q] + vw > max_pw))
+                    {
+                        continue;
+                    }
+
+                    long long gain { static_cast<long long>(conn[q]) - in };
+                    bool is_better { false };
+
+                    if (best == p)
+                    {
+                        is_better = (gain > 0) || ((gain == 0) && (pw[q] + vw < pw[p])) || is_over;
+                    }
+                    else
+                    {
+                        is_better = (gain > best_gain) || ((gain == best_gain) && (pw[q] < pw[best]));
+                    }
+
+                    if (is_better)
+                    {
+                        best = q;
+                        best_gain = gain;
+                    }
+                }
+            }
+
+            for (size_t q : touched)
+            {
+                conn[q] = 0;
+            }
+
+            if (best != p)
+            {
+                parts[v] = best;
+                pw[p] -= vw;
+                pw[best] += vw;
+                ++moved;
+            }
+        }
+
+        if (moved == 0)
+        {
+            break;
+        }
+    }
+}
+
+/// \brief Gain buckets.
+///
+/// Vertices are kept in doubly linked lists by their keys,
+/// so insertion, removal and extraction of vertex with maximum key are cheap.
+class GainBuckets
+{
+
+private:
+
+    /// \brief Minimum key.
+    long long min_key;
+
+    /// \brief First vertices of buckets.
+    vector<size_t> heads;
+
+    /// \brief Next vertices in buckets.
+    vector<size_t> next;
+
+    /// \brief Previous vertices in buckets.
+    vector<size_t> prev;
+
+    /// \brief Keys of vertices.
+    vector<long long> keys;
+
+    /// \brief Flags of vertices in buckets.
+    vector<bool> is_in;
+
+    /// \brief Upper bound of maximum not empty bucket.
+    size_t top { 0 };
+
+    /// \brief Vertices count in buckets.
+    size_t count { 0 };
+
+public:
+
+    /// \brief Constructor.
+    ///
+    /// Constructor.
+    ///
+    /// \param[in] n       Vertices count.
+    /// \param[in] max_key Maximum absolute value of key.
+    GainBuckets(size_t n,
+                long long max_key)
+        : min_key(-max_key),
+          heads(static_cast<size_t>(2 * max_key + 1), npos),
+          next(n, npos),
+          prev(n, npos),
+          keys(n, 0),
+          is_in(n, false)
+    {
+    }
+
+    /// \brief Check if buckets are empty.
+    ///
+    /// Check if buckets are empty.
+    ///
+    /// \return
+    /// true - if buckets are empty,
+    /// false - otherwise.
+    inline bool
+    is_empty() const
+    {
+        return count == 0;
+    }
+
+    /// \brief Check if vertex is in buckets.
+    ///
+    /// Check if vertex is in buckets.
+    ///
+    /// \param[in] v Vertex.
+    ///
+    /// \return
+    /// true - if vertex is in buckets,
+    /// false - otherwise.
+    inline bool
+    has(size_t v) const
+    {
+        return is_in[v];
+    }
+
+    /// \brief Get key of vertex.
+    ///
+    /// Get key of vertex.
+    ///
+    /// \param[in] v Vertex.
+    ///
+    /// \return
+    /// Key.
+    inline long long
+    key(size_t v) const
+    {
+        return keys[v];
+    }
+
+    /// \brief Insert vertex.
+    ///
+    /// Insert vertex.
+    ///
+    /// \param[in] v Vertex.
+    /// \param[in] k Key.
+    void
+    insert(size_t v,
+           long long k)
+    {
+        size_t b { static_cast<size_t>(k - min_key) };
+
+        keys[v] = k;
+        is_in[v] = true;
+        prev[v] = npos;
+        next[v] = heads[b];
+
+        if (heads[b] != npos)
+        {
+            prev[heads[b]] = v;
+        }
+
+        heads[b] = v;
+        top = max(top, b);
+        ++count;
+    }
+
+    /// \brief Remove vertex.
+    ///
+    /// Remove vertex.
+    ///
+    /// \param[in] v Vertex.
+    void
+    remove(size_t v)
+    {
+        size_t b { static_cast<size_t>(keys[v] - min_key) };
+
+        if (prev[v] != npos)
+        {
+            next[prev[v]] = next[v];
+        }
+        else
+        {
+            heads[b] = next[v];
+        }
+
+        if (next[v] != npos)
+        {
+            prev[next[v]] = prev[v];
+        }
+
+        is_in[v] = false;
+        --count;
+    }
+
+    /// \brief Extract vertex with maximum key.
+    ///
+    /// Extract vertex with maximum key.
+    ///
+    /// \return
+    /// Vertex.
+    size_t
+    pop_max()
+    {
+        while (heads[top] == npos)
+        {
+            --top;
+        }
+
+        size_t v { heads[top] };
+
+        remove(v);
+
+        return v;
+    }
+};
+
+/// \brief Change of adjacent parts pairs count for link weight change.
+///
+/// \param[in] old_w Old weight of links between parts.
+/// \param[in] new_w New weight of links between parts.
+///
+/// \return
+/// 1 - if parts stop being adjacent,
+/// -1 - if parts become adjacent,
+/// 0 - otherwise.
+static inline long long
+adjacency_gain(size_t old_w,
+               size_t new_w)
+{
+    return ((old_w > 0) ? 1 : 0) - ((new_w > 0) ? 1 : 0);
+}
+
+/// \brief Best move of vertex for Fiduccia-Mattheyses refinement.
+///
+/// Vertex may be moved into neighbour part if its weight does not exceed permitted one
+/// (source part must not become empty).
+/// Key of move is cut gain multiplied by adj_scale plus gain of adjacent parts pairs count,
+/// so edge cut is the main criterion and count of neighbour parts is secondary one.
+///
+/// \param[in]  g         Graph.
+/// \param[in]  v         Vertex.
+/// \param[in]  parts     Parts of vertices.
+/// \param[in]  pw        Weights of parts.
+/// \param[in]  max_pw    Permitted weight of part.
+/// \param[in]  links     Weights of links between parts.
+/// \param[in]  adj_scale Scale of cut gain in key.
+/// \param[out] to        Target part.
+/// \param[out] key       Key of move.
+///
+/// \return
+/// true - if there is move for vertex,
+/// false - otherwise.
+bool
+Partitioner::fm_best_move(const PartitionGraph& g,
+                          size_t v,
+                          const vector<size_t>& parts,
+                          const vector<size_t>& pw,
+                          size_t max_pw,
+                          const vector<vector<size_t>>& links,
+                          size_t adj_scale,
+                          size_t& to,
+                          long long& key)
+{
+    size_t p { parts[v] }, vw { g.weights[v] };
+    vector<pair<size_t, size_t>> conn;
+    size_t in { 0 };
+
+    if (pw[p] <= vw)
+    {
+        return false;
+    }
+
+    // Links of vertex with parts.
+    for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+    {
+        size_t q { parts[g.adj[k]] };
+
+        if (q == p)
+        {
+            in += g.adj_weights[k];
+
+            continue;
+        }
+
+        size_t j { 0 };
+
+        while ((j < conn.size()) && (conn[j].first != q))
+        {
+            ++j;
+        }
+
+        if (j == conn.size())
+        {
+            conn.push_back(make_pair(q, 0));
+        }
+
+        conn[j].second += g.adj_weights[k];
+    }
+
+    bool is_found { false };
+
+    for (const pair<size_t, size_t>& t : conn)
+    {
+        size_t q { t.first };
+
+        if (pw[q] + vw > max_pw)
+        {
+            continue;
+        }
+
+        long long cut_gain { static_cast<long long>(t.second) - static_cast<long long>(in) };
+        long long adj_gain { adjacency_gain(links[p][q], links[p][q] - t.second + in) };
+
+        for (const pair<size_t, size_t>& r : conn)
+        {
+            if (r.first != q)
+            {
+                adj_gain += adjacency_gain(links[p][r.first], links[p][r.first] - r.second);
+                adj_gain += adjacency_gain(links[q][r.first], links[q][r.first] + r.second);
+            }
+        }
+
+        long long k { cut_gain * static_cast<long long>(adj_scale) + adj_gain };
+
+        if (!is_found || (k > key) || ((k == key) && (pw[q] < pw[to])))
+        {
+            is_found = true;
+            to = q;
+            key = k;
+        }
+    }
+
+    return is_found;
+}
+
+/// \brief Move vertex to another part for Fiduccia-Mattheyses refinement.
+///
+/// Move vertex and update weights of parts and links between parts.
+///
+/// \param[in]     g     Graph.
+/// \param[in]     v     Vertex.
+/// \param[in]     to    Target part.
+/// \param[in,out] parts Parts of vertices.
+/// \param[in,out] pw    Weights of parts.
+/// \param[in,out] links Weights of links between parts.
+void
+Partitioner::fm_move(const PartitionGraph& g,
+                     size_t v,
+                     size_t to,
+                     vector<size_t>& parts,
+                     vector<size_t>& pw,
+                     vector<vector<size_t>>& links)
+{
+    size_t p { parts[v] };
+
+    for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+    {
+        size_t r { parts[g.adj[k]] };
+        size_t w { g.adj_weights[k] };
+
+        if (r != p)
+        {
+            links[p][r] -= w;
+            links[r][p] -= w;
+        }
+
+        if (r != to)
+        {
+            links[to][r] += w;
+            links[r][to] += w;
+        }
+    }
+
+    parts[v] = to;
+    pw[p] -= g.weights[v];
+    pw[to] += g.weights[v];
+}
+
+/// \brief Fiduccia-Mattheyses refinement.
+///
+/// Boundary vertices are kept in gain buckets by key of their best move.
+/// On each pass vertex with maximum key is moved and locked (even if key is negative),
+/// keys of its neighbours are updated.
+/// Pass stops when there is no improvement for long time,
+/// then moves after the best state are rolled back.
+/// Edge cut is reduced first, then count of pairs of adjacent parts.
+/// Moves do not make parts heavier than permitted weight.
+///
+/// source:
+/// Fiduccia C.M., Mattheyses R.M.
+/// A linear-time heuristic for improving network partitions.
+///
+/// \param[in]     g         Graph.
+/// \param[in]     dn        Parts count.
+/// \param[in]     imbalance Permitted ratio of part weight to average weight.
+/// \param[in,out] parts     Parts of vertices.
+void
+Partitioner::refine_fm(const PartitionGraph& g,
+                       size_t dn,
+                       double imbalance,
+                       vector<size_t>& parts)
+{
+    const size_t max_passes { 4 };
+    size_t n { g.vertices_count() };
+
+    if ((dn <= 1) || (n == 0))
+    {
+        return;
+    }
+
+    size_t total { g.total_weight() }, max_vw { 0 }, max_deg { 0 }, max_conn { 0 };
+    vector<size_t> pw(dn, 0);
+    vector<vector<size_t>> links(dn, vector<size_t>(dn, 0));
+
+    for (size_t v = 0; v < n; ++v)
+    {
+        size_t conn { 0 };
+
+        pw[parts[v]] += g.weights[v];
+        max_vw = max(max_vw, g.weights[v]);
+        max_deg = max(max_deg, g.offsets[v + 1] - g.offsets[v]);
+
+        for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            conn += g.adj_weights[k];
+
+            if (parts[g.adj[k]] != parts[v])
+            {
+                links[parts[v]][parts[g.adj[k]]] += g.adj_weights[k];
+            }
+        }
+
+        max_conn = max(max_conn, conn);
+    }
+
+    double avg { static_cast<double>(total) / static_cast<double>(dn) };
+    size_t max_pw { max(static_cast<size_t>(imbalance * avg), static_cast<size_t>(avg) + max_vw) };
+
+    // Gain of adjacent parts pairs count is not greater than 2 * max_deg + 1.
+    size_t adj_scale { 4 * max_deg + 3 };
+    long long max_key { static_cast<long long>(max_conn * adj_scale + 2 * max_deg + 1) };
+    size_t max_bad_moves { max(static_cast<size_t>(100), n / 50) };
+
+    for (size_t pass = 0; pass < max_passes; ++pass)
+    {
+        GainBuckets buckets(n, max_key);
+        vector<bool> is_locked(n, false);
+        vector<pair<size_t, size_t>> moves;
+        long long sum { 0 }, best_sum { 0 };
+        size_t best_moves { 0 };
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            size_t to { 0 };
+            long long key { 0 };
+
+            if (fm_best_move(g, v, parts, pw, max_pw, links, adj_scale, to, key))
+            {
+                buckets.insert(v, key);
+            }
+        }
+
+        while (!buckets.is_empty() && (moves.size() - best_moves < max_bad_moves))
+        {
+            size_t v { buckets.pop_max() };
+            long long old_key { buckets.key(v) };
+            size_t to { 0 };
+            long long key { 0 };
+
+            // Key may be old because of moves in other places.
+            if (!fm_best_move(g, v, parts, pw, max_pw, links, adj_scale, to, key))
+            {
+                continue;
+            }
+
+            if (key != old_key)
+            {
+                buckets.insert(v, key);
+
+                continue;
+            }
+
+            moves.push_back(make_pair(v, parts[v]));
+            fm_move(g, v, to, parts, pw, links);
+            is_locked[v] = true;
+            sum += key;
+
+            if (sum > best_sum)
+            {
+                best_sum = sum;
+                best_moves = moves.size();
+            }
+
+            // Update neighbours.
+            for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+            {
+                size_t u { g.adj[k] };
+
+                if (is_locked[u])
+                {
+                    continue;
+                }
+
+                if (buckets.has(u))
+                {
+                    buckets.remove(u);
+                }
+
+                if (fm_best_move(g, u, parts, pw, max_pw, links, adj_scale, to, key))
+                {
+                    buckets.insert(u, key);
+                }
+            }
+        }
+
+        // Roll back moves after the best state.
+        while (moves.size() > best_moves)
+        {
+            fm_move(g, moves.back().first, moves.back().second, parts, pw, links);
+            moves.pop_back();
+        }
+
+        if (best_moves == 0)
+        {
+            break;
+        }
+    }
+}
+
+/// \brief Rebalance partition.
+///
+/// Partition is rebalanced with diffusion, so new partition is close to current one.
+/// First order diffusion scheme on graph of parts gives flows of weight between adjacent parts,
+/// then boundary vertices with maximum gain are moved along flows layer by layer.
+/// In the end partition is refined with Fiduccia-Mattheyses refinement.
+///
+/// source:
+/// Cybenko G.
+/// Dynamic load balancing for distributed memory multiprocessors.
+///
+/// \param[in]     g         Graph.
+/// \param[in]     dn        Parts count.
+/// \param[in]     imbalance Permitted ratio of part weight to average weight.
+/// \param[in,out] parts     Parts of vertices.
+void
+Partitioner::rebalance(const PartitionGraph& g,
+                       size_t dn,
+                       double imbalance,
+                       vector<size_t>& parts)
+{
+    const size_t max_rounds { 256 };
+    size_t n { g.vertices_count() };
+
+    if ((dn <= 1) || (n == 0))
+    {
+        return;
+    }
+
+    // Weights of parts and graph of parts.
+    vector<double> load(dn, 0.0);
+    vector<size_t> pw(dn, 0);
+    vector<vector<bool>> is_adj(dn, vector<bool>(dn, false));
+    vector<vector<size_t>> pg(dn);
+
+    for (size_t v = 0; v < n; ++v)
+    {
+        size_t p { parts[v] };
+
+        pw[p] += g.weights[v];
+
+        for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            size_t q { parts[g.adj[k]] };
+
+            if ((q != p) && !is_adj[p][q])
+            {
+                is_adj[p][q] = true;
+                pg[p].push_back(q);
+            }
+        }
+    }
+
+    size_t max_deg { 0 };
+
+    for (size_t p = 0; p < dn; ++p)
+    {
+        load[p] = static_cast<double>(pw[p]);
+        max_deg = max(max_deg, pg[p].size());
+    }
+
+    // Diffusion.
+    double avg { static_cast<double>(g.total_weight()) / static_cast<double>(dn) };
+    double alpha { 1.0 / static_cast<double>(max_deg + 1) };
+    size_t max_iters { 100 * dn * dn };
+    vector<vector<double>> flow(dn, vector<double>(dn, 0.0));
+    vector<double> next(dn);
+
+    for (size_t it = 0; it < max_iters; ++it)
+    {
+        double dev { 0.0 };
+
+        for (size_t p = 0; p < dn; ++p)
+        {
+            dev = max(dev, abs(load[p] - avg));
+        }
+
+        if (dev < 1.0e-3 * avg)
+        {
+            break;
+        }
+
+        next = load;
+
+        for (size_t p = 0; p < dn; ++p)
+        {
+            for (size_t q : pg[p])
+            {
+                if (p < q)
+                {
+                    double f { alpha * (load[p] - load[q]) };
+
+                    flow[p][q] += f;
+                    flow[q][p] -= f;
+                    next[p] -= f;
+                    next[q] += f;
+                }
+            }
+        }
+
+        load.swap(next);
+    }
+
+    // Move boundary vertices along flows.
+    vector<size_t> conn(dn, 0), touched;
+    vector<pair<long long, pair<size_t, size_t>>> moves;
+
+    for (size_t round = 0; round < max_rounds; ++round)
+    {
+        moves.clear();
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            size_t p { parts[v] };
+            double vw { static_cast<double>(g.weights[v]) };
+
+            touched.clear();
+
+            for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+            {
+                size_t q { parts[g.adj[k]] };
+
+                if (conn[q] == 0)
+                {
+                    touched.push_back(q);
+                }
+
+                conn[q] += g.adj_weights[k];
+            }
+
+            size_t best { p };
+            long long best_gain { 0 };
+
+            for (size_t q : touched)
+            {
+                if ((q == p) || (flow[p][q] < 0.5 * vw))
+                {
+                    continue;
+                }
+
+                long long gain { static_cast<long long>(conn[q]) - static_cast<long long>(conn[p]) };
+
+                if ((best == p) || (gain > best_gain)
+                    || ((gain == best_gain) && (flow[p][q] > flow[p][best])))
+                {
+                    best = q;
+                    best_gain = gain;
+                }
+            }
+
+            for (size_t q : touched)
+            {
+                conn[q] = 0;
+            }
+
+            if (best != p)
+            {
+                moves.push_back(make_pair(-best_gain, make_pair(v, best)));
+            }
+        }
+
+        // The best moves first, ties are broken with vertices numbers.
+        sort(moves.begin(), moves.end());
+
+        size_t moved { 0 };
+
+        for (const pair<long long, pair<size_t, size_t>>& m : moves)
+        {
+            size_t v { m.second.first }, q { m.second.second }, p { parts[v] }, vw { g.weights[v] };
+
+            if ((flow[p][q] >= 0.5 * static_cast<double>(vw)) && (pw[p] > vw))
+            {
+                parts[v] = q;
+                pw[p] -= vw;
+                pw[q] += vw;
+                flow[p][q] -= static_cast<double>(vw);
+                flow[q][p] += static_cast<double>(vw);
+                ++moved;
+            }
+        }
+
+        if (moved == 0)
+        {
+            break;
+        }
+    }
+
+    refine_fm(g, dn, imbalance, parts);
+}
+
+/// \brief Build dual graph of mesh.
+///
+/// Vertices of graph are cells, links are inner edges.
+/// Identifiers of cells must be equal to their indices.
+///
+/// \param[in]  all All mesh elements.
+/// \param[out] g   Graph.
+void
+Partitioner::build_dual_graph(NodesEdgesCellsHolder& all,
+                              PartitionGraph& g)
+{
+    size_t cc { all.cells_count() };
+
+    g.offsets.assign(1, 0);
+    g.adj.clear();
+    g.adj_weights.clear();
+    g.weights.assign(cc, 1);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { all.cell(i) };
+
+        DEBUG_CHECK_ERROR(static_cast<size_t>(c->get_id()) == i, "cell identifier is not equal to its index");
+
+        for (size_t j = 0; j < c->edges_count(); ++j)
+        {
+            Cell* nc { c->get_neighbour(c->edge(j)) };
+
+            if (nc)
+            {
+                g.adj.push_back(static_cast<size_t>(nc->get_id()));
+                g.adj_weights.push_back(1);
+            }
+        }
+
+        g.offsets.push_back(g.adj.size());
+    }
+}
+
+/// \brief Set weights of vertices.
+///
+/// Real weights are scaled to integers with average about 1000
+/// (each vertex weight is not less than 1).
+/// Empty weights mean equal weights of vertices.
+///
+/// \param[out] g       Graph.
+/// \param[in]  weights Weights of vertices.
+void
+Partitioner::set_weights(PartitionGraph& g,
+                         const vector<double>& weights)
+{
+    size_t n { g.vertices_count() };
+
+    if (weights.empty())
+    {
+        g.weights.assign(n, 1);
+
+        return;
+    }
+
+    DEBUG_CHECK_ERROR(weights.size() == n, "wrong count of weights");
+
+    double total { 0.0 };
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        total += weights[i];
+    }
+
+    double scale { (total > 0.0) ? (1000.0 * static_cast<double>(n) / total) : 0.0 };
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        g.weights[i] = max(static_cast<size_t>(weights[i] * scale + 0.5), static_cast<size_t>(1));
+    }
+}
+
+/// \brief Multilevel partition.
+///
+/// Graph is coarsened until it is small enough (or coarsening does not reduce it),
+/// coarsest graph is partitioned, then partition is projected to finer graphs
+/// and refined on each level.
+///
+/// \param[in]  g         Graph.
+/// \param[in]  dn        Parts count.
+/// \param[out] parts     Parts of vertices.
+/// \param[in]  imbalance Permitted ratio of part weight to average weight.
+void
+Partitioner::multilevel(const PartitionGraph& g,
+                        size_t dn,
+                        vector<size_t>& parts,
+                        double imbalance)
+{
+    size_t n { g.vertices_count() };
+
+    if ((dn <= 1) || (n <= dn))
+    {
+        parts.resize(n);
+
+        for (size_t v = 0; v < n; ++v)
+        {
+            parts[v] = (dn <= 1) ? 0 : v;
+        }
+
+        return;
+    }
+
+    // Coarsening.
+    const size_t coarse_limit { max(static_cast<size_t>(20) * dn, static_cast<size_t>(100)) };
+    size_t max_weight { max(static_cast<size_t>(1.5 * static_cast<double>(g.total_weight())
+                                                / static_cast<double>(coarse_limit)),
+                            static_cast<size_t>(2)) };
+    vector<PartitionGraph> graphs;
+    vector<vector<size_t>> cmaps;
+
+    while (true)
+    {
+        const PartitionGraph& cur { graphs.empty() ? g : graphs.back() };
+
+        if (cur.vertices_count() <= coarse_limit)
+        {
+            break;
+        }
+
+        PartitionGraph cg;
+        vector<size_t> cmap;
+
+        coarsen(cur, max_weight, cg, cmap);
+
+        // Graph is not reduced enough.
+        if (cg.vertices_count() > cur.vertices_count() * 19 / 20)
+        {
+            break;
+        }
+
+        graphs.push_back(cg);
+        cmaps.push_back(cmap);
+    }
+
+    // Partition of coarsest graph.
+    initial_partition(graphs.empty() ? g : graphs.back(), dn, parts);
+
+    // Uncoarsening.
+    for (size_t l = graphs.size(); l > 0; --l)
+    {
+        const PartitionGraph& cg { graphs[l - 1] };
+        const PartitionGraph& fg { (l == 1) ? g : graphs[l - 2] };
+        const vector<size_t>& cmap { cmaps[l - 1] };
+        vector<size_t> fine_parts(fg.vertices_count());
+
+        refine(cg, dn, imbalance, parts);
+        refine_fm(cg, dn, imbalance, parts);
+
+        for (size_t v = 0; v < fine_parts.size(); ++v)
+        {
+            fine_parts[v] = parts[cmap[v]];
+        }
+
+        parts.swap(fine_parts);
+    }
+
+    refine(g, dn, imbalance, parts);
+    refine_fm(g, dn, imbalance, parts);
+}
+
+/// \brief Edge cut of partition.
+///
+/// Total weight of links between vertices of different parts.
+///
+/// \param[in] g     Graph.
+/// \param[in] parts Parts of vertices.
+///
+/// \return
+/// Edge cut.
+size_t
+Partitioner::edge_cut(const PartitionGraph& g,
+                      const vector<size_t>& parts)
+{
+    size_t cut { 0 };
+
+    for (size_t v = 0; v < g.vertices_count(); ++v)
+    {
+        for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            if (parts[v] != parts[g.adj[k]])
+            {
+                cut += g.adj_weights[k];
+            }
+        }
+    }
+
+    // Each link is counted twice.
+    return cut / 2;
+}
+
+/// \brief Count of pairs of adjacent parts.
+///
+/// Count of pairs of parts which have links between their vertices.
+///
+/// \param[in] g     Graph.
+/// \param[in] dn    Parts count.
+/// \param[in] parts Parts of vertices.
+///
+/// \return
+/// Count of pairs of adjacent parts.
+size_t
+Partitioner::adjacent_parts_pairs_count(const PartitionGraph& g,
+                                        size_t dn,
+                                        const vector<size_t>& parts)
+{
+    vector<vector<bool>> is_adj(dn, vector<bool>(dn, false));
+    size_t cnt { 0 };
+
+    for (size_t v = 0; v < g.vertices_count(); ++v)
+    {
+        for (size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            size_t p { parts[v] }, q { parts[g.adj[k]] };
+
+            if ((p < q) && !is_adj[p][q])
+            {
+                is_adj[p][q] = true;
+                ++cnt;
+            }
+        }
+    }
+
+    return cnt;
+}
+
+/// @}
+
+}
+
+}
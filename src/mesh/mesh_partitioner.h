@@ -0,0 +1,167 @@
+/// \file
+/// \brief Graph partitioner.
+///
+/// Multilevel graph partitioner declaration.
+
+#ifndef CAESAR_MESH_PARTITIONER_H
+#define CAESAR_MESH_PARTITIONER_H
+
+#include "mesh_nodes_edges_cells_holder.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Graph for partitioning.
+///
+/// Undirected weighted graph in compressed sparse row format.
+/// Adjacent vertices of vertex v are adj[offsets[v]] .. adj[offsets[v + 1] - 1].
+struct PartitionGraph
+{
+    /// \brief Offsets of vertices adjacency.
+    vector<size_t> offsets { 0 };
+
+    /// \brief Adjacent vertices.
+    vector<size_t> adj;
+
+    /// \brief Weights of links to adjacent vertices.
+    vector<size_t> adj_weights;
+
+    /// \brief Weights of vertices.
+    vector<size_t> weights;
+
+    /// \brief Get vertices count.
+    ///
+    /// Get vertices count.
+    ///
+    /// \return
+    /// Vertices count.
+    inline size_t
+    vertices_count() const
+    {
+        return weights.size();
+    }
+
+    // Total weight of vertices.
+    size_t
+    total_weight() const;
+};
+
+/// \brief Multilevel graph partitioner.
+///
+/// Graph is coarsened with heavy edge matching,
+/// coarsest graph is partitioned with recursive bisection (greedy graph growing),
+/// partition is projected back and refined on each level
+/// (greedy pass and Fiduccia-Mattheyses pass).
+/// Partition is deterministic (the same on all processes).
+class Partitioner
+{
+
+private:
+
+    // Coarsen graph with heavy edge matching.
+    static void
+    coarsen(const PartitionGraph& g,
+            size_t max_weight,
+            PartitionGraph& cg,
+            vector<size_t>& cmap);
+
+    // Bisect set of vertices with greedy graph growing.
+    static void
+    bisect(const PartitionGraph& g,
+           const vector<size_t>& vs,
+           size_t first_part,
+           size_t dn,
+           vector<size_t>& parts);
+
+    // Initial partition.
+    static void
+    initial_partition(const PartitionGraph& g,
+                      size_t dn,
+                      vector<size_t>& parts);
+
+    // Refine partition.
+    static void
+    refine(const PartitionGraph& g,
+           size_t dn,
+           double imbalance,
+           vector<size_t>& parts);
+
+    // Best move of vertex for Fiduccia-Mattheyses refinement.
+    static bool
+    fm_best_move(const PartitionGraph& g,
+                 size_t v,
+                 const vector<size_t>& parts,
+                 const vector<size_t>& pw,
+                 size_t max_pw,
+                 const vector<vector<size_t>>& links,
+                 size_t adj_scale,
+                 size_t& to,
+                 long long& key);
+
+    // Move vertex to another part for Fiduccia-Mattheyses refinement.
+    static void
+    fm_move(const PartitionGraph& g,
+            size_t v,
+            size_t to,
+            vector<size_t>& parts,
+            vector<size_t>& pw,
+            vector<vector<size_t>>& links);
+
+public:
+
+    // Build dual graph of mesh.
+    static void
+    build_dual_graph(NodesEdgesCellsHolder& all,
+                     PartitionGraph& g);
+
+    // Set weights of vertices.
+    static void
+    set_weights(PartitionGraph& g,
+                const vector<double>& weights);
+
+    // Multilevel partition.
+    static void
+    multilevel(const PartitionGraph& g,
+               size_t dn,
+               vector<size_t>& parts,
+               double imbalance = 1.03);
+
+    // Fiduccia-Mattheyses refinement.
+    static void
+    refine_fm(const PartitionGraph& g,
+              size_t dn,
+              double imbalance,
+              vector<size_t>& parts);
+
+    // Rebalance partition.
+    static void
+    rebalance(const PartitionGraph& g,
+              size_t dn,
+              double imbalance,
+              vector<size_t>& parts);
+
+    // Edge cut of partition.
+    static size_t
+    edge_cut(const PartitionGraph& g,
+             const vector<size_t>& parts);
+
+    // Count of pairs of adjacent parts.
+    static size_t
+    adjacent_parts_pairs_count(const PartitionGraph& g,
+                               size_t dn,
+                               const vector<size_t>& parts);
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_PARTITIONER_H
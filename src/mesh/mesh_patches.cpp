@@ -0,0 +1,251 @@
+/// \file
+/// \brief Patches of mesh.
+///
+/// Patches of mesh implementation.
+
+#include "mesh_patches.h"
+#include "mesh_edge.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief No object in patch.
+const size_t Patch::npos;
+
+/// \brief Default constructor.
+///
+/// Default constructor.
+Patches::Patches()
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+Patches::~Patches()
+{
+}
+
+/// \brief Build patches.
+///
+/// Build patches with given count of core cells and layers.
+///
+/// \param[in] all          All mesh elements.
+/// \param[in] patch_cells_ Count of core cells of patch.
+/// \param[in] layers_      Count of layers around core cells.
+void
+Patches::build(NodesEdgesCellsHolder& all,
+               size_t patch_cells_,
+               size_t layers_)
+{
+    const size_t npos { Patch::npos };
+    size_t cc { all.cells_count() }, nc { all.nodes_count() };
+
+    clear();
+    cells_count = cc;
+    patch_cells = max(patch_cells_, static_cast<size_t>(1));
+    layers = layers_;
+
+    // Core cells.
+    // Breadth first search through edges from the first free cell.
+    vector<size_t> core_of(cc, npos);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        if (core_of[i] != npos)
+        {
+            continue;
+        }
+
+        size_t p { patches.size() };
+
+        patches.push_back(Patch());
+
+        vector<Cell*>& q { patches.back().cells };
+
+        q.push_back(all.cell(i));
+        core_of[i] = p;
+
+        for (size_t head = 0; (head < q.size()) && (q.size() < patch_cells); ++head)
+        {
+            Cell* c { q[head] };
+
+            for (size_t j = 0; (j < c->edges_count()) && (q.size() < patch_cells); ++j)
+            {
+                Edge* e { c->edge(j) };
+
+                if (!e->is_inner())
+                {
+                    continue;
+                }
+
+                Cell* ngh { (e->cell(0) == c) ? e->cell(1) : e->cell(0) };
+                size_t ni { static_cast<size_t>(ngh->get_id()) };
+
+                if (core_of[ni] == npos)
+                {
+                    core_of[ni] = p;
+                    q.push_back(ngh);
+                }
+            }
+        }
+
+        patches.back().core_count = q.size();
+    }
+
+    // Layers, nodes and local links.
+    vector<size_t> cells_stamp(cc, npos), cells_loc(cc), nodes_stamp(nc, npos), nodes_loc(nc);
+
+    for (size_t p = 0; p < patches.size(); ++p)
+    {
+        Patch& pt { patches[p] };
+
+        for (size_t i = 0; i < pt.cells.size(); ++i)
+        {
+            size_t ci { static_cast<size_t>(pt.cells[i]->get_id()) };
+
+            cells_stamp[ci] = p;
+            cells_loc[ci] = i;
+        }
+
+        // Layers of cells adjacent by nodes.
+        size_t beg { 0 };
+
+        for (size_t li = 0; li < layers; ++li)
+        {
+            size_t end { pt.cells.size() };
+
+            for (size_t i = beg; i < end; ++i)
+            {
+                Cell* c { pt.cells[i] };
+
+                for (size_t j = 0; j < c->nodes_count(); ++j)
+                {
+                    Node* n { c->node(j) };
+
+                    for (size_t k = 0; k < n->cells_count(); ++k)
+                    {
+                        Cell* ngh { n->cell(k) };
+                        size_t ni { static_cast<size_t>(ngh->get_id()) };
+
+                        if (cells_stamp[ni] != p)
+                        {
+                            cells_stamp[ni] = p;
+                            cells_loc[ni] = pt.cells.size();
+                            pt.cells.push_back(ngh);
+                        }
+                    }
+                }
+            }
+
+            beg = end;
+        }
+
+        // Nodes and cells links.
+        for (Cell* c : pt.cells)
+        {
+            DEBUG_CHECK_ERROR(c->nodes_count() == 3, "only triangle cells are supported in patches");
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                Node* n { c->node(j) };
+                size_t ni { static_cast<size_t>(n->get_id()) };
+
+                if (nodes_stamp[ni] != p)
+                {
+                    nodes_stamp[ni] = p;
+                    nodes_loc[ni] = pt.nodes.size();
+                    pt.nodes.push_back(n);
+                }
+
+                pt.cells_nodes.push_back(nodes_loc[ni]);
+
+                Edge* e { c->edge(j) };
+                size_t ngh_loc { npos };
+
+                if (e->is_inner())
+                {
+                    Cell* ngh { (e->cell(0) == c) ? e->cell(1) : e->cell(0) };
+                    size_t ci { static_cast<size_t>(ngh->get_id()) };
+
+                    if (cells_stamp[ci] == p)
+                    {
+                        ngh_loc = cells_loc[ci];
+                    }
+                }
+
+                pt.cells_neighbours.push_back(ngh_loc);
+            }
+        }
+
+        // Nodes links.
+        pt.nodes_cells_offsets.push_back(0);
+
+        for (size_t i = 0; i < pt.nodes.size(); ++i)
+        {
+            Node* n { pt.nodes[i] };
+
+            for (size_t j = 0; j < n->cells_count(); ++j)
+            {
+                size_t ci { static_cast<size_t>(n->cell(j)->get_id()) };
+
+                pt.nodes_cells.push_back((cells_stamp[ci] == p) ? cells_loc[ci] : npos);
+            }
+
+            pt.nodes_cells_offsets.push_back(pt.nodes_cells.size());
+
+            // Node is owned by patch of its first cell.
+            if ((n->cells_count() > 0)
+                && (core_of[static_cast<size_t>(n->cell(0)->get_id())] == p))
+            {
+                pt.own_nodes.push_back(i);
+            }
+        }
+    }
+}
+
+/// \brief Clear patches.
+///
+/// Clear patches.
+void
+Patches::clear()
+{
+    cells_count = 0;
+    patch_cells = 0;
+    layers = 0;
+    patches.clear();
+}
+
+/// \brief Check if patches are built with given parameters.
+///
+/// Check if patches are built with given parameters.
+///
+/// \param[in] all          All mesh elements.
+/// \param[in] patch_cells_ Count of core cells of patch.
+/// \param[in] layers_      Count of layers around core cells.
+///
+/// \return
+/// true - if patches are built with given parameters,
+/// false - otherwise.
+bool
+Patches::is_built(const NodesEdgesCellsHolder& all,
+                  size_t patch_cells_,
+                  size_t layers_) const
+{
+    return !patches.empty()
+           && (cells_count == all.cells_count())
+           && (patch_cells == max(patch_cells_, static_cast<size_t>(1)))
+           && (layers == layers_);
+}
+
+/// @}
+
+}
+
+}
@@ -0,0 +1,143 @@
+/// \file
+/// \brief Patches of mesh.
+///
+/// Patches of mesh declaration.
+
+#ifndef CAESAR_MESH_PATCHES_H
+#define CAESAR_MESH_PATCHES_H
+
+#include "mesh_node.h"
+#include "mesh_cell.h"
+#include "mesh_nodes_edges_cells_holder.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Patch of mesh.
+///
+/// Core cells of patch and several layers of cells adjacent by nodes around them.
+/// All links are given with local indices in patch.
+struct Patch
+{
+    /// \brief No object in patch.
+    static const size_t npos { static_cast<size_t>(-1) };
+
+    /// \brief Cells (core cells first, then layers).
+    vector<Cell*> cells;
+
+    /// \brief Count of core cells.
+    size_t core_count { 0 };
+
+    /// \brief Nodes of cells.
+    vector<Node*> nodes;
+
+    /// \brief Nodes owned by patch (each node is owned by one patch).
+    vector<size_t> own_nodes;
+
+    /// \brief Nodes of cells (3 local indices for each cell).
+    vector<size_t> cells_nodes;
+
+    /// \brief Neighbours of cells through edges (3 local indices for each cell).
+    ///
+    /// npos for border edge or neighbour outside of patch.
+    vector<size_t> cells_neighbours;
+
+    /// \brief Offsets of incident cells of nodes.
+    vector<size_t> nodes_cells_offsets;
+
+    /// \brief Incident cells of nodes (local indices, npos for cell outside of patch).
+    ///
+    /// Order is the same as order of node cells.
+    vector<size_t> nodes_cells;
+};
+
+/// \brief Patches of mesh.
+///
+/// Mesh cells are split into patches which are small enough to be in cache.
+/// Core cells of patches are grown with breadth first search through edges
+/// (dual graph of mesh), each cell is a core cell of only one patch.
+/// Patch also holds layers of cells adjacent by nodes around core cells,
+/// so several iterations of local smoothing may be done for patch independently.
+/// Values of core cells and owned nodes are correct after iterations
+/// if iterations count is not greater than layers count.
+class Patches
+{
+
+private:
+
+    /// \brief Cells count for which patches are built.
+    size_t cells_count { 0 };
+
+    /// \brief Core cells count of patch.
+    size_t patch_cells { 0 };
+
+    /// \brief Layers count.
+    size_t layers { 0 };
+
+    /// \brief Patches.
+    vector<Patch> patches;
+
+public:
+
+    // Default constructor.
+    Patches();
+
+    // Default destructor.
+    ~Patches();
+
+    // Build patches.
+    void
+    build(NodesEdgesCellsHolder& all,
+          size_t patch_cells_,
+          size_t layers_);
+
+    // Clear patches.
+    void
+    clear();
+
+    // Check if patches are built with given parameters.
+    bool
+    is_built(const NodesEdgesCellsHolder& all,
+             size_t patch_cells_,
+             size_t layers_) const;
+
+    /// \brief Get patches count.
+    ///
+    /// Get patches count.
+    ///
+    /// \return
+    /// Patches count.
+    inline size_t
+    patches_count() const
+    {
+        return patches.size();
+    }
+
+    /// \brief Get patch.
+    ///
+    /// Get patch.
+    ///
+    /// \param[in] i Index.
+    ///
+    /// \return
+    /// Patch.
+    inline const Patch&
+    patch(size_t i) const
+    {
+        return patches[i];
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_PATCHES_H
@@ -0,0 +1,315 @@
+/// \file
+/// \brief Mesh quality implementation.
+///
+/// Mesh quality metrics and their statistics implementation.
+
+#include "mesh_quality.h"
+
+#include "parl/parl.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Quality metric mapper.
+///
+/// Quality metric mapper.
+utils::Mapper<QualityMetric> QualityMetricMapper
+{
+    "quality metric",
+    vector<string> { "MIN_SIDE", "ASPECT_RATIO", "MIN_ANGLE", "AREA_RATIO" }
+};
+
+// Static constants definitions.
+const size_t Quality::metrics_count;
+
+/// \brief Constructor.
+///
+/// Constructor.
+///
+/// \param[in] bins_count_ Count of histograms bins.
+Quality::Quality(size_t bins_count_)
+    : bins_count(bins_count_)
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+Quality::~Quality()
+{
+}
+
+/// \brief Check if value is taken into account in statistics.
+///
+/// Maximum double value marks undefined metric (aspect ratio of degenerate cell).
+///
+/// \param[in] v Value.
+///
+/// \return
+/// true - if value is taken into account,
+/// false - otherwise.
+static inline bool
+is_counted(double v)
+{
+    return v < numeric_limits<double>::max();
+}
+
+/// \brief Calculate metrics of cell.
+///
+/// Calculate all metrics of triangle cell.
+///
+/// \param[in]  c  Cell.
+/// \param[out] ms Metrics values (array indexed by metric number).
+void
+Quality::calc_cell_metrics(const Cell* c,
+                           double* ms)
+{
+    const geom::Vector& a { c->node(0)->point() };
+    const geom::Vector& b { c->node(1)->point() };
+    const geom::Vector& d { c->node(2)->point() };
+
+    // Sides opposite to points.
+    double la { b.dist_to(d) }, lb { d.dist_to(a) }, lc { a.dist_to(b) };
+    double min_side { std::min(la, std::min(lb, lc)) };
+    double max_side { std::max(la, std::max(lb, lc)) };
+    double area { geom::Vector::triangle_area(a, b, d) };
+
+    // Minimum angle is opposite to minimum side.
+    double s0 { min_side }, s1 { 0.0 }, s2 { 0.0 };
+
+    if ((la <= lb) && (la <= lc))
+    {
+        s1 = lb;
+        s2 = lc;
+    }
+    else if (lb <= lc)
+    {
+        s1 = lc;
+        s2 = la;
+    }
+    else
+    {
+        s1 = la;
+        s2 = lb;
+    }
+
+    double min_angle { 0.0 };
+
+    if (s1 * s2 > 0.0)
+    {
+        double cs { (s1 * s1 + s2 * s2 - s0 * s0) / (2.0 * s1 * s2) };
+
+        min_angle = acos(std::max(-1.0, std::min(1.0, cs)));
+    }
+
+    ms[static_cast<size_t>(QualityMetric::MinSide)] = min_side;
+    ms[static_cast<size_t>(QualityMetric::AspectRatio)]
+        = (area > 0.0)
+          ? (max_side * (la + lb + lc) / (4.0 * sqrt(3.0) * area))
+          : numeric_limits<double>::max();
+    ms[static_cast<size_t>(QualityMetric::MinAngle)] = min_angle;
+    ms[static_cast<size_t>(QualityMetric::AreaRatio)]
+        = (c->original_area() > 0.0) ? (area / c->original_area()) : 1.0;
+}
+
+/// \brief Calculate quality.
+///
+/// Calculate metrics for all cells in one parallel pass,
+/// then calculate minimum, maximum, mean values and histograms.
+/// Undefined values (aspect ratios of degenerate cells) are not taken into account
+/// in statistics, degenerate cells are counted separately.
+/// If statistics are global, they are reduced over all processes
+/// (in this case holder must contain only own cells).
+///
+/// \param[in] h         Cells holder.
+/// \param[in] is_global Reduce statistics over all processes.
+void
+Quality::calc(const CellsHolder& h,
+              bool is_global)
+{
+    size_t cc { h.cells_count() };
+
+    for (size_t m = 0; m < metrics_count; ++m)
+    {
+        values[m].resize(cc);
+    }
+
+    mins.assign(metrics_count, numeric_limits<double>::max());
+    maxs.assign(metrics_count, numeric_limits<double>::lowest());
+    sums.assign(metrics_count, 0.0);
+    counts.assign(metrics_count, 0.0);
+
+    double degenerate { 0.0 };
+
+    // Fused pass: all metrics and local statistics.
+    #pragma omp parallel reduction(+:degenerate)
+    {
+        double ms[metrics_count];
+        vector<double> local_mins(metrics_count, numeric_limits<double>::max());
+        vector<double> local_maxs(metrics_count, numeric_limits<double>::lowest());
+        vector<double> local_sums(metrics_count, 0.0);
+        vector<double> local_counts(metrics_count, 0.0);
+
+        #pragma omp for
+        for (size_t i = 0; i < cc; ++i)
+        {
+            calc_cell_metrics(h.cell(i), ms);
+
+            if (!is_counted(ms[static_cast<size_t>(QualityMetric::AspectRatio)]))
+            {
+                degenerate += 1.0;
+            }
+
+            for (size_t m = 0; m < metrics_count; ++m)
+            {
+                values[m][i] = ms[m];
+
+                if (is_counted(ms[m]))
+                {
+                    local_mins[m] = std::min(local_mins[m], ms[m]);
+                    local_maxs[m] = std::max(local_maxs[m], ms[m]);
+                    local_sums[m] += ms[m];
+                    local_counts[m] += 1.0;
+                }
+            }
+        }
+
+        #pragma omp critical
+        {
+            for (size_t m = 0; m < metrics_count; ++m)
+            {
+                mins[m] = std::min(mins[m], local_mins[m]);
+                maxs[m] = std::max(maxs[m], local_maxs[m]);
+                sums[m] += local_sums[m];
+                counts[m] += local_counts[m];
+            }
+        }
+    }
+
+    vector<double> cnt { static_cast<double>(cc), degenerate };
+
+    if (is_global)
+    {
+        parl::mpi_allreduce_min(mins);
+        parl::mpi_allreduce_max(maxs);
+        parl::mpi_allreduce_sum(sums);
+        parl::mpi_allreduce_sum(counts);
+        parl::mpi_allreduce_sum(cnt);
+    }
+
+    cells_count_ = cnt[0];
+    degenerate_cells_count_ = cnt[1];
+
+    // Histograms on global ranges.
+    vector<double> hs(metrics_count * bins_count, 0.0);
+    vector<double> counted;
+
+    for (size_t m = 0; m < metrics_count; ++m)
+    {
+        histograms[m].assign(bins_count, 0.0);
+
+        if (counts[m] < cells_count_)
+        {
+            // Local values have undefined ones (rare case).
+            counted.clear();
+            copy_if(values[m].begin(), values[m].end(), back_inserter(counted), is_counted);
+            mth::histogram(counted, mins[m], maxs[m], histograms[m]);
+        }
+        else
+        {
+            mth::histogram(values[m], mins[m], maxs[m], histograms[m]);
+        }
+
+        copy(histograms[m].begin(), histograms[m].end(), hs.begin() + static_cast<long>(m * bins_count));
+    }
+
+    if (is_global)
+    {
+        parl::mpi_allreduce_sum(hs);
+
+        for (size_t m = 0; m < metrics_count; ++m)
+        {
+            copy(hs.begin() + static_cast<long>(m * bins_count),
+                 hs.begin() + static_cast<long>((m + 1) * bins_count),
+                 histograms[m].begin());
+        }
+    }
+}
+
+/// \brief Mean value of metric.
+///
+/// Mean value of metric (undefined values are not taken into account).
+///
+/// \param[in] m Metric.
+///
+/// \return
+/// Mean value.
+double
+Quality::mean(QualityMetric m) const
+{
+    size_t mi { static_cast<size_t>(m) };
+
+    return (counts[mi] > 0.0) ? (sums[mi] / counts[mi]) : 0.0;
+}
+
+/// \brief Quantile of metric.
+///
+/// Approximate quantile of metric found by histogram.
+///
+/// \param[in] m Metric.
+/// \param[in] q Quantile level (from 0.0 to 1.0).
+///
+/// \return
+/// Quantile value.
+double
+Quality::quantile(QualityMetric m,
+                  double q) const
+{
+    size_t mi { static_cast<size_t>(m) };
+
+    return mth::histogram_quantile(histograms[mi], mins[mi], maxs[mi], q);
+}
+
+/// \brief Print function.
+///
+/// Print statistics of all metrics.
+///
+/// \param[in] os Output stream.
+/// \param[in] q  Quality.
+///
+/// \return
+/// Output stream.
+ostream&
+operator<<(ostream& os,
+           const Quality& q)
+{
+    os << "quality (" << q.cells_count() << " cells, "
+       << q.degenerate_cells_count() << " degenerate):" << endl;
+
+    for (size_t i = 0; i < Quality::metrics_count; ++i)
+    {
+        QualityMetric m { static_cast<QualityMetric>(i) };
+
+        os << "    " << QualityMetricMapper.name(m)
+           << " : min " << q.min(m)
+           << ", q05 " << q.quantile(m, 0.05)
+           << ", median " << q.quantile(m, 0.5)
+           << ", mean " << q.mean(m)
+           << ", q95 " << q.quantile(m, 0.95)
+           << ", max " << q.max(m) << endl;
+    }
+
+    return os;
+}
+
+/// @}
+
+}
+
+}
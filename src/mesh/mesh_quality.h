@@ -0,0 +1,212 @@
+/// \file
+/// \brief Mesh quality declaration.
+///
+/// Mesh quality metrics and their statistics.
+
+#ifndef CAESAR_MESH_QUALITY_H
+#define CAESAR_MESH_QUALITY_H
+
+#include "mesh_mesh.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Quality metric.
+///
+/// Quality metric of cell.
+enum class QualityMetric
+{
+    /// \brief First element.
+    First = 0,
+
+    /// \brief Minimum side length.
+    MinSide = First,
+
+    /// \brief Aspect ratio (1.0 for equilateral triangle).
+    ///
+    /// Degenerate cell (with zero area) has maximum double value
+    /// and it is excluded from statistics.
+    AspectRatio,
+
+    /// \brief Minimum angle (rad).
+    MinAngle,
+
+    /// \brief Ratio of area to original area.
+    AreaRatio,
+
+    /// \brief Last element.
+    Last = AreaRatio
+};
+
+/// \brief Quality metric mapper.
+///
+/// Quality metric mapper.
+extern utils::Mapper<QualityMetric> QualityMetricMapper;
+
+/// \brief Mesh quality.
+///
+/// Metrics of cells are calculated in one parallel pass.
+/// Statistics (minimum, maximum, mean, histograms) may be reduced over all processes.
+/// Degenerate cells are counted separately and their infinite aspect ratios
+/// are not taken into account in statistics.
+class Quality
+{
+
+private:
+
+    /// \brief Count of metrics.
+    static const size_t metrics_count { static_cast<size_t>(QualityMetric::Last) + 1 };
+
+    /// \brief Count of histograms bins.
+    size_t bins_count { 64 };
+
+    /// \brief Values of metrics for cells.
+    vector<double> values[metrics_count];
+
+    /// \brief Count of cells.
+    double cells_count_ { 0.0 };
+
+    /// \brief Count of degenerate cells.
+    double degenerate_cells_count_ { 0.0 };
+
+    /// \brief Counts of values taken into account in statistics.
+    vector<double> counts;
+
+    /// \brief Minimum values.
+    vector<double> mins;
+
+    /// \brief Maximum values.
+    vector<double> maxs;
+
+    /// \brief Sums of values.
+    vector<double> sums;
+
+    /// \brief Histograms on [min, max] ranges.
+    vector<double> histograms[metrics_count];
+
+    // Calculate metrics of cell.
+    static void
+    calc_cell_metrics(const Cell* c,
+                      double* ms);
+
+public:
+
+    // Constructor.
+    explicit Quality(size_t bins_count_ = 64);
+
+    // Default destructor.
+    ~Quality();
+
+    // Calculate quality.
+    void
+    calc(const CellsHolder& h,
+         bool is_global = false);
+
+    /// \brief Get values of metric.
+    ///
+    /// Get values of metric for cells of last calculation.
+    ///
+    /// \param[in] m Metric.
+    ///
+    /// \return
+    /// Values.
+    inline const vector<double>&
+    get_values(QualityMetric m) const
+    {
+        return values[static_cast<size_t>(m)];
+    }
+
+    /// \brief Get histogram of metric.
+    ///
+    /// Get histogram of metric on range [min, max].
+    ///
+    /// \param[in] m Metric.
+    ///
+    /// \return
+    /// Histogram.
+    inline const vector<double>&
+    get_histogram(QualityMetric m) const
+    {
+        return histograms[static_cast<size_t>(m)];
+    }
+
+    /// \brief Count of cells.
+    ///
+    /// Count of cells (global if statistics are reduced).
+    ///
+    /// \return
+    /// Count of cells.
+    inline size_t
+    cells_count() const
+    {
+        return static_cast<size_t>(cells_count_);
+    }
+
+    /// \brief Count of degenerate cells.
+    ///
+    /// Count of cells with zero area (global if statistics are reduced).
+    ///
+    /// \return
+    /// Count of degenerate cells.
+    inline size_t
+    degenerate_cells_count() const
+    {
+        return static_cast<size_t>(degenerate_cells_count_);
+    }
+
+    /// \brief Minimum value of metric.
+    ///
+    /// Minimum value of metric.
+    ///
+    /// \param[in] m Metric.
+    ///
+    /// \return
+    /// Minimum value.
+    inline double
+    min(QualityMetric m) const
+    {
+        return mins[static_cast<size_t>(m)];
+    }
+
+    /// \brief Maximum value of metric.
+    ///
+    /// Maximum value of metric.
+    ///
+    /// \param[in] m Metric.
+    ///
+    /// \return
+    /// Maximum value.
+    inline double
+    max(QualityMetric m) const
+    {
+        return maxs[static_cast<size_t>(m)];
+    }
+
+    // Mean value of metric.
+    double
+    mean(QualityMetric m) const;
+
+    // Quantile of metric.
+    double
+    quantile(QualityMetric m,
+             double q) const;
+
+    // Print function.
+    friend ostream&
+    operator<<(ostream& os,
+               const Quality& q);
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_QUALITY_H
@@ -8,6 +8,7 @@
 /// Three-dimensional surface evolution and mesh deformation for aircraft icing applications.
 
 #include "mesh_remesher.h"
+#include "mesh_quality.h"
 
 #include "utils/utils.h"
 #include "mth/mth.h"
@@ -34,18 +35,92 @@ utils::Mapper<RemeshMethod> RemeshMethodMapper
 // Common functions.
 //
 
+/// \brief Check if remeshing is distributed.
+///
+/// Remeshing is distributed if there are several processes
+/// and halo of own domain is built.
+/// In this case each process remeshes only own cells and ghost cells around them.
+///
+/// \param[in] mesh Mesh.
+///
+/// \return
+/// true - if remeshing is distributed,
+/// false - otherwise.
+bool
+Remesher::is_distributed(const Mesh& mesh)
+{
+    return (parl::mpi_size() > 1) && mesh.halo.is_built();
+}
+
+/// \brief Check if part of mesh is halo part of distributed remeshing.
+///
+/// Check if part of mesh is halo part of distributed remeshing.
+///
+/// \param[in] mesh Mesh.
+/// \param[in] h    Part of mesh.
+///
+/// \return
+/// true - if data of ghost cells and far nodes must be exchanged,
+/// false - otherwise.
+bool
+Remesher::is_halo_part(const Mesh& mesh,
+                       const NodesEdgesCellsHolder& h)
+{
+    return (&h == &mesh.halo.part) && is_distributed(mesh);
+}
+
+/// \brief Exchange values of ghost cells.
+///
+/// Ghost cells receive values from their domains.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in]     f    Field of cell.
+void
+Remesher::exchange_cells_values(Mesh& mesh,
+                                double Cell::*f)
+{
+    mesh.halo.exchange_cells(1,
+                             [f](const Cell* c, double* v) { v[0] = c->*f; },
+                             [f](Cell* c, const double* v) { c->*f = v[0]; });
+}
+
+/// \brief Exchange vectors of far nodes.
+///
+/// Far nodes receive vectors from their owners.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in]     f    Field of node.
+void
+Remesher::exchange_nodes_vectors(Mesh& mesh,
+                                 geom::Vector Node::*f)
+{
+    mesh.halo.exchange_nodes(3,
+                             [f](const Node* n, double* v)
+                             {
+                                 const geom::Vector& x { n->*f };
+
+                                 v[0] = x.x;
+                                 v[1] = x.y;
+                                 v[2] = x.z;
+                             },
+                             [f](Node* n, const double* v)
+                             {
+                                 (n->*f).set(v[0], v[1], v[2]);
+                             });
+}
+
 /// \brief Zero all ice.
 ///
 /// Zero all ice.
 ///
-/// \param[in,out] mesh Mesh.
+/// \param[in,out] h Part of mesh.
 void
-Remesher::zero_ice(Mesh& mesh)
+Remesher::zero_ice(NodesEdgesCellsHolder& h)
 {
     #pragma omp parallel for
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    for (size_t i = 0; i < h.cells_count(); ++i)
     {
-        Cell* c { mesh.all.cell(i) };
+        Cell* c { h.cell(i) };
 
         c->ice_shift = 0.0;
     }
@@ -81,57 +156,130 @@ Remesher::zero_ice_below_threshold(Mesh& mesh,
 /// Bourgault-Cote S., Hasanzadeh K., Lavoie P., Laurendeau.
 /// Multi-layer icing methodologies for conservative ice growth.
 ///
+/// If remeshing is distributed, histogram is calculated for own cells
+/// and then summed among all processes, so all processes get the same steps count.
+/// If cells with ice are given, histogram is calculated only for them,
+/// other cells of mesh are counted as cells without ice.
+///
 /// \param[in] mesh Mesh.
 /// \param[in] opts Options.
+/// \param[in] iced Cells with ice (all other cells have no ice) or nullptr.
 ///
 /// \return
 /// Count of steps for remesh.
 int
 Remesher::remeshing_nsteps(Mesh& mesh,
-                           const RemeshOptions& opts)
+                           const RemeshOptions& opts,
+                           NodesEdgesCellsHolder* iced)
 {
-    vector<int> ns;
+    bool is_dist { is_distributed(mesh) };
+    NodesEdgesCellsHolder& cs { (iced != nullptr) ? *iced : (is_dist ? mesh.own : mesh.all) };
+    size_t cc { cs.cells_count() };
     double f { opts.nsteps_hi_side_fact };
+    int n { opts.nsteps_max };
+    size_t nmax { static_cast<size_t>(max(n, 0)) };
+    Quality q;
 
-    // Form vector of iterations number for all cells.
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    q.calc(cs);
+
+    const vector<double>& min_sides { q.get_values(QualityMetric::MinSide) };
+
+    // Exact histogram of iterations numbers of cells:
+    // bin k is for k iterations (k <= nsteps_max), last bin is for all bigger numbers.
+    vector<size_t> hist(nmax + 2, 0);
+
+    #pragma omp parallel
     {
-        Cell* c { mesh.all.cell(i) };
+        vector<size_t> local(nmax + 2, 0);
+
+        #pragma omp for
+        for (size_t i = 0; i < cc; ++i)
+        {
+            double x { cs.cell(i)->ice_shift / (min_sides[i] * f) };
 
-        double min_side = geom::Vector::triangle_min_side_length(c->node(0)->point(),
-                                                                 c->node(1)->point(),
-                                                                 c->node(2)->point());
+            if (x >= static_cast<double>(n))
+            {
+                ++local[nmax + 1];
+            }
+            else
+            {
+                local[static_cast<size_t>(max(static_cast<int>(x) + 1, 0))]++;
+            }
+        }
 
-        ns.push_back(static_cast<int>(c->ice_shift / (min_side * f)) + 1);
+        #pragma omp critical
+        {
+            for (size_t i = 0; i < nmax + 2; ++i)
+            {
+                hist[i] += local[i];
+            }
+        }
     }
 
-    // Sort list of iterations number.
-    sort(ns.begin(), ns.end(), [] (int a, int b) { return a > b; });
+    // Cells without ice need one iteration.
+    size_t zero_cc { (iced != nullptr) ? (mesh.all.cells_count() - cc) : 0 };
+
+    hist[(n > 0) ? 1 : (nmax + 1)] += zero_cc;
+
+    // Sum histograms and cells counts of all processes.
+    size_t total_cc { cc + zero_cc };
+
+    if (is_dist)
+    {
+        vector<double> data(hist.begin(), hist.end());
+
+        data.push_back(static_cast<double>(cc));
+        parl::mpi_allreduce_sum(data);
+
+        for (size_t i = 0; i < nmax + 2; ++i)
+        {
+            hist[i] = static_cast<size_t>(data[i]);
+        }
+
+        total_cc = static_cast<size_t>(data.back());
+    }
 
     // Calculate how much cells we can ignore.
-    size_t may_ignore = static_cast<size_t>(static_cast<double>(ns.size())
+    size_t may_ignore = static_cast<size_t>(static_cast<double>(total_cc)
                                             * opts.nsteps_ignore_part);
 
-    // Set number of iterations in maximum.
-    int n { opts.nsteps_max };
-
-    // Check for ignored part of array.
-    if (ns[may_ignore] > n)
+    // Check for ignored part of cells.
+    if (is_dist && (hist[nmax + 1] > may_ignore))
     {
+        // Big values are distributed among processes, report only their count.
         WARNING("ignoring bad faces did not help while remeshing :"
                 " remesh_nsteps_max = " + to_string(n)
-                + ", first value after ignoring = " + to_string(ns[may_ignore]));
+                + ", bad cells = " + to_string(hist[nmax + 1]));
     }
-    else
+    else if (hist[nmax + 1] > may_ignore)
     {
-        // Ignoring helped, find correct position.
-        for (size_t i = 0; i < ns.size(); ++i)
+        // Find first value after ignoring among big values for message.
+        vector<double> big;
+
+        for (size_t i = 0; i < cc; ++i)
         {
-            int v { ns[i] };
+            double x { cs.cell(i)->ice_shift / (min_sides[i] * f) };
+
+            if (x >= static_cast<double>(n))
+            {
+                big.push_back(floor(x) + 1.0);
+            }
+        }
 
-            if (v <= n)
+        nth_element(big.begin(), big.begin() + static_cast<long>(may_ignore), big.end(), greater<double>());
+
+        WARNING("ignoring bad faces did not help while remeshing :"
+                " remesh_nsteps_max = " + to_string(n)
+                + ", first value after ignoring = " + to_string(static_cast<long>(big[may_ignore])));
+    }
+    else
+    {
+        // Ignoring helped, find the biggest number of iterations not greater than maximum.
+        for (size_t k = nmax + 1; k > 0; --k)
+        {
+            if (hist[k - 1] > 0)
             {
-                n = v;
+                n = static_cast<int>(k - 1);
 
                 break;
             }
@@ -142,28 +290,255 @@ Remesher::remeshing_nsteps(Mesh& mesh,
 }
 
 //
-// Prisms remeshing.
+// Active set.
 //
 
-/// \brief Remesh with prizm method.
+/// \brief Check if active set is used.
+///
+/// Active set is not used for distributed remeshing (warning is reported),
+/// for quality improvement (topology changes while remeshing)
+/// and for local steps of Tong method (they build own parts).
+///
+/// \param[in] mesh Mesh.
+/// \param[in] opts Options.
+///
+/// \return
+/// true - if active set is used,
+/// false - otherwise.
+bool
+Remesher::is_active_set_used(const Mesh& mesh,
+                             const RemeshOptions& opts)
+{
+    if (!opts.is_active_set)
+    {
+        return false;
+    }
+
+    if (is_distributed(mesh))
+    {
+        WARNING("active set is not supported for distributed remeshing");
+
+        return false;
+    }
+
+    return !opts.is_improve_quality
+           && !(opts.is_local_steps && (opts.method == RemeshMethod::Tong));
+}
+
+/// \brief Build active set.
+///
+/// Zero ice below threshold and collect cells with ice.
+/// Active cells are cells with ice and several layers of cells adjacent by nodes around them.
+/// Nodes of active cells are moved, cells around them are processed
+/// (as for local step of Tong method), geometry is updated for these cells,
+/// their edges and nodes.
+/// Objects of parts are marked, marks of all other objects are zeroed.
+/// Only this function scans all mesh, all remesh passes work with parts.
 ///
 /// \param[in,out] mesh Mesh.
 /// \param[in]     opts Options.
+/// \param[out]    iced Cells with ice.
+/// \param[out]    h    Part of mesh (nodes to move and cells around them).
+/// \param[out]    g    Part of mesh for geometry update.
+void
+Remesher::build_active_set(Mesh& mesh,
+                           const RemeshOptions& opts,
+                           NodesEdgesCellsHolder& iced,
+                           NodesEdgesCellsHolder& h,
+                           NodesEdgesCellsHolder& g)
+{
+    double thr { opts.hi_as_zero_threshold };
+    size_t cc { mesh.all.cells_count() };
+    vector<Cell*> active;
+
+    iced.clear();
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+    {
+        mesh.all.node(i)->set_mark(0);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < mesh.all.edges_count(); ++i)
+    {
+        mesh.all.edge(i)->set_mark(0);
+    }
+
+    // Cells with ice.
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        if (c->ice_shift < thr)
+        {
+            c->ice_shift = 0.0;
+            c->set_mark(0);
+        }
+        else
+        {
+            c->set_mark(2);
+            iced.add_cell(c);
+            active.push_back(c);
+        }
+    }
+
+    // Layers of cells around.
+    size_t beg { 0 };
+
+    for (int li = 0; li < opts.active_set_halo; ++li)
+    {
+        size_t end { active.size() };
+
+        for (size_t i = beg; i < end; ++i)
+        {
+            Cell* c { active[i] };
+
+            for (size_t j = 0; j < c->nodes_count(); ++j)
+            {
+                Node* n { c->node(j) };
+
+                for (size_t k = 0; k < n->cells_count(); ++k)
+                {
+                    Cell* nc { n->cell(k) };
+
+                    if (nc->get_mark() == 0)
+                    {
+                        nc->set_mark(2);
+                        active.push_back(nc);
+                    }
+                }
+            }
+        }
+
+        beg = end;
+    }
+
+    build_local_step_part(active, h, g);
+
+    // Nodes outside of moved part keep ice directions along normals.
+    #pragma omp parallel for
+    for (size_t i = 0; i < g.nodes_count(); ++i)
+    {
+        Node* n { g.node(i) };
+
+        n->ice_dir.set(n->normal());
+    }
+}
+
+/// \brief Unmark part of mesh.
+///
+/// Zero marks of cells, edges and nodes of part.
+///
+/// \param[in,out] g Part of mesh.
 void
+Remesher::unmark_part(NodesEdgesCellsHolder& g)
+{
+    #pragma omp parallel for
+    for (size_t i = 0; i < g.cells_count(); ++i)
+    {
+        g.cell(i)->set_mark(0);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < g.edges_count(); ++i)
+    {
+        g.edge(i)->set_mark(0);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < g.nodes_count(); ++i)
+    {
+        g.node(i)->set_mark(0);
+    }
+}
+
+//
+// Prisms remeshing.
+//
+
+/// \brief Check if cell with local steps count is processed on global step.
+///
+/// Global step i (0 .. steps-1) is performed for cell with k steps
+/// if [(i + 1) * k / steps] > [i * k / steps],
+/// so steps of cell are evenly distributed and the last global step
+/// is performed for all cells.
+///
+/// \param[in] stepi Global step.
+/// \param[in] k     Steps count of cell.
+/// \param[in] steps Global steps count.
+///
+/// \return
+/// true - if cell is processed on this step,
+/// false - otherwise.
+bool
+Remesher::is_local_step(int stepi,
+                        int k,
+                        int steps)
+{
+    return (stepi + 1) * k / steps > stepi * k / steps;
+}
+
+/// \brief Remesh with prizm method.
+///
+/// If remeshing is distributed, only own and ghost cells are processed,
+/// far nodes receive their shifts from owners.
+/// If active set is used, only nodes of cells with ice and cells around them are processed.
+/// If steps factors of cells are given, cell makes its own count of steps
+/// (steps count multiplied by factor), its ice is distributed over its steps only.
+///
+/// \param[in,out] mesh    Mesh.
+/// \param[in]     opts    Options.
+/// \param[in]     factors Steps factors of cells (indexed by identifiers) or nullptr.
+///
+/// \return
+/// Count of steps.
+int
 Remesher::remesh_prisms(Mesh& mesh,
-                        const RemeshOptions& opts)
+                        const RemeshOptions& opts,
+                        const vector<int>* factors)
 {
-    zero_ice_below_threshold(mesh, opts.hi_as_zero_threshold);
+    bool is_dist { is_distributed(mesh) };
+    bool is_active { is_active_set_used(mesh, opts) };
+    NodesEdgesCellsHolder iced, ah, ag;
 
-    int steps = remeshing_nsteps(mesh, opts);
+    if (is_dist)
+    {
+        exchange_cells_values(mesh, &Cell::ice_shift);
+    }
+
+    if (is_active)
+    {
+        build_active_set(mesh, opts, iced, ah, ag);
+    }
+    else
+    {
+        zero_ice_below_threshold(mesh, opts.hi_as_zero_threshold);
+    }
+
+    NodesEdgesCellsHolder& h { is_active ? ah : (is_dist ? mesh.halo.part : mesh.all) };
+    NodesEdgesCellsHolder& g { is_active ? ag : h };
+    int steps = remeshing_nsteps(mesh, opts, is_active ? &iced : nullptr);
+    vector<int> cells_steps(h.cells_count(), steps);
+
+    if (factors != nullptr)
+    {
+        int base_steps { steps };
+
+        for (size_t i = 0; i < h.cells_count(); ++i)
+        {
+            cells_steps[i] = base_steps * (*factors)[static_cast<size_t>(h.cell(i)->get_id())];
+            steps = max(steps, cells_steps[i]);
+        }
+    }
 
     // Init ice chunks and zero ice height.
     #pragma omp parallel for
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    for (size_t i = 0; i < h.cells_count(); ++i)
     {
-        Cell* c { mesh.all.cell(i) };
+        Cell* c { h.cell(i) };
 
-        c->ice_chunk = c->area() * c->ice_shift / steps;
+        c->ice_chunk = c->area() * c->ice_shift / cells_steps[i];
         c->ice_shift = 0.0;
     }
 
@@ -172,18 +547,26 @@ Remesher::remesh_prisms(Mesh& mesh,
     {
         // Calculate ice shifts for cells.
         #pragma omp parallel for
-        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        for (size_t ci = 0; ci < h.cells_count(); ++ci)
         {
-            Cell* c { mesh.all.cell(i) };
+            Cell* c { h.cell(ci) };
 
-            c->ice_shift = c->ice_chunk / c->area();
+            if (is_local_step(i, cells_steps[ci], steps))
+            {
+                c->ice_shift = c->ice_chunk / c->area();
+                c->work += 1.0;
+            }
+            else
+            {
+                c->ice_shift = 0.0;
+            }
         }
 
-        // Move nodes.
+        // Define nodes shifts.
         #pragma omp parallel for
-        for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+        for (size_t i = 0; i < h.nodes_count(); ++i)
         {
-            Node* n { mesh.all.node(i) };
+            Node* n { h.node(i) };
             double ice_shift = 0.0;
 
             for (size_t j = 0; j < n->cells_count(); ++j)
@@ -193,15 +576,39 @@ Remesher::remesh_prisms(Mesh& mesh,
             }
 
             ice_shift /= static_cast<double>(n->cells_count());
+            geom::Vector::mul(n->normal(), ice_shift, n->shift);
+        }
 
-            // Move node.
-            geom::Vector v;
-            geom::Vector::mul(n->normal(), ice_shift, v);
-            n->move(v);
+        if (is_dist)
+        {
+            exchange_nodes_vectors(mesh, &Node::shift);
         }
 
-        mesh.calc_geometry();
+        // Move nodes.
+        #pragma omp parallel for
+        for (size_t i = 0; i < h.nodes_count(); ++i)
+        {
+            Node* n { h.node(i) };
+
+            n->move(n->shift);
+        }
+
+        mesh.calc_geometry(g);
+
+        // Cells quality between steps.
+        if (opts.is_improve_quality && !is_dist && (i < steps - 1))
+        {
+            Topology::improve_quality(mesh, opts.quality_min_angle,
+                                      opts.quality_split_fact, opts.quality_feature_angle);
+        }
     }
+
+    if (is_active)
+    {
+        unmark_part(g);
+    }
+
+    return steps;
 }
 
 //
@@ -212,13 +619,14 @@ Remesher::remesh_prisms(Mesh& mesh,
 ///
 /// Init target ice, rest ice ice for each cell.
 ///
-/// \param[in,out] mesh Mesh.
+/// \param[in,out] h Part of mesh.
 void
-Remesher::init_target_rest_ice(Mesh& mesh)
+Remesher::init_target_rest_ice(NodesEdgesCellsHolder& h)
 {
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    #pragma omp parallel for
+    for (size_t i = 0; i < h.cells_count(); ++i)
     {
-        Cell* c { mesh.all.cell(i) };
+        Cell* c { h.cell(i) };
 
         c->target_ice = c->ice_shift * c->area();
         c->rest_ice = c->target_ice;
@@ -229,15 +637,16 @@ Remesher::init_target_rest_ice(Mesh& mesh)
 ///
 /// Calculate ice chunks.
 ///
-/// \param[in,out] mesh            Mesh.
+/// \param[in,out] h               Part of mesh.
 /// \param[in]     rest_iterations Rest iterations.
 void
-Remesher::calc_ice_chunks(Mesh& mesh,
+Remesher::calc_ice_chunks(NodesEdgesCellsHolder& h,
                           int rest_iterations)
 {
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    #pragma omp parallel for
+    for (size_t i = 0; i < h.cells_count(); ++i)
     {
-        Cell* c { mesh.all.cell(i) };
+        Cell* c { h.cell(i) };
 
         c->ice_chunk = c->rest_ice / rest_iterations;
     }
@@ -248,21 +657,23 @@ Remesher::calc_ice_chunks(Mesh& mesh,
 /// Init ice dirs.
 ///
 /// \param[in,out] mesh Mesh.
+/// \param[in,out] h    Part of mesh.
 void
-Remesher::init_ice_dirs(Mesh& mesh)
+Remesher::init_ice_dirs(Mesh& mesh,
+                        NodesEdgesCellsHolder& h)
 {
     // Cell ice dir it is just its normals.
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    mesh.for_each_cell_by_blocks(h, [&h](size_t i)
     {
-        Cell* c { mesh.all.cell(i) };
+        Cell* c { h.cell(i) };
 
         c->ice_dir.set(c->normal());
-    }
+    });
 
     // Ice dir for node is average of all incident cells ice dirs.
-    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+    mesh.for_each_node_by_blocks(h, [&h](size_t i)
     {
-        Node* n { mesh.all.node(i) };
+        Node* n { h.node(i) };
         n->ice_dir.zero();
 
         for (size_t j = 0; j < n->cells_count(); ++j)
@@ -272,32 +683,210 @@ Remesher::init_ice_dirs(Mesh& mesh)
         }
 
         n->ice_dir.normalize();
+    });
+
+    if (is_halo_part(mesh, h))
+    {
+        exchange_nodes_vectors(mesh, &Node::ice_dir);
     }
 }
 
-/// \brief Smooth normals.
+/// \brief Prepare patches for smoothing.
 ///
-/// Normals smoothing.
+/// Patches are used only for all mesh of one process.
+/// Patches are built if they are not built with current options.
 ///
 /// \param[in,out] mesh Mesh.
+/// \param[in]     h    Part of mesh.
 /// \param[in]     opts Options.
-void
-Remesher::normals_smoothing(Mesh& mesh,
-                            const RemeshOptions& opts)
+///
+/// \return
+/// true - if smoothing with patches is used,
+/// false - otherwise.
+bool
+Remesher::prepare_patches(Mesh& mesh,
+                          NodesEdgesCellsHolder& h,
+                          const RemeshOptions& opts)
 {
-    int steps { opts.nsmooth_steps };
-    double s { opts.nsmooth_s };
-    double k { opts.nsmooth_k };
-
-    for (int i = 0; i < steps; ++i)
+    if ((opts.patch_smoothing_iters <= 0) || (&h != &mesh.all) || is_distributed(mesh))
     {
-        // Smooth cells' ice directions throught nodes' ice directions.
-        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
-        {
-            Cell* c { mesh.all.cell(i) };
-            geom::Vector new_ice_dir;
+        return false;
+    }
 
-            for (size_t j = 0; j < c->nodes_count(); ++j)
+    size_t pc { static_cast<size_t>(max(opts.patch_smoothing_cells, 1)) };
+    size_t layers { static_cast<size_t>(opts.patch_smoothing_iters) };
+
+    if (!mesh.patches.is_built(mesh.all, pc, layers))
+    {
+        mesh.patches.build(mesh.all, pc, layers);
+    }
+
+    return true;
+}
+
+/// \brief Smooth normals with patches.
+///
+/// Smoothing iterations are split into blocks,
+/// in each block iterations are done for each patch with local copies of ice directions,
+/// then ice directions of core cells and owned nodes are put back.
+/// Result is the same as for iterations over all mesh.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in]     opts Options.
+void
+Remesher::normals_smoothing_patches(Mesh& mesh,
+                                    const RemeshOptions& opts)
+{
+    const Patches& ps { mesh.patches };
+    size_t pc { ps.patches_count() };
+    size_t cc { mesh.all.cells_count() }, nc { mesh.all.nodes_count() };
+    int steps { opts.nsmooth_steps };
+    int iters { opts.patch_smoothing_iters };
+    double s { opts.nsmooth_s };
+    double k { opts.nsmooth_k };
+    vector<geom::Vector> cells_dirs(cc), nodes_dirs(nc);
+
+    for (int bi = 0; bi < steps; bi += iters)
+    {
+        int block_steps { min(iters, steps - bi) };
+
+        #pragma omp parallel
+        {
+            vector<geom::Vector> cd, nd;
+            vector<double> ca;
+
+            #pragma omp for schedule(dynamic)
+            for (size_t pi = 0; pi < pc; ++pi)
+            {
+                const Patch& p { ps.patch(pi) };
+                size_t pcc { p.cells.size() }, pnc { p.nodes.size() };
+
+                cd.resize(pcc);
+                nd.resize(pnc);
+                ca.resize(pcc);
+
+                for (size_t i = 0; i < pcc; ++i)
+                {
+                    cd[i].set(p.cells[i]->ice_dir);
+                    ca[i] = p.cells[i]->area();
+                }
+
+                for (size_t i = 0; i < pnc; ++i)
+                {
+                    nd[i].set(p.nodes[i]->ice_dir);
+                }
+
+                for (int it = 0; it < block_steps; ++it)
+                {
+                    // Smooth cells' ice directions throught nodes' ice directions.
+                    for (size_t i = 0; i < pcc; ++i)
+                    {
+                        geom::Vector new_ice_dir;
+
+                        for (size_t j = 0; j < 3; ++j)
+                        {
+                            const geom::Vector& n_ice_dir { nd[p.cells_nodes[3 * i + j]] };
+                            double w { max(s * (1.0 - (cd[i] * n_ice_dir)), k) };
+
+                            geom::Vector::fma(n_ice_dir, w, new_ice_dir, new_ice_dir);
+                        }
+
+                        new_ice_dir.normalize();
+                        cd[i].set(new_ice_dir);
+                    }
+
+                    // Smooth nodes' ice directions throught cells' ice directions.
+                    for (size_t i = 0; i < pnc; ++i)
+                    {
+                        geom::Vector new_ice_dir;
+
+                        for (size_t j = p.nodes_cells_offsets[i]; j < p.nodes_cells_offsets[i + 1]; ++j)
+                        {
+                            size_t ci { p.nodes_cells[j] };
+
+                            // Node with cell outside of patch is not used.
+                            if (ci == Patch::npos)
+                            {
+                                continue;
+                            }
+
+                            geom::Vector::fma(cd[ci], 1.0 / ca[ci], new_ice_dir, new_ice_dir);
+                        }
+
+                        new_ice_dir.normalize();
+                        nd[i].set(new_ice_dir);
+                    }
+                }
+
+                for (size_t i = 0; i < p.core_count; ++i)
+                {
+                    cells_dirs[static_cast<size_t>(p.cells[i]->get_id())].set(cd[i]);
+                }
+
+                for (size_t i : p.own_nodes)
+                {
+                    nodes_dirs[static_cast<size_t>(p.nodes[i]->get_id())].set(nd[i]);
+                }
+            }
+        }
+
+        // Put ice directions back.
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t pi = 0; pi < pc; ++pi)
+        {
+            const Patch& p { ps.patch(pi) };
+
+            for (size_t i = 0; i < p.core_count; ++i)
+            {
+                Cell* c { p.cells[i] };
+
+                c->ice_dir.set(cells_dirs[static_cast<size_t>(c->get_id())]);
+            }
+
+            for (size_t i : p.own_nodes)
+            {
+                Node* n { p.nodes[i] };
+
+                n->ice_dir.set(nodes_dirs[static_cast<size_t>(n->get_id())]);
+            }
+        }
+    }
+}
+
+/// \brief Smooth normals.
+///
+/// Normals smoothing.
+/// If patches are used for all mesh, smoothing is done with patches.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] h    Part of mesh.
+/// \param[in]     opts Options.
+void
+Remesher::normals_smoothing(Mesh& mesh,
+                            NodesEdgesCellsHolder& h,
+                            const RemeshOptions& opts)
+{
+    if (prepare_patches(mesh, h, opts))
+    {
+        normals_smoothing_patches(mesh, opts);
+
+        return;
+    }
+
+    int steps { opts.nsmooth_steps };
+    double s { opts.nsmooth_s };
+    double k { opts.nsmooth_k };
+    bool is_halo { is_halo_part(mesh, h) };
+
+    for (int i = 0; i < steps; ++i)
+    {
+        // Smooth cells' ice directions throught nodes' ice directions.
+        mesh.for_each_cell_by_blocks(h, [&h, s, k](size_t i)
+        {
+            Cell* c { h.cell(i) };
+            geom::Vector new_ice_dir;
+
+            for (size_t j = 0; j < c->nodes_count(); ++j)
             {
                 Node* n { c->node(j) };
                 double w { max(s * (1.0 - (c->ice_dir * n->ice_dir)), k) };
@@ -307,12 +896,12 @@ Remesher::normals_smoothing(Mesh& mesh,
 
             new_ice_dir.normalize();
             c->ice_dir.set(new_ice_dir);
-        }
+        });
 
         // Smooth nodes' ice directions throught cells' ice directions.
-        for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+        mesh.for_each_node_by_blocks(h, [&h](size_t i)
         {
-            Node* n { mesh.all.node(i) };
+            Node* n { h.node(i) };
             geom::Vector new_ice_dir;
 
             for (size_t j = 0; j < n->cells_count(); ++j)
@@ -325,239 +914,768 @@ Remesher::normals_smoothing(Mesh& mesh,
 
             new_ice_dir.normalize();
             n->ice_dir.set(new_ice_dir);
+        });
+
+        if (is_halo)
+        {
+            exchange_nodes_vectors(mesh, &Node::ice_dir);
         }
     }
 }
 
-/// \brief Define ice shifts.
+/// \brief Coefficients for ice shifts calculation.
 ///
-/// Define ice shifts.
+/// Volume of prismatoid over cell is a * h + b * h^2,
+/// where h is ice shift of cell and nodes are shifted along their ice directions.
+/// Geometry of cells is gathered into batch buffers of the part of mesh.
 ///
-/// \param[in,out] mesh Mesh.
+/// \param[in]  mesh Mesh.
+/// \param[in]  h    Part of mesh.
+/// \param[out] as   Coefficients a.
+/// \param[out] bs   Coefficients b.
 void
-Remesher::define_ice_shifts(Mesh& mesh)
+Remesher::calc_ice_shifts_coefficients(const Mesh& mesh,
+                                       NodesEdgesCellsHolder& h,
+                                       vector<double>& as,
+                                       vector<double>& bs)
 {
-    static double small_value { 1.0e-10 };
+    size_t cc { h.cells_count() };
+    CellsBatch& b { h.batch };
 
-    // Define ice shifts for cells.
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    b.resize(cc);
+
+    // Gather cells geometry.
+    mesh.for_each_cell_by_blocks(h, [&h, &b](size_t i)
     {
-        Cell* c { mesh.all.cell(i) };
-        c->ice_shift = c->ice_chunk / c->area();
+        Cell* c { h.cell(i) };
+
+        b.p1.set(i, c->node(0)->point());
+        b.p2.set(i, c->node(1)->point());
+        b.p3.set(i, c->node(2)->point());
+        b.q1.set(i, c->node(0)->ice_dir);
+        b.q2.set(i, c->node(1)->ice_dir);
+        b.q3.set(i, c->node(2)->ice_dir);
+        b.n.set(i, c->normal());
+    });
+
+    geom::prismatoid_volume_coefficients(b.p1, b.p2, b.p3, b.q1, b.q2, b.q3, b.n, as, bs, b.c);
+}
 
-        // Trying to calculate ice_shift more accurately.
-        if (c->ice_chunk > small_value)
-        {
-            double a { 0.0 }, b { 0.0 }, not_used { 0.0 };
+/// \brief Ice shift of cell.
+///
+/// Ice shift is calculated as root of equation a * h + b * h^2 = ice_chunk,
+/// if there is no good root, it is ice chunk divided by area.
+///
+/// \param[in] ice_chunk Ice chunk.
+/// \param[in] area      Area.
+/// \param[in] a         Coefficient a.
+/// \param[in] b         Coefficient b.
+///
+/// \return
+/// Ice shift.
+double
+Remesher::calc_cell_ice_shift(double ice_chunk,
+                              double area,
+                              double a,
+                              double b)
+{
+    static double small_value { 1.0e-10 };
+    double ice_shift { ice_chunk / area };
 
-            geom::prismatoid_volume_coefficients(c->node(0)->point(),
-                                                 c->node(1)->point(),
-                                                 c->node(2)->point(),
-                                                 c->node(0)->ice_dir,
-                                                 c->node(1)->ice_dir,
-                                                 c->node(2)->ice_dir,
-                                                 c->normal(),
-                                                 a, b, not_used);
+    // Trying to calculate ice_shift more accurately.
+    if (ice_chunk > small_value)
+    {
+        if (abs(b) > small_value)
+        {
+            double d { a * a + 4.0 * b * ice_chunk };
 
-            if (abs(b) > small_value)
+            if (d >= 0.0)
             {
-                double d { a * a + 4.0 * b * c->ice_chunk };
+                d = sqrt(d);
 
-                if (d >= 0.0)
-                {
-                    d = sqrt(d);
-
-                    double h1 { (-a + d) / (2.0 * b) };
-                    double h2 { (-a - d) / (2.0 * b) };
+                double h1 { (-a + d) / (2.0 * b) };
+                double h2 { (-a - d) / (2.0 * b) };
 
-                    if ((h1 >= 0.0) && (h2 >= 0.0))
-                    {
-                        c->ice_shift = min(h1, h2);
-                    }
-                    else if (h1 >= 0.0)
-                    {
-                        c->ice_shift = h1;
-                    }
-                    else if (h2 >= 0.0)
-                    {
-                        c->ice_shift = h2;
-                    }
+                if ((h1 >= 0.0) && (h2 >= 0.0))
+                {
+                    ice_shift = min(h1, h2);
+                }
+                else if (h1 >= 0.0)
+                {
+                    ice_shift = h1;
+                }
+                else if (h2 >= 0.0)
+                {
+                    ice_shift = h2;
                 }
             }
         }
     }
 
+    return ice_shift;
+}
+
+/// \brief Define ice shifts.
+///
+/// Define ice shifts.
+///
+/// \param[in]     mesh Mesh.
+/// \param[in,out] h    Part of mesh.
+void
+Remesher::define_ice_shifts(const Mesh& mesh,
+                            NodesEdgesCellsHolder& h)
+{
+    vector<double>& as { h.batch.a };
+    vector<double>& bs { h.batch.b };
+
+    calc_ice_shifts_coefficients(mesh, h, as, bs);
+
+    // Define ice shifts for cells.
+    mesh.for_each_cell_by_blocks(h, [&h, &as, &bs](size_t i)
+    {
+        Cell* c { h.cell(i) };
+
+        c->ice_shift = calc_cell_ice_shift(c->ice_chunk, c->area(), as[i], bs[i]);
+    });
+
     // Define ice shifts for all nodes.
-    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+    mesh.for_each_node_by_blocks(h, [&h](size_t i)
     {
-        Node* n { mesh.all.node(i) };
+        Node* n { h.node(i) };
 
         n->calc_ice_shift();
+    });
+}
+
+/// \brief Flow of ice volume while heights smoothing.
+///
+/// Volume of ice which flows from cell to neighbour cell through common edge
+/// (volume flows from higher ice to lower one).
+///
+/// \param[in] h           Ice shift of cell.
+/// \param[in] ice_chunk   Ice chunk of cell.
+/// \param[in] area        Area of cell.
+/// \param[in] nh          Ice shift of neighbour cell.
+/// \param[in] n_ice_chunk Ice chunk of neighbour cell.
+/// \param[in] n_area      Area of neighbour cell.
+/// \param[in] alfa        Heights smoothing parameter.
+/// \param[in] max_h       Maximum ice shift.
+///
+/// \return
+/// Flow volume (negative if ice flows from neighbour to cell).
+double
+Remesher::heights_smoothing_flow(double h,
+                                 double ice_chunk,
+                                 double area,
+                                 double nh,
+                                 double n_ice_chunk,
+                                 double n_area,
+                                 double alfa,
+                                 double max_h)
+{
+    double h1 { h }, chunk1 { ice_chunk }, area1 { area }, h2 { nh };
+    double sign { 1.0 };
+
+    // We suppose h1 > h2
+    if (h1 < h2)
+    {
+        h1 = nh;
+        chunk1 = n_ice_chunk;
+        area1 = n_area;
+        h2 = h;
+        sign = -1.0;
+    }
+
+    // Calculate delta volume.
+    double mid_area { 0.0 };
+
+    if (h1 > 0.0)
+    {
+        mid_area = chunk1 / h1;
+    }
+    else
+    {
+        mid_area = area1;
     }
+
+    return sign * mid_area * min(h1 - h2, alfa * max_h);
 }
 
-/// \brief Smoothing heights.
+/// \brief Flow of ice volume while heights smoothing.
 ///
-/// Heights smoothing.
+/// Volume of ice which flows from cell to neighbour cell through common edge
+/// (volume flows from higher ice to lower one).
+///
+/// \param[in] c     Cell.
+/// \param[in] nc    Neighbour cell.
+/// \param[in] alfa  Heights smoothing parameter.
+/// \param[in] max_h Maximum ice shift.
+///
+/// \return
+/// Flow volume (negative if ice flows from neighbour to cell).
+double
+Remesher::heights_smoothing_flow(const Cell* c,
+                                 const Cell* nc,
+                                 double alfa,
+                                 double max_h)
+{
+    return heights_smoothing_flow(c->ice_shift, c->ice_chunk, c->area(),
+                                  nc->ice_shift, nc->ice_chunk, nc->area(),
+                                  alfa, max_h);
+}
+
+/// \brief Implicit smoothing heights.
+///
+/// Explicit smoothing moves volume mid_area * beta * (h1 - h2) through each inner edge
+/// on each of hsmooth_steps iterations.
+/// Implicit smoothing makes one step with tau = beta * hsmooth_steps:
+/// (M + tau * L) x = M h,
+/// where M is diagonal matrix of mid areas of cells (ice chunk / ice shift),
+/// L is laplacian of cells graph with edge weights equal to mean mid areas of cells.
+/// System is symmetric positive definite, it is solved with conjugate gradients.
+/// Then volumes which flow through edges are calculated from solution x,
+/// so total ice volume is conserved exactly.
+/// Ice does not flow outside the part of mesh.
 ///
 /// \param[in,out] mesh Mesh.
+/// \param[in,out] h    Part of mesh.
 /// \param[in]     opts Options.
 void
-Remesher::heights_smoothing(Mesh& mesh,
-                            const RemeshOptions& opts)
+Remesher::heights_smoothing_implicit(Mesh& mesh,
+                                     NodesEdgesCellsHolder& h,
+                                     const RemeshOptions& opts)
 {
-    int steps { opts.hsmooth_steps };
-    double alfa { opts.hsmooth_alfa };
-    double beta { opts.hsmooth_beta };
+    const size_t npos { static_cast<size_t>(-1) };
+    size_t cc { h.cells_count() };
+    double tau { opts.hsmooth_beta * static_cast<double>(opts.hsmooth_steps) };
+    vector<size_t> loc(mesh.all.cells_count(), npos);
+    vector<double> ms(cc), hs(cc), rs(cc);
 
-    for (int i = 0; i < steps; ++i)
+    // Local indices of cells and mid areas.
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
     {
-        double max_h { 0.0 };
+        Cell* c { h.cell(i) };
 
-        // While redistributing we work with local ice chunks.
-        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
-        {
-            Cell* c { mesh.all.cell(i) };
+        loc[static_cast<size_t>(c->get_id())] = i;
+        hs[i] = c->ice_shift;
+        ms[i] = (c->ice_shift > 0.0) ? (c->ice_chunk / c->ice_shift) : 0.0;
 
-            c->loc_ice_chunk = c->ice_chunk;
+        if (ms[i] <= 0.0)
+        {
+            ms[i] = c->area();
         }
 
-        // Calculate max h.
-        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
-        {
-            Cell* c { mesh.all.cell(i) };
+        rs[i] = ms[i] * hs[i];
+    }
 
-            max_h = max(max_h, c->ice_shift);
-        }
+    // Neighbours of cells inside the part.
+    vector<size_t> offsets(cc + 1, 0), cols;
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { h.cell(i) };
+
+        cols.push_back(i);
 
-        // Process all inner edges.
-        for (size_t i = 0; i < mesh.all.edges_count(); ++i)
+        for (size_t j = 0; j < c->edges_count(); ++j)
         {
-            Edge* e { mesh.all.edge(i) };
-            double mid_area { 0.0 }, delta_v { 0.0 };
+            Edge* e { c->edge(j) };
 
             if (!e->is_inner())
             {
                 continue;
             }
 
-            Cell* c1 { e->cell(0) };
-            Cell* c2 { e->cell(1) };
+            Cell* nc { (e->cell(0) == c) ? e->cell(1) : e->cell(0) };
+            size_t ni { loc[static_cast<size_t>(nc->get_id())] };
 
-            // We suppose h1 > h2
-            if (c1->ice_shift < c2->ice_shift)
+            if (ni != npos)
             {
-                Cell* c_tmp { c1 };
-
-                c1 = c2;
-                c2 = c_tmp;
+                cols.push_back(ni);
             }
+        }
 
-            // Calculate delta volume.
+        offsets[i + 1] = cols.size();
+    }
 
-            if (c1->ice_shift > 0.0)
-            {
-                mid_area = c1->ice_chunk / c1->ice_shift;
-            }
-            else
-            {
-                mid_area = c1->area();
-            }
+    // Matrix M + tau * L.
+    mth::SparseMatrix a;
 
-            delta_v = mid_area * min(c1->ice_shift - c2->ice_shift,
-                                     alfa * max_h);
+    a.set_structure(offsets, cols);
 
-            // Redistribute volume.
-            c1->loc_ice_chunk -= beta * delta_v;
-            c2->loc_ice_chunk += beta * delta_v;
-        }
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        a.add(i, i, ms[i]);
 
-        // Put local ice chunks back.
-        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        for (size_t k = offsets[i] + 1; k < offsets[i + 1]; ++k)
         {
-            Cell* c { mesh.all.cell(i) };
+            size_t ni { cols[k] };
+            double w { tau * 0.5 * (ms[i] + ms[ni]) };
 
-            c->ice_chunk  = c->loc_ice_chunk;
+            a.add(i, i, w);
+            a.add(i, ni, -w);
         }
-
-        // Define ice shifts again.
-        define_ice_shifts(mesh);
     }
-}
 
-/// \brief Move nodes.
-///
-/// Move nodes.
-///
-/// \param[in,out] mesh Mesh.
-void
-Remesher::move_nodes(Mesh& mesh)
-{
-    // Define shifts.
-    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
-    {
-        Node* n { mesh.all.node(i) };
+    vector<double> xs(hs);
+    size_t iters { 0 };
 
-        geom::Vector::mul(n->ice_dir, n->ice_shift, n->shift);
+    if (!mth::solve_conjugate_gradients(a, rs, xs, opts.hsmooth_implicit_eps,
+                                        static_cast<size_t>(opts.hsmooth_implicit_max_iters), iters))
+    {
+        WARNING("implicit heights smoothing solver does not converge");
     }
 
-    // Update rest and actual ice volumes.
-    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    // Volumes flow through edges.
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
     {
-        Cell* c { mesh.all.cell(i) };
-
-        const geom::Vector& p1 { c->node(0)->point() };
-        const geom::Vector& p2 { c->node(1)->point() };
-        const geom::Vector& p3 { c->node(2)->point() };
-        geom::Vector np1, np2, np3;
-
-        geom::Vector::add(p1, c->node(0)->shift, np1);
-        geom::Vector::add(p2, c->node(1)->shift, np2);
-        geom::Vector::add(p3, c->node(2)->shift, np3);
-
-        double v { geom::displaced_triangle_volume(p1, p2, p3,
-                                                   np1, np2, np3) };
+        Cell* c { h.cell(i) };
+        double flow { 0.0 };
 
-        c->rest_ice -= v;
-
-        if (c->rest_ice < 0.0)
+        for (size_t k = offsets[i] + 1; k < offsets[i + 1]; ++k)
         {
-            c->rest_ice = 0.0;
+            size_t ni { cols[k] };
+
+            flow += tau * 0.5 * (ms[i] + ms[ni]) * (xs[i] - xs[ni]);
         }
+
+        c->loc_ice_chunk = c->ice_chunk - flow;
     }
 
-    // Move nodes.
-    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+    // Put local ice chunks back.
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
     {
-        Node* n { mesh.all.node(i) };
+        Cell* c { h.cell(i) };
 
-        n->move(n->shift);
+        c->ice_chunk = c->loc_ice_chunk;
     }
+
+    define_ice_shifts(mesh, h);
 }
 
-/// \brief Calculate laplacian for null-space smoothing.
+/// \brief Smoothing heights with patches.
 ///
-/// Calculate laplacian.
+/// Smoothing iterations are split into blocks,
+/// in each block iterations are done for each patch with local copies of ice chunks and shifts,
+/// then ice chunks and shifts of core cells are put back.
+/// Flow through edge is limited by alfa * maximum ice shift of all mesh,
+/// which is known only in the beginning of block.
+/// On next iterations of block maximum ice shift of core cells of patch is its lower bound,
+/// so flow is exact if difference of ice shifts does not exceed alfa * this bound.
+/// If limiter may be active in any patch, patches results are dropped
+/// and iterations of block are done over all mesh (with colors if edges are colored).
+/// So result is the same as for iterations over all mesh.
+/// Coefficients for ice shifts calculation do not change while smoothing,
+/// so they are calculated once.
 ///
-/// \param[in]  node Node.
-/// \param[out] dv   Result.
+/// \param[in,out] mesh Mesh.
+/// \param[in]     opts Options.
 void
-Remesher::calc_laplacian(Node* node,
-                         geom::Vector& dv)
+Remesher::heights_smoothing_patches(Mesh& mesh,
+                                    const RemeshOptions& opts)
 {
-    double weights { 0.0 };
+    const Patches& ps { mesh.patches };
+    size_t pc { ps.patches_count() };
+    size_t cc { mesh.all.cells_count() };
+    int steps { opts.hsmooth_steps };
+    int iters { opts.patch_smoothing_iters };
+    double alfa { opts.hsmooth_alfa };
+    double beta { opts.hsmooth_beta };
+    vector<double> as, bs, chunks(cc), shifts(cc);
 
-    dv.zero();
+    calc_ice_shifts_coefficients(mesh, mesh.all, as, bs);
 
-    for (size_t i = 0; i < node->cells_count(); ++i)
+    for (int bi = 0; bi < steps; bi += iters)
     {
-        Cell* c { node->cell(i) };
-        double weight { 0.0 };
-        geom::Vector to_center;
+        int block_steps { min(iters, steps - bi) };
+        double max_h { 0.0 };
+        bool is_exact { true };
 
-        weight = c->area() / c->saved_area;
-        geom::Vector::sub(c->center(), node->point(), to_center);
-        to_center.mul(weight);
+        // Calculate max h.
+        #pragma omp parallel for reduction(max:max_h)
+        for (size_t i = 0; i < cc; ++i)
+        {
+            max_h = max(max_h, mesh.all.cell(i)->ice_shift);
+        }
+
+        #pragma omp parallel
+        {
+            vector<double> ch, sh, ar, ca, cb, loc;
+
+            #pragma omp for schedule(dynamic)
+            for (size_t pi = 0; pi < pc; ++pi)
+            {
+                bool is_block_exact { true };
+
+                #pragma omp atomic read
+                is_block_exact = is_exact;
+
+                // Block is done over all mesh anyway.
+                if (!is_block_exact)
+                {
+                    continue;
+                }
+
+                const Patch& p { ps.patch(pi) };
+                size_t pcc { p.cells.size() };
+                double lim_h { max_h };
+
+                ch.resize(pcc);
+                sh.resize(pcc);
+                ar.resize(pcc);
+                ca.resize(pcc);
+                cb.resize(pcc);
+                loc.resize(pcc);
+
+                for (size_t i = 0; i < pcc; ++i)
+                {
+                    Cell* c { p.cells[i] };
+                    size_t ci { static_cast<size_t>(c->get_id()) };
+
+                    ch[i] = c->ice_chunk;
+                    sh[i] = c->ice_shift;
+                    ar[i] = c->area();
+                    ca[i] = as[ci];
+                    cb[i] = bs[ci];
+                }
+
+                for (int it = 0; (it < block_steps) && is_block_exact; ++it)
+                {
+                    for (size_t i = 0; i < pcc; ++i)
+                    {
+                        double flow { 0.0 };
+
+                        for (size_t j = 0; j < 3; ++j)
+                        {
+                            size_t ni { p.cells_neighbours[3 * i + j] };
+
+                            // Border edge or neighbour outside of patch.
+                            if (ni == Patch::npos)
+                            {
+                                continue;
+                            }
+
+                            // Limiter with unknown maximum ice shift may be active.
+                            if ((it > 0) && (abs(sh[i] - sh[ni]) > alfa * lim_h))
+                            {
+                                is_block_exact = false;
+                            }
+
+                            flow += heights_smoothing_flow(sh[i], ch[i], ar[i],
+                                                           sh[ni], ch[ni], ar[ni],
+                                                           alfa, lim_h);
+                        }
+
+                        loc[i] = ch[i] - beta * flow;
+                    }
+
+                    lim_h = 0.0;
+
+                    for (size_t i = 0; i < pcc; ++i)
+                    {
+                        ch[i] = loc[i];
+                        sh[i] = calc_cell_ice_shift(ch[i], ar[i], ca[i], cb[i]);
+
+                        if (i < p.core_count)
+                        {
+                            lim_h = max(lim_h, sh[i]);
+                        }
+                    }
+                }
+
+                if (!is_block_exact)
+                {
+                    #pragma omp atomic write
+                    is_exact = false;
+
+                    continue;
+                }
+
+                for (size_t i = 0; i < p.core_count; ++i)
+                {
+                    size_t ci { static_cast<size_t>(p.cells[i]->get_id()) };
+
+                    chunks[ci] = ch[i];
+                    shifts[ci] = sh[i];
+                }
+            }
+        }
+
+        if (!is_exact)
+        {
+            // Iterations of block over all mesh.
+            RemeshOptions block_opts { opts };
+
+            block_opts.hsmooth_steps = block_steps;
+            block_opts.patch_smoothing_iters = 0;
+            heights_smoothing(mesh, mesh.all, block_opts);
+
+            continue;
+        }
+
+        // Put ice chunks and shifts back.
+        #pragma omp parallel for
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+
+            c->ice_chunk = chunks[i];
+            c->loc_ice_chunk = chunks[i];
+            c->ice_shift = shifts[i];
+        }
+    }
+
+    // Define ice shifts for all nodes.
+    #pragma omp parallel for
+    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+    {
+        mesh.all.node(i)->calc_ice_shift();
+    }
+}
+
+/// \brief Smoothing heights.
+///
+/// Heights smoothing.
+/// If all mesh edges are colored flows are scattered to incident cells
+/// with color by color edges sweep.
+/// Otherwise each cell gathers flows through all its inner edges.
+/// In both cases cells are processed independently (Jacobi style)
+/// and result does not depend on threads count.
+/// If only part of mesh is processed, its cells must be marked,
+/// ice flows only through edges between them.
+/// For halo part of distributed remeshing marks are not needed:
+/// ghost cells receive ice chunks from their domains after each iteration.
+/// If patches are used for all mesh, smoothing is done with patches
+/// (blocks of iterations where patches may be inexact are done over all mesh).
+/// Implicit smoothing is used instead of iterations if it is set in options
+/// (not for halo part of distributed remeshing).
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] h    Part of mesh.
+/// \param[in]     opts Options.
+void
+Remesher::heights_smoothing(Mesh& mesh,
+                            NodesEdgesCellsHolder& h,
+                            const RemeshOptions& opts)
+{
+    if (opts.is_hsmooth_implicit && !is_halo_part(mesh, h))
+    {
+        if (opts.hsmooth_steps > 0)
+        {
+            heights_smoothing_implicit(mesh, h, opts);
+        }
+
+        return;
+    }
+
+    if (prepare_patches(mesh, h, opts))
+    {
+        heights_smoothing_patches(mesh, opts);
+
+        return;
+    }
+
+    int steps { opts.hsmooth_steps };
+    double alfa { opts.hsmooth_alfa };
+    double beta { opts.hsmooth_beta };
+    size_t cc { h.cells_count() };
+    bool is_halo { is_halo_part(mesh, h) };
+    bool is_part { (&h != &mesh.all) && !is_halo };
+    bool is_colored { (&h == &mesh.all)
+                      && mesh.is_own_edges_colored()
+                      && (mesh.own.edges_count() == mesh.all.edges_count()) };
+
+    for (int i = 0; i < steps; ++i)
+    {
+        double max_h { 0.0 };
+
+        // Calculate max h.
+        #pragma omp parallel for reduction(max:max_h)
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { h.cell(i) };
+
+            max_h = max(max_h, c->ice_shift);
+        }
+
+        if (is_halo)
+        {
+            vector<double> data { max_h };
+
+            parl::mpi_allreduce_max(data);
+            max_h = data[0];
+        }
+
+        // While redistributing we work with local ice chunks.
+        if (is_colored)
+        {
+            mesh.for_each_cell_by_blocks(h, [&h](size_t i)
+            {
+                Cell* c { h.cell(i) };
+
+                c->loc_ice_chunk = c->ice_chunk;
+            });
+
+            // Edges of one color do not share cells.
+            mesh.for_each_edge_colored([alfa, beta, max_h](Edge* e)
+            {
+                if (e->is_inner())
+                {
+                    Cell* c1 { e->cell(0) };
+                    Cell* c2 { e->cell(1) };
+                    double dv { beta * heights_smoothing_flow(c1, c2, alfa, max_h) };
+
+                    c1->loc_ice_chunk -= dv;
+                    c2->loc_ice_chunk += dv;
+                }
+            });
+        }
+        else
+        {
+            mesh.for_each_cell_by_blocks(h, [&h, is_part, alfa, beta, max_h](size_t i)
+            {
+                Cell* c { h.cell(i) };
+                double flow { 0.0 };
+
+                for (size_t j = 0; j < c->edges_count(); ++j)
+                {
+                    Edge* e { c->edge(j) };
+
+                    if (!e->is_inner())
+                    {
+                        continue;
+                    }
+
+                    Cell* nc { (e->cell(0) == c) ? e->cell(1) : e->cell(0) };
+
+                    // Ice does not flow outside the part of mesh.
+                    if (is_part && (nc->get_mark() == 0))
+                    {
+                        continue;
+                    }
+
+                    flow += heights_smoothing_flow(c, nc, alfa, max_h);
+                }
+
+                c->loc_ice_chunk = c->ice_chunk - beta * flow;
+            });
+        }
+
+        // Put local ice chunks back.
+        mesh.for_each_cell_by_blocks(h, [&h](size_t i)
+        {
+            Cell* c { h.cell(i) };
+
+            c->ice_chunk = c->loc_ice_chunk;
+        });
+
+        if (is_halo)
+        {
+            exchange_cells_values(mesh, &Cell::ice_chunk);
+        }
+
+        // Define ice shifts again.
+        define_ice_shifts(mesh, h);
+    }
+}
+
+/// \brief Move nodes.
+///
+/// Move nodes.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] h    Part of mesh.
+void
+Remesher::move_nodes(Mesh& mesh,
+                     NodesEdgesCellsHolder& h)
+{
+    // Define shifts.
+    mesh.for_each_node_by_blocks(h, [&h](size_t i)
+    {
+        Node* n { h.node(i) };
+
+        geom::Vector::mul(n->ice_dir, n->ice_shift, n->shift);
+    });
+
+    if (is_halo_part(mesh, h))
+    {
+        exchange_nodes_vectors(mesh, &Node::shift);
+    }
+
+    size_t cc { h.cells_count() };
+    CellsBatch& b { h.batch };
+    vector<double>& vs { b.a };
+
+    b.resize(cc);
+
+    // Gather old and new positions of cells nodes.
+    mesh.for_each_cell_by_blocks(h, [&h, &b](size_t i)
+    {
+        Cell* c { h.cell(i) };
+        geom::Vector np;
+
+        b.p1.set(i, c->node(0)->point());
+        b.p2.set(i, c->node(1)->point());
+        b.p3.set(i, c->node(2)->point());
+        geom::Vector::add(c->node(0)->point(), c->node(0)->shift, np);
+        b.q1.set(i, np);
+        geom::Vector::add(c->node(1)->point(), c->node(1)->shift, np);
+        b.q2.set(i, np);
+        geom::Vector::add(c->node(2)->point(), c->node(2)->shift, np);
+        b.q3.set(i, np);
+    });
+
+    geom::displaced_triangle_volume(b.p1, b.p2, b.p3, b.q1, b.q2, b.q3, vs);
+
+    // Update rest and actual ice volumes.
+    mesh.for_each_cell_by_blocks(h, [&h, &vs](size_t i)
+    {
+        Cell* c { h.cell(i) };
+
+        c->rest_ice -= vs[i];
+
+        if (c->rest_ice < 0.0)
+        {
+            c->rest_ice = 0.0;
+        }
+    });
+
+    // Move nodes.
+    mesh.for_each_node_by_blocks(h, [&h](size_t i)
+    {
+        Node* n { h.node(i) };
+
+        n->move(n->shift);
+    });
+}
+
+/// \brief Calculate laplacian for null-space smoothing.
+///
+/// Calculate laplacian.
+///
+/// \param[in]  node Node.
+/// \param[out] dv   Result.
+void
+Remesher::calc_laplacian(Node* node,
+                         geom::Vector& dv)
+{
+    double weights { 0.0 };
+
+    dv.zero();
+
+    for (size_t i = 0; i < node->cells_count(); ++i)
+    {
+        Cell* c { node->cell(i) };
+        double weight { 0.0 };
+        geom::Vector to_center;
+
+        weight = c->area() / c->saved_area;
+        geom::Vector::sub(c->center(), node->point(), to_center);
+        to_center.mul(weight);
         dv.add(to_center);
         weights += weight;
     }
@@ -576,9 +1694,13 @@ Remesher::calc_laplacian(Node* node,
 ///    Face offsetting: A unified approach for explicit moving interfaces.
 /// 
 /// \param[in,out] mesh Mesh.
+/// \param[in,out] h    Part of mesh (nodes to move and cells around them).
+/// \param[in,out] g    Part of mesh for geometry update.
 /// \param[in]     opts Options.
 void
 Remesher::null_space_smoothing(Mesh& mesh,
+                               NodesEdgesCellsHolder& h,
+                               NodesEdgesCellsHolder& g,
                                const RemeshOptions& opts)
 {
     int steps { opts.nss_steps };
@@ -594,105 +1716,89 @@ Remesher::null_space_smoothing(Mesh& mesh,
     for (int stepi = 0; stepi < steps; ++stepi)
     {
         // Save cells area.
-        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        mesh.for_each_cell_by_blocks(h, [&h](size_t i)
         {
-            Cell* c { mesh.all.cell(i) };
+            Cell* c { h.cell(i) };
 
             c->calc_area();
             c->saved_area = c->area();
-        }
+        });
 
         // Loop for all nodes.
-        for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+        mesh.for_each_node_by_blocks(h, [&h, epsilon, st](size_t i)
         {
-            Node* node { mesh.all.node(i) };
+            Node* node { h.node(i) };
 
             node->shift.zero();
 
             if (!node->is_inner())
             {
                 // Process only inner nodes.
-                continue;
+                return;
             }
 
-            // Create matrix of normals.
-            vector<vector<double>> m;
+            // Quadric A^T * W * A, where rows of A are cells normals
+            // and W is diagonal matrix of cells areas.
+            mth::Mat<3, 3> a;
+
             for (size_t j = 0; j < node->cells_count(); ++j)
             {
                 Cell* c { node->cell(j) };
+                const geom::Vector& n { c->normal() };
+                mth::Vec<3> nv { n.x, n.y, n.z };
 
-                m.push_back(vector<double> { c->normal().x, c->normal().y, c->normal().z });
-            }
-
-            // Transpose matrix.
-            vector<vector<double>> tm;
-            mth::transpose(m, tm);
-
-            // Create matrix of areas.
-            vector<vector<double>> w(node->cells_count(), vector<double>(node->cells_count(), 0.0));
-            for (size_t i = 0; i < node->cells_count(); ++i)
-            {
-                w[i][i] = node->cell(i)->area();
+                a.add_outer_product(c->area(), nv, nv);
             }
 
-            // Perform multiplication tm * w * m.
-            vector<vector<double>> tm_w, a;
-            mth::dot(tm, w, tm_w);
-            mth::dot(tm_w, m, a);
-
-            // Calculate eigenvalues and eigenvectords.
-            vector<double> eigenvalues(3, 0.0);
-            vector<vector<double>> eigenvectors(3, vector<double>(3, 0.0));
-            mth::calc_eigenvalues_and_eigenvectors(a, eigenvalues, eigenvectors);
+            // Calculate eigenvalues and eigenvectors.
+            mth::Vec<3> eigenvalues;
+            mth::Mat<3, 3> eigenvectors;
+            a.calc_symmetric_eigen(eigenvalues, eigenvectors);
 
             // Process only cases when node is in smooth region.
             // One big eigenvalue.
             if (eigenvalues[1] > epsilon * eigenvalues[0])
             {
-                continue;
+                return;
             }
 
-            // Erase 0-th eigenvalue and 0-th eigenvector.
-            eigenvalues.erase(eigenvalues.begin());
-            eigenvectors.erase(eigenvectors.begin());
-
-            // Transpose rest eigenvectors.
-            vector<vector<double>> transposed_eigenvectors;
-            mth::transpose(eigenvectors, transposed_eigenvectors);
-
-            // Multiplicate eigenvectors and transposed eigenvectors.
-            vector<vector<double>> ttt;
-            mth::dot(transposed_eigenvectors, eigenvectors, ttt);
-
             // Calculate laplacian.
             geom::Vector dv;
             calc_laplacian(node, dv);
 
-            // Copy laplacian to vector.
-            vector<double> dv_vector { dv.x, dv.y, dv.z };
-            vector<double> tt;
-            mth::dot(ttt, dv_vector, tt);
+            // Project laplacian to null-space (spanned by 1-st and 2-nd eigenvectors).
+            for (size_t j = 1; j < 3; ++j)
+            {
+                geom::Vector e(eigenvectors(j, 0), eigenvectors(j, 1), eigenvectors(j, 2));
+                geom::Vector pr;
+
+                geom::Vector::mul(e, e * dv, pr);
+                node->shift.add(pr);
+            }
 
-            // Copy result to direction.
-            node->shift.set(tt[0], tt[1], tt[2]);
             node->shift.mul(st);
+        });
+
+        if (is_halo_part(mesh, h))
+        {
+            exchange_nodes_vectors(mesh, &Node::shift);
         }
 
         // Apply shifts.
-        for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+        mesh.for_each_node_by_blocks(h, [&h](size_t i)
         {
-            Node* node { mesh.all.node(i) };
+            Node* node { h.node(i) };
 
             node->move(node->shift);
-        }
+        });
 
         // Recalculate geometry.
-        mesh.calc_geometry();
+        mesh.calc_geometry(g);
 
         // Correct rest ice by areas.
-        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        mesh.for_each_cell_by_blocks(h, [&h](size_t i)
         {
-            Cell* c { mesh.all.cell(i) };
+            Cell* c { h.cell(i) };
 
             if (c->saved_area > 0.0)
             {
@@ -700,103 +1806,669 @@ Remesher::null_space_smoothing(Mesh& mesh,
 
                 c->rest_ice *= k;
             }
-        }
+        });
     }
 }
 
 /// \brief Remesh one step with Tong method.
 ///
 /// One step of Tong remeshing.
+/// Ice chunks must be already calculated.
 ///
-/// \param[in,out] mesh  Mesh.
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] h    Part of mesh (nodes to move and cells around them).
+/// \param[in,out] g    Part of mesh for geometry update.
 /// \param[in]     opts Options.
-/// \param[in]     stepi Step number (0 .. steps-1).
-/// \param[in]     steps Steps count.
 void
 Remesher::remesh_tong_step(Mesh& mesh,
-                           const RemeshOptions& opts,
-                           int stepi,
-                           int steps)
+                           NodesEdgesCellsHolder& h,
+                           NodesEdgesCellsHolder& g,
+                           const RemeshOptions& opts)
 {
-    // Calculate chunks.
-    calc_ice_chunks(mesh, steps - stepi);
+    // Count work of cells.
+    mesh.for_each_cell_by_blocks(h, [&h](size_t i)
+    {
+        h.cell(i)->work += 1.0;
+    });
 
     // Init nodes and cells ice directions.
-    init_ice_dirs(mesh);
+    init_ice_dirs(mesh, h);
 
     // Smooth normals.
-    normals_smoothing(mesh, opts);
+    normals_smoothing(mesh, h, opts);
 
     // Define ice shifts.
-    define_ice_shifts(mesh);
+    define_ice_shifts(mesh, h);
 
     // Smoothing heights.
-    heights_smoothing(mesh, opts);
+    heights_smoothing(mesh, h, opts);
 
     // Move nodes.
-    move_nodes(mesh);
+    move_nodes(mesh, h);
 
     // Null-space smoothing.
-    null_space_smoothing(mesh, opts);
+    null_space_smoothing(mesh, h, g, opts);
 
     // Update geometry in the end.
-    mesh.calc_geometry();
+    mesh.calc_geometry(g);
 }
 
-/// \brief Remesh with Tong method.
+/// \brief Steps counts of cells for local sub-stepping.
 ///
-/// Tong remeshing.
+/// Each cell gets its own steps count based on height of ice and shortest side.
+/// Then steps counts are graded: steps count of cell is not less than
+/// half of steps count of any neighbour through the edge,
+/// so the ice grows consistently at groups interfaces.
+/// If steps factors are given, steps counts of cells are multiplied by them
+/// before grading and global steps count is increased if it is needed.
 ///
-/// \param[in,out] mesh Mesh.
-/// \param[in]     opts Options.
+/// \param[in]     mesh        Mesh.
+/// \param[in]     opts        Options.
+/// \param[in]     factors     Steps factors of cells or nullptr.
+/// \param[in,out] steps       Global steps count (maximum for cell).
+/// \param[out]    cells_steps Steps counts of cells.
 void
-Remesher::remesh_tong(Mesh& mesh,
-                      const RemeshOptions& opts)
+Remesher::cells_nsteps(Mesh& mesh,
+                       const RemeshOptions& opts,
+                       const vector<int>* factors,
+                       int& steps,
+                       vector<int>& cells_steps)
 {
-    // Do not work with small amount of ice.
-    zero_ice_below_threshold(mesh, opts.hi_as_zero_threshold);
+    size_t cc { mesh.all.cells_count() };
+    double f { opts.nsteps_hi_side_fact };
+    int lo { min(max(opts.nsteps_min, 1), steps) };
+    Quality q;
 
-    int steps = remeshing_nsteps(mesh, opts);
+    q.calc(mesh.all);
 
-    // Preparations before remeshing.
-    init_target_rest_ice(mesh);
+    const vector<double>& min_sides { q.get_values(QualityMetric::MinSide) };
 
-    for (int stepi = 0; stepi < steps; ++stepi)
+    cells_steps.resize(cc);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
     {
-        remesh_tong_step(mesh, opts, stepi, steps);
+        double x { mesh.all.cell(i)->ice_shift / (min_sides[i] * f) };
+
+        cells_steps[i] = (x >= static_cast<double>(steps))
+                         ? steps
+                         : max(static_cast<int>(x) + 1, lo);
     }
 
-    // In any case in the end we zero all ice.
-    zero_ice(mesh);
-}
+    if (factors != nullptr)
+    {
+        int max_steps { steps };
 
-//
-// Main remesh method.
-//
+        #pragma omp parallel for reduction(max:max_steps)
+        for (size_t i = 0; i < cc; ++i)
+        {
+            cells_steps[i] *= (*factors)[i];
+            max_steps = max(max_steps, cells_steps[i]);
+        }
 
-/// \brief Remesh.
-///
-/// Remesh with given method.
-///
-/// \param[in,out] mesh Mesh.
-/// \param[in]     opts Options.
-void
-Remesher::remesh(Mesh& mesh,
-                 const RemeshOptions& opts)
-{
-    switch (opts.method)
+        steps = max_steps;
+    }
+
+    // Grading (steps counts only increase, so process converges).
+    vector<int> new_steps(cc);
+    bool is_changed { true };
+
+    while (is_changed)
     {
-        case RemeshMethod::Prisms:
-            remesh_prisms(mesh, opts);
-            break;
+        is_changed = false;
 
-        case RemeshMethod::Tong:
-            remesh_tong(mesh, opts);
-            break;
+        #pragma omp parallel for reduction(||:is_changed)
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+            int k { cells_steps[i] };
+
+            for (size_t j = 0; j < c->edges_count(); ++j)
+            {
+                Edge* e { c->edge(j) };
+
+                if (!e->is_inner())
+                {
+                    continue;
+                }
+
+                Cell* nc { (e->cell(0) == c) ? e->cell(1) : e->cell(0) };
+
+                k = max(k, (cells_steps[static_cast<size_t>(nc->get_id())] + 1) / 2);
+            }
+
+            new_steps[i] = k;
+            is_changed = is_changed || (k != cells_steps[i]);
+        }
+
+        cells_steps.swap(new_steps);
+    }
+}
+
+/// \brief Build part of mesh for local step.
+///
+/// Part of mesh is built around active cells:
+/// nodes of active cells are moved, cells around these nodes are processed.
+/// Active cells are marked with 2, other cells of part are marked with 1.
+/// Geometry part holds the same cells, their edges and all their nodes.
+///
+/// \param[in]  active Active cells.
+/// \param[out] h      Part of mesh (nodes to move and cells around them).
+/// \param[out] g      Part of mesh for geometry update.
+void
+Remesher::build_local_step_part(const vector<Cell*>& active,
+                                NodesEdgesCellsHolder& h,
+                                NodesEdgesCellsHolder& g)
+{
+    h.clear();
+    g.clear();
+
+    for (Cell* c : active)
+    {
+        c->set_mark(2);
+        h.add_cell(c);
+    }
+
+    // Nodes to move.
+    for (Cell* c : active)
+    {
+        for (size_t j = 0; j < c->nodes_count(); ++j)
+        {
+            Node* n { c->node(j) };
+
+            if (n->get_mark() == 0)
+            {
+                n->set_mark(1);
+                h.add_node(n);
+                g.add_node(n);
+            }
+        }
+    }
+
+    // Cells around moved nodes.
+    for (size_t i = 0; i < h.nodes_count(); ++i)
+    {
+        Node* n { h.node(i) };
+
+        for (size_t j = 0; j < n->cells_count(); ++j)
+        {
+            Cell* c { n->cell(j) };
+
+            if (c->get_mark() == 0)
+            {
+                c->set_mark(1);
+                h.add_cell(c);
+            }
+        }
+    }
+
+    // Geometry part.
+    for (size_t i = 0; i < h.cells_count(); ++i)
+    {
+        Cell* c { h.cell(i) };
+
+        g.add_cell(c);
+
+        for (size_t j = 0; j < c->edges_count(); ++j)
+        {
+            Edge* e { c->edge(j) };
+
+            if (e->get_mark() == 0)
+            {
+                e->set_mark(1);
+                g.add_edge(e);
+            }
+        }
+
+        for (size_t j = 0; j < c->nodes_count(); ++j)
+        {
+            Node* n { c->node(j) };
+
+            if (n->get_mark() == 0)
+            {
+                n->set_mark(1);
+                g.add_node(n);
+            }
+        }
+    }
+}
+
+/// \brief Release part of mesh after local step.
+///
+/// Unmark objects of part, zero ice of its cells and shifts of its nodes,
+/// so objects outside of next part do not take part in the next step.
+///
+/// \param[in,out] g Part of mesh for geometry update.
+void
+Remesher::release_local_step_part(NodesEdgesCellsHolder& g)
+{
+    #pragma omp parallel for
+    for (size_t i = 0; i < g.cells_count(); ++i)
+    {
+        Cell* c { g.cell(i) };
+
+        c->set_mark(0);
+        c->ice_chunk = 0.0;
+        c->ice_shift = 0.0;
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < g.edges_count(); ++i)
+    {
+        g.edge(i)->set_mark(0);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < g.nodes_count(); ++i)
+    {
+        Node* n { g.node(i) };
+
+        n->set_mark(0);
+        n->shift.zero();
+    }
+}
+
+/// \brief Remesh with Tong method and local sub-stepping.
+///
+/// Cells are grouped by their own steps counts
+/// (steps of each group are evenly distributed over global steps).
+/// On each global step only nodes of active cells are moved
+/// and only cells around them are processed.
+/// Marks of cells, edges and nodes are used and zeroed.
+///
+/// \param[in,out] mesh    Mesh.
+/// \param[in]     opts    Options.
+/// \param[in]     factors Steps factors of cells or nullptr.
+///
+/// \return
+/// Count of steps.
+int
+Remesher::remesh_tong_local(Mesh& mesh,
+                            const RemeshOptions& opts,
+                            const vector<int>* factors)
+{
+    // Do not work with small amount of ice.
+    zero_ice_below_threshold(mesh, opts.hi_as_zero_threshold);
+
+    int steps = remeshing_nsteps(mesh, opts);
+    size_t cc { mesh.all.cells_count() };
+    vector<int> cells_steps, cells_done(cc, 0);
+
+    cells_nsteps(mesh, opts, factors, steps, cells_steps);
+
+    // Preparations before remeshing.
+    // Outside of processed part all cells have no ice chunks and shifts,
+    // all nodes have no shifts.
+    init_target_rest_ice(mesh.all);
+    zero_ice(mesh.all);
+    init_ice_dirs(mesh, mesh.all);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        c->ice_chunk = 0.0;
+        c->set_mark(0);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < mesh.all.edges_count(); ++i)
+    {
+        mesh.all.edge(i)->set_mark(0);
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+    {
+        Node* n { mesh.all.node(i) };
+
+        n->set_mark(0);
+        n->shift.zero();
+    }
+
+    // Group cells by steps counts.
+    vector<vector<Cell*>> groups(static_cast<size_t>(steps) + 1);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        groups[static_cast<size_t>(cells_steps[i])].push_back(mesh.all.cell(i));
+    }
+
+    NodesEdgesCellsHolder h, g;
+    vector<Cell*> active;
+
+    for (int stepi = 0; stepi < steps; ++stepi)
+    {
+        bool is_all { true };
+
+        active.clear();
+
+        for (int k = 1; k <= steps; ++k)
+        {
+            vector<Cell*>& gr { groups[static_cast<size_t>(k)] };
+
+            if (gr.empty())
+            {
+                continue;
+            }
+
+            if (is_local_step(stepi, k, steps))
+            {
+                active.insert(active.end(), gr.begin(), gr.end());
+            }
+            else
+            {
+                is_all = false;
+            }
+        }
+
+        if (active.empty())
+        {
+            continue;
+        }
+
+        NodesEdgesCellsHolder& ph { is_all ? mesh.all : h };
+        NodesEdgesCellsHolder& pg { is_all ? mesh.all : g };
+
+        if (!is_all)
+        {
+            build_local_step_part(active, h, g);
+        }
+
+        // Ice chunks of active cells.
+        #pragma omp parallel for
+        for (size_t i = 0; i < active.size(); ++i)
+        {
+            Cell* c { active[i] };
+            size_t ci { static_cast<size_t>(c->get_id()) };
+
+            c->ice_chunk = c->rest_ice / static_cast<double>(cells_steps[ci] - cells_done[ci]);
+            ++cells_done[ci];
+        }
+
+        remesh_tong_step(mesh, ph, pg, opts);
+        release_local_step_part(pg);
+    }
+
+    // In any case in the end we zero all ice.
+    zero_ice(mesh.all);
+
+    return steps;
+}
+
+/// \brief Remesh with Tong method.
+///
+/// Tong remeshing.
+/// If remeshing is distributed, each process works with own cells and ghost cells.
+/// Values of nodes of own cells are calculated from all incident cells,
+/// ghost cells and far nodes receive data from other processes
+/// (so results are the same as for one process).
+/// Local sub-stepping is not supported for distributed remeshing.
+/// If active set is used, only nodes of cells with ice and cells around them are processed.
+/// If steps factors of cells are given, local sub-stepping is used.
+///
+/// \param[in,out] mesh    Mesh.
+/// \param[in]     opts    Options.
+/// \param[in]     factors Steps factors of cells or nullptr.
+///
+/// \return
+/// Count of steps.
+int
+Remesher::remesh_tong(Mesh& mesh,
+                      const RemeshOptions& opts,
+                      const vector<int>* factors)
+{
+    bool is_dist { is_distributed(mesh) };
+
+    if (opts.is_local_steps || (factors != nullptr))
+    {
+        if (!is_dist)
+        {
+            return remesh_tong_local(mesh, opts, factors);
+        }
+
+        WARNING("local steps are not supported for distributed remeshing");
+    }
+
+    bool is_active { is_active_set_used(mesh, opts) };
+    NodesEdgesCellsHolder iced, ah, ag;
+
+    if (is_dist)
+    {
+        exchange_cells_values(mesh, &Cell::ice_shift);
+    }
+
+    // Do not work with small amount of ice.
+    if (is_active)
+    {
+        build_active_set(mesh, opts, iced, ah, ag);
+    }
+    else
+    {
+        zero_ice_below_threshold(mesh, opts.hi_as_zero_threshold);
+    }
+
+    NodesEdgesCellsHolder& h { is_active ? ah : (is_dist ? mesh.halo.part : mesh.all) };
+    NodesEdgesCellsHolder& g { is_active ? ag : h };
+    int steps = remeshing_nsteps(mesh, opts, is_active ? &iced : nullptr);
+
+    // Preparations before remeshing.
+    init_target_rest_ice(is_active ? h : mesh.all);
+
+    for (int stepi = 0; stepi < steps; ++stepi)
+    {
+        // Calculate chunks.
+        calc_ice_chunks(h, steps - stepi);
+
+        remesh_tong_step(mesh, h, g, opts);
+
+        // Cells quality between steps.
+        if (opts.is_improve_quality && !is_dist && (stepi < steps - 1))
+        {
+            Topology::improve_quality(mesh, opts.quality_min_angle,
+                                      opts.quality_split_fact, opts.quality_feature_angle);
+        }
+    }
+
+    // In any case in the end we zero all ice.
+    if (is_active)
+    {
+        zero_ice(g);
+        unmark_part(g);
+    }
+    else
+    {
+        zero_ice(mesh.all);
+    }
+
+    return steps;
+}
+
+//
+// Main remesh method.
+//
+
+/// \brief Remesh with given method.
+///
+/// Remesh with given method.
+///
+/// \param[in,out] mesh    Mesh.
+/// \param[in]     opts    Options.
+/// \param[in]     factors Steps factors of cells or nullptr.
+///
+/// \return
+/// Count of steps.
+int
+Remesher::remesh_with_method(Mesh& mesh,
+                             const RemeshOptions& opts,
+                             const vector<int>* factors)
+{
+    // Work of cells is counted from the beginning.
+    #pragma omp parallel for
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        mesh.all.cell(i)->work = 0.0;
+    }
+
+    switch (opts.method)
+    {
+        case RemeshMethod::Prisms:
+            return remesh_prisms(mesh, opts, factors);
+
+        case RemeshMethod::Tong:
+            return remesh_tong(mesh, opts, factors);
 
         default:
             DEBUG_ERROR("unexpected remesh method");
     }
+
+    return 0;
+}
+
+/// \brief Increase steps factors of self-intersecting cells.
+///
+/// Steps factors of marked (self-intersecting) cells and cells
+/// which have common nodes with them are doubled, marks of cells are zeroed.
+///
+/// \param[in,out] mesh    Mesh.
+/// \param[in,out] factors Steps factors of cells.
+void
+Remesher::increase_steps_factors(Mesh& mesh,
+                                 vector<int>& factors)
+{
+    size_t cc { mesh.all.cells_count() };
+    vector<char> is_inc(cc, 0);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+        bool is_near { false };
+
+        for (size_t j = 0; (j < c->nodes_count()) && !is_near; ++j)
+        {
+            Node* n { c->node(j) };
+
+            for (size_t k = 0; (k < n->cells_count()) && !is_near; ++k)
+            {
+                is_near = (n->cell(k)->get_mark() != 0);
+            }
+        }
+
+        is_inc[i] = is_near ? 1 : 0;
+    }
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        if (is_inc[i])
+        {
+            factors[i] *= 2;
+        }
+
+        mesh.all.cell(i)->set_mark(0);
+    }
+}
+
+/// \brief Remesh.
+///
+/// Remesh with given method.
+/// If self-intersections check is on, then after remeshing self-intersecting cells are marked.
+/// If there are such cells, the mesh and ice are restored
+/// and remeshing is repeated with doubled steps counts of self-intersecting cells
+/// and cells around them (cells make their own counts of steps)
+/// (if quality improvement is on, mesh topology changes, so there are no retries).
+/// Self-intersections check is not supported for distributed remeshing
+/// (nodes outside of halo of own domain are not actual).
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in]     opts Options.
+void
+Remesher::remesh(Mesh& mesh,
+                 const RemeshOptions& opts)
+{
+    if (opts.is_check_self_intersections && is_distributed(mesh))
+    {
+        WARNING("self-intersections check is not supported for distributed remeshing");
+    }
+
+    if (!opts.is_check_self_intersections || is_distributed(mesh))
+    {
+        remesh_with_method(mesh, opts);
+
+        return;
+    }
+
+    // Mesh can not be restored after topology changes, so only check is done.
+    if (opts.is_improve_quality)
+    {
+        remesh_with_method(mesh, opts);
+
+        size_t bad { mesh.mark_self_intersecting_cells() };
+
+        if (bad > 0)
+        {
+            WARNING("self-intersections after remeshing : " + to_string(bad) + " cells");
+        }
+
+        return;
+    }
+
+    size_t cc { mesh.all.cells_count() };
+    vector<geom::Vector> points;
+    vector<double> ice_shifts(cc);
+    vector<int> factors;
+    geom::BVH bvh;
+
+    // Save state to restore it before retry.
+    mesh.get_nodes_points(points);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < cc; ++i)
+    {
+        ice_shifts[i] = mesh.all.cell(i)->ice_shift;
+    }
+
+    for (int tryi = 0; ; ++tryi)
+    {
+        int steps { remesh_with_method(mesh, opts, factors.empty() ? nullptr : &factors) };
+
+        // Topology is not changed, so BVH is built once and refitted in retries.
+        size_t bad { mesh.mark_self_intersecting_cells(bvh) };
+
+        if (bad == 0)
+        {
+            return;
+        }
+
+        if (tryi == opts.self_intersections_retries)
+        {
+            WARNING("self-intersections after remeshing : "
+                    + to_string(bad) + " cells, steps = " + to_string(steps));
+
+            return;
+        }
+
+        // Retry with more steps around self-intersections.
+        if (factors.empty())
+        {
+            factors.assign(cc, 1);
+        }
+
+        increase_steps_factors(mesh, factors);
+
+        // Restore state.
+        mesh.set_nodes_points(points);
+
+        #pragma omp parallel for
+        for (size_t i = 0; i < cc; ++i)
+        {
+            mesh.all.cell(i)->ice_shift = ice_shifts[i];
+        }
+
+        mesh.calc_geometry();
+    }
 }
 
 /// @}
@@ -7,6 +7,7 @@
 #define CAESAR_MESH_REMESHER_H
 
 #include "mesh_mesh.h"
+#include "mesh_topology.h"
 
 namespace caesar
 {
@@ -114,6 +115,19 @@ struct RemeshOptions
     /// Parameter for heights smoothing.
     double hsmooth_beta { 0.1 };
 
+    /// \brief Implicit heights smoothing.
+    ///
+    /// Heights are smoothed with one solve of linear system
+    /// with the same strength as hsmooth_steps explicit iterations
+    /// (not used for distributed remeshing).
+    bool is_hsmooth_implicit { false };
+
+    /// \brief Relative accuracy of implicit heights smoothing solver.
+    double hsmooth_implicit_eps { 1.0e-10 };
+
+    /// \brief Maximum iterations count of implicit heights smoothing solver.
+    int hsmooth_implicit_max_iters { 1000 };
+
     /// \brief Null-space smoothing iterations count.
     ///
     /// Null-space smoothing iterations count.
@@ -127,6 +141,58 @@ struct RemeshOptions
     /// Parameter of moving nodes while null-space smoothing.
     double nss_st { 0.2 };
 
+    /// \brief Check mesh self-intersections after remeshing.
+    ///
+    /// Check mesh self-intersections after remeshing.
+    bool is_check_self_intersections { false };
+
+    /// \brief Count of remesh retries if self-intersections are found.
+    ///
+    /// Each retry restores mesh and remeshes it again with doubled steps counts
+    /// of self-intersecting cells and cells around them.
+    int self_intersections_retries { 2 };
+
+    /// \brief Local sub-stepping for Tong method.
+    ///
+    /// Each cell makes its own count of steps (not greater than global one),
+    /// so regions with thin ice are processed less times than regions with thick ice.
+    bool is_local_steps { false };
+
+    /// \brief Improve cells quality between remesh steps.
+    ///
+    /// Stretched edges are split, bad cells are fixed with flips and collapses
+    /// (only for one process).
+    bool is_improve_quality { false };
+
+    /// \brief Minimum permitted angle of cell for quality improvement (rad).
+    double quality_min_angle { 0.35 };
+
+    /// \brief Maximum permitted stretch of edge for quality improvement.
+    double quality_split_fact { 2.0 };
+
+    /// \brief Maximum change of cell normal while quality improvement (rad).
+    double quality_feature_angle { 0.35 };
+
+    /// \brief Process only active set of cells.
+    ///
+    /// Active set is built once per remesh from cells with ice
+    /// and layers of cells around them, other cells and nodes are not touched
+    /// (not used for distributed remeshing, local steps and quality improvement).
+    bool is_active_set { false };
+
+    /// \brief Count of layers of cells around cells with ice in active set.
+    int active_set_halo { 2 };
+
+    /// \brief Iterations of normals and heights smoothing for one patch.
+    ///
+    /// Mesh is split into patches which are small enough to be in cache,
+    /// several smoothing iterations are done for patch at once
+    /// (0 - patches are not used).
+    int patch_smoothing_iters { 0 };
+
+    /// \brief Count of core cells of patch for smoothing.
+    int patch_smoothing_cells { 512 };
+
     /// \brief Default constrructor.
     ///
     /// Default constructor. All options set to default values.
@@ -203,7 +269,15 @@ struct RemeshOptions
                            << x.nsteps_hi_side_fact << "/" << x.nsteps_ignore_part
            << ", nsmooth:" << x.nsmooth_steps << "/" << x.nsmooth_s << "/" << x.nsmooth_k
            << ", hsmooth:" << x.hsmooth_steps << "/" << x.hsmooth_alfa << "/" << x.hsmooth_beta
-           << ", nss_smooth:" << x.nss_steps << "/" << x.nss_epsilon << "/" << x.nss_st;
+                           << "/" << x.is_hsmooth_implicit << "/" << x.hsmooth_implicit_eps
+                           << "/" << x.hsmooth_implicit_max_iters
+           << ", nss_smooth:" << x.nss_steps << "/" << x.nss_epsilon << "/" << x.nss_st
+           << ", self_int:" << x.is_check_self_intersections << "/" << x.self_intersections_retries
+           << ", local_steps:" << x.is_local_steps
+           << ", quality:" << x.is_improve_quality << "/" << x.quality_min_angle
+                           << "/" << x.quality_split_fact << "/" << x.quality_feature_angle
+           << ", active_set:" << x.is_active_set << "/" << x.active_set_halo
+           << ", patch_smooth:" << x.patch_smoothing_iters << "/" << x.patch_smoothing_cells;
 
         return os;
     }
@@ -214,6 +288,7 @@ struct RemeshOptions
 /// Remesher class.
 class Remesher
 {
+    friend class Ensemble;
 
 private:
 
@@ -221,9 +296,28 @@ private:
     // Common functions.
     //
 
+    // Check if remeshing is distributed.
+    static bool
+    is_distributed(const Mesh& mesh);
+
+    // Check if part of mesh is halo part of distributed remeshing.
+    static bool
+    is_halo_part(const Mesh& mesh,
+                 const NodesEdgesCellsHolder& h);
+
+    // Exchange values of ghost cells.
+    static void
+    exchange_cells_values(Mesh& mesh,
+                          double Cell::*f);
+
+    // Exchange vectors of far nodes.
+    static void
+    exchange_nodes_vectors(Mesh& mesh,
+                           geom::Vector Node::*f);
+
     // Zero all ice.
     static void
-    zero_ice(Mesh& mesh);
+    zero_ice(NodesEdgesCellsHolder& h);
 
     // Zero small accounts of ice in mesh cells.
     static void
@@ -233,16 +327,45 @@ private:
     // Steps of remeshing based on height of ice.
     static int
     remeshing_nsteps(Mesh& mesh,
-                     const RemeshOptions& opts);
+                     const RemeshOptions& opts,
+                     NodesEdgesCellsHolder* iced = nullptr);
+
+    //
+    // Active set.
+    //
+
+    // Check if active set is used.
+    static bool
+    is_active_set_used(const Mesh& mesh,
+                       const RemeshOptions& opts);
+
+    // Build active set.
+    static void
+    build_active_set(Mesh& mesh,
+                     const RemeshOptions& opts,
+                     NodesEdgesCellsHolder& iced,
+                     NodesEdgesCellsHolder& h,
+                     NodesEdgesCellsHolder& g);
+
+    // Unmark part of mesh.
+    static void
+    unmark_part(NodesEdgesCellsHolder& g);
 
     //
     // Prisms remeshing.
     //
 
+    // Check if cell with local steps count is processed on global step.
+    static bool
+    is_local_step(int stepi,
+                  int k,
+                  int steps);
+
     // Remesh with prizm method.
-    static void
+    static int
     remesh_prisms(Mesh& mesh,
-                  const RemeshOptions& opts);
+                  const RemeshOptions& opts,
+                  const vector<int>* factors = nullptr);
 
     //
     // Tong remeshing methods.
@@ -250,34 +373,93 @@ private:
 
     // Init target, rest ice.
     static void
-    init_target_rest_ice(Mesh& mesh);
+    init_target_rest_ice(NodesEdgesCellsHolder& h);
 
     // Calc ice chunks.
     static void
-    calc_ice_chunks(Mesh& mesh,
+    calc_ice_chunks(NodesEdgesCellsHolder& h,
                     int rest_iterations);
 
     // Init nodes and cells ice directions.
     static void
-    init_ice_dirs(Mesh& mesh);
+    init_ice_dirs(Mesh& mesh,
+                  NodesEdgesCellsHolder& h);
+
+    // Prepare patches for smoothing.
+    static bool
+    prepare_patches(Mesh& mesh,
+                    NodesEdgesCellsHolder& h,
+                    const RemeshOptions& opts);
+
+    // Smooth normals with patches.
+    static void
+    normals_smoothing_patches(Mesh& mesh,
+                              const RemeshOptions& opts);
 
     // Smooth normals.
     static void
     normals_smoothing(Mesh& mesh,
+                      NodesEdgesCellsHolder& h,
                       const RemeshOptions& opts);
 
+    // Coefficients for ice shifts calculation.
+    static void
+    calc_ice_shifts_coefficients(const Mesh& mesh,
+                                 NodesEdgesCellsHolder& h,
+                                 vector<double>& as,
+                                 vector<double>& bs);
+
+    // Ice shift of cell.
+    static double
+    calc_cell_ice_shift(double ice_chunk,
+                        double area,
+                        double a,
+                        double b);
+
     // Define ice shifts.
     static void
-    define_ice_shifts(Mesh& mesh);
+    define_ice_shifts(const Mesh& mesh,
+                      NodesEdgesCellsHolder& h);
+
+    // Flow of ice volume while heights smoothing.
+    static double
+    heights_smoothing_flow(double h,
+                           double ice_chunk,
+                           double area,
+                           double nh,
+                           double n_ice_chunk,
+                           double n_area,
+                           double alfa,
+                           double max_h);
+
+    // Flow of ice volume while heights smoothing.
+    static double
+    heights_smoothing_flow(const Cell* c,
+                           const Cell* nc,
+                           double alfa,
+                           double max_h);
+
+    // Implicit smoothing heights.
+    static void
+    heights_smoothing_implicit(Mesh& mesh,
+                               NodesEdgesCellsHolder& h,
+                               const RemeshOptions& opts);
+
+    // Smoothing heights with patches.
+    static void
+    heights_smoothing_patches(Mesh& mesh,
+                              const RemeshOptions& opts);
 
     // Smoothing heights.
     static void
     heights_smoothing(Mesh& mesh,
+                      NodesEdgesCellsHolder& h,
                       const RemeshOptions& opts);
 
     // Move nodes.
     static void
-    move_nodes(Mesh& mesh);
+    move_nodes(Mesh& mesh,
+               NodesEdgesCellsHolder& h);
 
     // Calculate laplacian for null-space smoothing.
     static void
@@ -287,19 +469,61 @@ private:
     // Null-space smoothing.
     static void
     null_space_smoothing(Mesh& mesh,
+                         NodesEdgesCellsHolder& h,
+                         NodesEdgesCellsHolder& g,
                          const RemeshOptions& opts);
 
     // Remesh one step with Tong method.
     static void
     remesh_tong_step(Mesh& mesh,
-                     const RemeshOptions& opts,
-                     int stepi,
-                     int steps);
+                     NodesEdgesCellsHolder& h,
+                     NodesEdgesCellsHolder& g,
+                     const RemeshOptions& opts);
 
-    // Remesh with Tong method.
+    // Steps counts of cells for local sub-stepping.
+    static void
+    cells_nsteps(Mesh& mesh,
+                 const RemeshOptions& opts,
+                 const vector<int>* factors,
+                 int& steps,
+                 vector<int>& cells_steps);
+
+    // Build part of mesh for local step.
+    static void
+    build_local_step_part(const vector<Cell*>& active,
+                          NodesEdgesCellsHolder& h,
+                          NodesEdgesCellsHolder& g);
+
+    // Release part of mesh after local step.
     static void
+    release_local_step_part(NodesEdgesCellsHolder& g);
+
+    // Remesh with Tong method and local sub-stepping.
+    static int
+    remesh_tong_local(Mesh& mesh,
+                      const RemeshOptions& opts,
+                      const vector<int>* factors = nullptr);
+
+    // Remesh with Tong method.
+    static int
     remesh_tong(Mesh& mesh,
-                const RemeshOptions& opts);
+                const RemeshOptions& opts,
+                const vector<int>* factors = nullptr);
+
+    //
+    // Main remesh method.
+    //
+
+    // Remesh with given method.
+    static int
+    remesh_with_method(Mesh& mesh,
+                       const RemeshOptions& opts,
+                       const vector<int>* factors = nullptr);
+
+    // Increase steps factors of self-intersecting cells.
+    static void
+    increase_steps_factors(Mesh& mesh,
+                           vector<int>& factors);
 
 public:
 
@@ -0,0 +1,1284 @@
+/// \file
+/// \brief Mesh topology changes.
+///
+/// Mesh topology changes implementation.
+
+#include "mesh_topology.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Replace item in vector.
+///
+/// Replace first occurence of item in vector.
+///
+/// \tparam        T    Type of item.
+/// \param[in,out] v    Vector.
+/// \param[in]     from Old item.
+/// \param[in]     to   New item.
+template<typename T>
+static void
+replace_item(vector<T*>& v,
+             T* from,
+             T* to)
+{
+    auto it = find(v.begin(), v.end(), from);
+
+    DEBUG_CHECK_ERROR(it != v.end(), "item not found and can not be replaced");
+
+    *it = to;
+}
+
+/// \brief Remove item from vector.
+///
+/// Remove first occurence of item from vector.
+///
+/// \tparam        T Type of item.
+/// \param[in,out] v Vector.
+/// \param[in]     x Item.
+template<typename T>
+static void
+remove_item(vector<T*>& v,
+            T* x)
+{
+    auto it = find(v.begin(), v.end(), x);
+
+    DEBUG_CHECK_ERROR(it != v.end(), "item not found and can not be removed");
+
+    v.erase(it);
+}
+
+/// \brief Check if vector has item.
+///
+/// Check if vector has item.
+///
+/// \tparam    T Type of item.
+/// \param[in] v Vector.
+/// \param[in] x Item.
+///
+/// \return
+/// true - if vector has item,
+/// false - otherwise.
+template<typename T>
+static bool
+has_item(const vector<T*>& v,
+         const T* x)
+{
+    return find(v.begin(), v.end(), x) != v.end();
+}
+
+/// \brief Leave only unique items in vector.
+///
+/// Items are sorted and duplicates are removed.
+///
+/// \tparam        T Type of item.
+/// \param[in,out] v Vector.
+template<typename T>
+static void
+unique_items(vector<T*>& v)
+{
+    sort(v.begin(), v.end());
+    v.erase(unique(v.begin(), v.end()), v.end());
+}
+
+/// \brief Remove detached items from vector.
+///
+/// Detached items have negative identifiers.
+///
+/// \tparam        T Type of item.
+/// \param[in,out] v Vector.
+template<typename T>
+static void
+remove_detached_items(vector<T*>& v)
+{
+    v.erase(remove_if(v.begin(), v.end(), [](T* x) { return x->get_id() < 0; }), v.end());
+}
+
+//
+// Links.
+//
+
+/// \brief Find edge between two nodes.
+///
+/// Find edge between two nodes.
+///
+/// \param[in] a First node.
+/// \param[in] b Second node.
+///
+/// \return
+/// Edge or nullptr if there is no edge.
+Edge*
+Topology::find_edge(Node* a,
+                    Node* b)
+{
+    for (size_t i = 0; i < a->edges_count(); ++i)
+    {
+        Edge* e { a->edge(i) };
+
+        if ((e->node(0) == b) || (e->node(1) == b))
+        {
+            return e;
+        }
+    }
+
+    return nullptr;
+}
+
+/// \brief Index of edge in cell.
+///
+/// Index of edge in cell.
+///
+/// \param[in] c Cell.
+/// \param[in] e Edge.
+///
+/// \return
+/// Index of edge (edges count if there is no such edge).
+size_t
+Topology::edge_index(const Cell* c,
+                     const Edge* e)
+{
+    size_t ec { c->edges_count() };
+
+    for (size_t i = 0; i < ec; ++i)
+    {
+        if (c->edges()[i] == e)
+        {
+            return i;
+        }
+    }
+
+    return ec;
+}
+
+/// \brief Nodes of two cells around inner edge.
+///
+/// First cell is (u, v, x), second cell is (v, u, y).
+///
+/// \param[in]  e Edge.
+/// \param[out] u First node of edge.
+/// \param[out] v Second node of edge.
+/// \param[out] x Node of first cell opposite to edge.
+/// \param[out] y Node of second cell opposite to edge.
+///
+/// \return
+/// true - if edge is inner and cells are consistently oriented,
+/// false - otherwise.
+bool
+Topology::get_quad(Edge* e,
+                   Node*& u,
+                   Node*& v,
+                   Node*& x,
+                   Node*& y)
+{
+    if (e->cells_count() != 2)
+    {
+        return false;
+    }
+
+    Cell* c1 { e->cell(0) };
+    Cell* c2 { e->cell(1) };
+    size_t j1 { edge_index(c1, e) }, j2 { edge_index(c2, e) };
+
+    u = c1->node(j1);
+    v = c1->node((j1 + 1) % 3);
+    x = c1->node((j1 + 2) % 3);
+    y = c2->node((j2 + 2) % 3);
+
+    return (c2->node(j2) == v) && (c2->node((j2 + 1) % 3) == u) && (x != y);
+}
+
+//
+// Updates.
+//
+
+/// \brief Clear own edges colors and patches after topology change.
+///
+/// Edges colors distribution and patches are not correct after topology change.
+///
+/// \param[in,out] mesh Mesh.
+void
+Topology::clear_caches(Mesh& mesh)
+{
+    if (mesh.is_own_edges_colored())
+    {
+        mesh.clear_own_edges_colors();
+    }
+
+    mesh.patches.clear();
+}
+
+/// \brief Register new node.
+///
+/// Set identifier, copy data and add node into mesh.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] n    New node.
+/// \param[in]     from Node to copy data from.
+void
+Topology::register_node(Mesh& mesh,
+                        Node* n,
+                        const Node* from)
+{
+    if (mesh.copy_node_data != nullptr)
+    {
+        mesh.copy_node_data(n, from);
+    }
+
+    n->set_id(static_cast<int>(mesh.all.nodes_count()));
+    mesh.all.add_node(n);
+}
+
+/// \brief Register new edge.
+///
+/// Set identifier, copy data and add edge into mesh.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] e    New edge.
+/// \param[in]     from Edge to copy data from.
+void
+Topology::register_edge(Mesh& mesh,
+                        Edge* e,
+                        const Edge* from)
+{
+    if (mesh.copy_edge_data != nullptr)
+    {
+        mesh.copy_edge_data(e, from);
+    }
+
+    e->set_id(static_cast<int>(mesh.all.edges_count()));
+    mesh.all.add_edge(e);
+
+    // Edge of split cell is own for the same domain.
+    if (!mesh.own.cells().empty() && !from->cells().empty()
+        && (from->cell(0)->get_domain() == parl::mpi_rank()))
+    {
+        e->set_loc_id(static_cast<int>(mesh.own.edges_count()));
+        mesh.own.add_edge(e);
+    }
+}
+
+/// \brief Register new cell.
+///
+/// Set identifier, copy data, domain and zone and add cell into mesh.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] c    New cell.
+/// \param[in]     from Cell to copy data from.
+void
+Topology::register_cell(Mesh& mesh,
+                        Cell* c,
+                        const Cell* from)
+{
+    if (mesh.copy_cell_data != nullptr)
+    {
+        mesh.copy_cell_data(c, from);
+    }
+
+    c->domain = from->domain;
+    c->zone = from->zone;
+    c->ice_dir.set(from->ice_dir);
+    c->ice_shift = from->ice_shift;
+
+    if (c->zone != nullptr)
+    {
+        c->zone->add_cell(c);
+    }
+
+    c->set_id(static_cast<int>(mesh.all.cells_count()));
+    mesh.all.add_cell(c);
+
+    if (!mesh.own.cells().empty() && (c->domain == parl::mpi_rank()))
+    {
+        c->set_loc_id(static_cast<int>(mesh.own.cells_count()));
+        mesh.own.add_cell(c);
+    }
+
+    if (c->domain < mesh.domains_cells.size())
+    {
+        mesh.domains_cells[c->domain].push_back(c);
+    }
+}
+
+/// \brief Add edge into zones of its cells.
+///
+/// Add edge into zones of its cells.
+///
+/// \param[in,out] e Edge.
+void
+Topology::add_edge_to_zones(Edge* e)
+{
+    Zone* z0 { e->cell(0)->zone };
+
+    if (z0 != nullptr)
+    {
+        z0->add_edge(e);
+    }
+
+    if (e->cells_count() > 1)
+    {
+        Zone* z1 { e->cell(1)->zone };
+
+        if ((z1 != nullptr) && (z1 != z0))
+        {
+            z1->add_edge(e);
+        }
+    }
+}
+
+/// \brief Update geometry and neighbourhoods around nodes.
+///
+/// Recalculate geometry of cells around nodes, their edges and nodes
+/// and init neighbourhoods of all cells which have common nodes with them.
+///
+/// \param[in] ns Nodes.
+void
+Topology::update_around(const vector<Node*>& ns)
+{
+    vector<Cell*> cs, nghs;
+    vector<Edge*> es;
+    vector<Node*> nodes;
+
+    for (Node* n : ns)
+    {
+        cs.insert(cs.end(), n->cells().begin(), n->cells().end());
+    }
+
+    unique_items(cs);
+
+    for (Cell* c : cs)
+    {
+        nodes.insert(nodes.end(), c->nodes().begin(), c->nodes().end());
+        es.insert(es.end(), c->edges().begin(), c->edges().end());
+    }
+
+    unique_items(nodes);
+    unique_items(es);
+
+    for (Edge* e : es)
+    {
+        e->calc_geometry();
+    }
+
+    for (Cell* c : cs)
+    {
+        c->calc_geometry();
+    }
+
+    for (Node* n : nodes)
+    {
+        n->calc_geometry();
+        nghs.insert(nghs.end(), n->cells().begin(), n->cells().end());
+    }
+
+    unique_items(nghs);
+
+    for (Cell* c : nghs)
+    {
+        c->init_neighbourhood();
+    }
+}
+
+/// \brief Redistribute ice between two cells.
+///
+/// Ice volumes of two cells are summed and redistributed according to new areas,
+/// ice shift is set to mean value.
+///
+/// \param[in,out] c1 First cell.
+/// \param[in,out] c2 Second cell.
+/// \param[in]     a1 Old area of first cell.
+/// \param[in]     a2 Old area of second cell.
+void
+Topology::redistribute_ice(Cell* c1,
+                           Cell* c2,
+                           double a1,
+                           double a2)
+{
+    double s { c1->area() + c2->area() };
+
+    if (s <= 0.0)
+    {
+        return;
+    }
+
+    double k1 { c1->area() / s }, k2 { c2->area() / s };
+    double t { c1->target_ice + c2->target_ice };
+    double r { c1->rest_ice + c2->rest_ice };
+    double ch { c1->ice_chunk + c2->ice_chunk };
+    double lch { c1->loc_ice_chunk + c2->loc_ice_chunk };
+    double h { (c1->ice_shift * a1 + c2->ice_shift * a2) / s };
+
+    c1->target_ice = k1 * t;
+    c2->target_ice = k2 * t;
+    c1->rest_ice = k1 * r;
+    c2->rest_ice = k2 * r;
+    c1->ice_chunk = k1 * ch;
+    c2->ice_chunk = k2 * ch;
+    c1->loc_ice_chunk = k1 * lch;
+    c2->loc_ice_chunk = k2 * lch;
+    c1->ice_shift = h;
+    c2->ice_shift = h;
+}
+
+/// \brief Move ice from one cell to another.
+///
+/// Ice volumes of removed cell are added to neighbour.
+///
+/// \param[in,out] from Cell to take ice from.
+/// \param[in,out] to   Cell to put ice to.
+void
+Topology::move_ice(Cell* from,
+                   Cell* to)
+{
+    double s { from->area() + to->area() };
+
+    if (s > 0.0)
+    {
+        to->ice_shift = (from->ice_shift * from->area() + to->ice_shift * to->area()) / s;
+    }
+
+    to->target_ice += from->target_ice;
+    to->rest_ice += from->rest_ice;
+    to->ice_chunk += from->ice_chunk;
+    to->loc_ice_chunk += from->loc_ice_chunk;
+}
+
+//
+// Geometrical checks.
+//
+
+/// \brief Check if flip of edge improves quality.
+///
+/// Flip improves quality if minimum angle of two cells increases
+/// and new cells normals are close to old ones (feature is saved).
+///
+/// \param[in] e             Edge.
+/// \param[in] feature_angle Maximum angle between old and new normals (rad).
+///
+/// \return
+/// true - if flip improves quality,
+/// false - otherwise.
+bool
+Topology::is_flip_better(Edge* e,
+                         double feature_angle)
+{
+    Node* u { nullptr };
+    Node* v { nullptr };
+    Node* x { nullptr };
+    Node* y { nullptr };
+
+    if (!get_quad(e, u, v, x, y))
+    {
+        return false;
+    }
+
+    const geom::Vector& pu { u->point() };
+    const geom::Vector& pv { v->point() };
+    const geom::Vector& px { x->point() };
+    const geom::Vector& py { y->point() };
+    double cos_feature { cos(feature_angle) };
+
+    // Cells normals must be close to each other.
+    if (e->cell(0)->normal() * e->cell(1)->normal() < cos_feature)
+    {
+        return false;
+    }
+
+    // New cells must not be degenerate.
+    if ((geom::Vector::triangle_area(pu, py, px) <= 0.0)
+        || (geom::Vector::triangle_area(py, pv, px) <= 0.0))
+    {
+        return false;
+    }
+
+    geom::Vector n1, n2;
+
+    geom::Vector::calc_outer_normal(pu, py, px, n1);
+    geom::Vector::calc_outer_normal(py, pv, px, n2);
+
+    if ((n1 * e->cell(0)->normal() < cos_feature)
+        || (n2 * e->cell(1)->normal() < cos_feature))
+    {
+        return false;
+    }
+
+    double old1 { 0.0 }, old2 { 0.0 }, new1 { 0.0 }, new2 { 0.0 }, not_used { 0.0 };
+
+    triangle_angles(pu, pv, px, old1, not_used);
+    triangle_angles(pv, pu, py, old2, not_used);
+    triangle_angles(pu, py, px, new1, not_used);
+    triangle_angles(py, pv, px, new2, not_used);
+
+    return min(new1, new2) > min(old1, old2);
+}
+
+/// \brief Check if edge collapse saves cells orientations.
+///
+/// Cells around edge nodes (except cells of edge) with new position of node
+/// must not be degenerate and their normals must be close to old ones.
+///
+/// \param[in]  e             Edge.
+/// \param[in]  p             New position of node.
+/// \param[in]  feature_angle Maximum angle between old and new normals (rad).
+/// \param[out] new_min_angle Minimum angle of new cells.
+///
+/// \return
+/// true - if collapse is correct,
+/// false - otherwise.
+bool
+Topology::is_collapse_correct(Edge* e,
+                              const geom::Vector& p,
+                              double feature_angle,
+                              double& new_min_angle)
+{
+    double cos_feature { cos(feature_angle) };
+
+    new_min_angle = mth::Pi;
+
+    for (size_t k = 0; k < 2; ++k)
+    {
+        Node* n { e->node(k) };
+
+        for (size_t i = 0; i < n->cells_count(); ++i)
+        {
+            Cell* c { n->cell(i) };
+
+            if ((c == e->cell(0)) || (c == e->cell(1)))
+            {
+                continue;
+            }
+
+            geom::Vector ps[3];
+
+            for (size_t j = 0; j < 3; ++j)
+            {
+                ps[j].set((c->node(j) == n) ? p : c->node(j)->point());
+            }
+
+            if (geom::Vector::triangle_area(ps[0], ps[1], ps[2]) <= 0.0)
+            {
+                return false;
+            }
+
+            geom::Vector nn;
+            double mn { 0.0 }, not_used { 0.0 };
+
+            geom::Vector::calc_outer_normal(ps[0], ps[1], ps[2], nn);
+
+            if (nn * c->normal() < cos_feature)
+            {
+                return false;
+            }
+
+            triangle_angles(ps[0], ps[1], ps[2], mn, not_used);
+            new_min_angle = min(new_min_angle, mn);
+        }
+    }
+
+    return true;
+}
+
+//
+// Quality of triangles.
+//
+
+/// \brief Minimum and maximum angles of triangle.
+///
+/// Angles are calculated with law of cosines.
+///
+/// \param[in]  a         First point.
+/// \param[in]  b         Second point.
+/// \param[in]  c         Third point.
+/// \param[out] min_angle Minimum angle (rad).
+/// \param[out] max_angle Maximum angle (rad).
+void
+Topology::triangle_angles(const geom::Vector& a,
+                          const geom::Vector& b,
+                          const geom::Vector& c,
+                          double& min_angle,
+                          double& max_angle)
+{
+    // Sides opposite to points.
+    double ls[3] { b.dist_to(c), c.dist_to(a), a.dist_to(b) };
+
+    min_angle = mth::Pi;
+    max_angle = 0.0;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        double l0 { ls[i] }, l1 { ls[(i + 1) % 3] }, l2 { ls[(i + 2) % 3] };
+        double angle { 0.0 };
+
+        if (l1 * l2 > 0.0)
+        {
+            double cs { (l1 * l1 + l2 * l2 - l0 * l0) / (2.0 * l1 * l2) };
+
+            angle = acos(max(-1.0, min(1.0, cs)));
+        }
+
+        min_angle = min(min_angle, angle);
+        max_angle = max(max_angle, angle);
+    }
+}
+
+/// \brief Minimum angle of cell.
+///
+/// Minimum angle of cell.
+///
+/// \param[in] c Cell.
+///
+/// \return
+/// Minimum angle (rad).
+double
+Topology::cell_min_angle(const Cell* c)
+{
+    double mn { 0.0 }, mx { 0.0 };
+
+    triangle_angles(c->node(0)->point(), c->node(1)->point(), c->node(2)->point(), mn, mx);
+
+    return mn;
+}
+
+//
+// Local operations.
+//
+
+/// \brief Split edge.
+///
+/// New node is placed in the middle of edge.
+/// Each incident cell (u, v, x) is split into cells (u, m, x) and (m, v, x).
+/// New objects copy data of old ones, ice volumes of split cells are halved.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] e    Edge.
+///
+/// \return
+/// New node.
+Node*
+Topology::split_edge(Mesh& mesh,
+                     Edge* e)
+{
+    DEBUG_CHECK_ERROR((e->cells_count() == 1) || (e->cells_count() == 2),
+                      "wrong count of incident cells for edge");
+
+    Node* a { e->node(0) };
+    Node* b { e->node(1) };
+    geom::Vector p;
+    vector<Cell*> cs(e->cells());
+    vector<Node*> ns { a, b };
+    vector<Edge*> new_es;
+
+    clear_caches(mesh);
+
+    // New node in the middle of edge.
+    geom::Vector::avg(a->point(), b->point(), p);
+
+    Node* m { new Node(p.x, p.y, p.z) };
+
+    register_node(mesh, m, a);
+    ns.push_back(m);
+
+    for (Cell* c : cs)
+    {
+        if ((c->zone != nullptr)
+            && (find(c->zone->nodes().begin(), c->zone->nodes().end(), m) == c->zone->nodes().end()))
+        {
+            c->zone->add_node(m);
+        }
+    }
+
+    // Edge e becomes (a, m), new edge eb is (m, b).
+    Edge* eb { new Edge() };
+
+    replace_item(e->nodes(), b, m);
+    replace_item(b->edges(), e, eb);
+    m->add_edge(e);
+    m->add_edge(eb);
+    eb->add_node(m);
+    eb->add_node(b);
+    e->clear_cells();
+    new_es.push_back(eb);
+
+    for (Cell* c : cs)
+    {
+        size_t j { edge_index(c, e) };
+        Node* u { c->node(j) };
+        Node* v { c->node((j + 1) % 3) };
+        Node* x { c->node((j + 2) % 3) };
+        Edge* evx { c->edge((j + 1) % 3) };
+        Edge* eu { (u == a) ? e : eb };
+        Edge* ev { (v == a) ? e : eb };
+        Cell* nc { new Cell() };
+        Edge* ex { new Edge() };
+
+        ns.push_back(x);
+
+        // Ice volumes are halved (areas are halved).
+        c->target_ice /= 2.0;
+        c->rest_ice /= 2.0;
+        c->ice_chunk /= 2.0;
+        c->loc_ice_chunk /= 2.0;
+        nc->target_ice = c->target_ice;
+        nc->rest_ice = c->rest_ice;
+        nc->ice_chunk = c->ice_chunk;
+        nc->loc_ice_chunk = c->loc_ice_chunk;
+
+        // New edge (m, x).
+        ex->add_node(m);
+        ex->add_node(x);
+        m->add_edge(ex);
+        x->add_edge(ex);
+        new_es.push_back(ex);
+
+        // Cell c becomes (u, m, x).
+        c->nodes()[(j + 1) % 3] = m;
+        c->edges()[j] = eu;
+        c->edges()[(j + 1) % 3] = ex;
+        m->add_cell(c);
+        eu->add_cell(c);
+        ex->add_cell(c);
+
+        // New cell nc is (m, v, x).
+        nc->add_node(m);
+        nc->add_node(v);
+        nc->add_node(x);
+        nc->add_edge(ev);
+        nc->add_edge(evx);
+        nc->add_edge(ex);
+        m->add_cell(nc);
+        replace_item(v->cells(), c, nc);
+        x->add_cell(nc);
+        ev->add_cell(nc);
+        replace_item(evx->cells(), c, nc);
+        ex->add_cell(nc);
+
+        register_cell(mesh, nc, c);
+    }
+
+    for (Edge* ne : new_es)
+    {
+        register_edge(mesh, ne, e);
+        add_edge_to_zones(ne);
+    }
+
+    update_around(ns);
+
+    // Geometry of changed objects is saved.
+    m->save_geometry();
+    e->save_geometry();
+
+    for (Edge* ne : new_es)
+    {
+        ne->save_geometry();
+    }
+
+    for (Cell* c : m->cells())
+    {
+        c->save_geometry();
+    }
+
+    return m;
+}
+
+/// \brief Flip edge.
+///
+/// Cells (u, v, x) and (v, u, y) become cells (u, y, x) and (y, v, x),
+/// edge (u, v) becomes edge (x, y).
+/// Ice volumes of two cells are redistributed according to new areas.
+///
+/// \param[in,out] mesh Mesh.
+/// \param[in,out] e    Edge.
+///
+/// \return
+/// true - if edge is flipped,
+/// false - if flip is impossible.
+bool
+Topology::flip_edge(Mesh& mesh,
+                    Edge* e)
+{
+    Node* u { nullptr };
+    Node* v { nullptr };
+    Node* x { nullptr };
+    Node* y { nullptr };
+
+    if (!get_quad(e, u, v, x, y) || (find_edge(x, y) != nullptr))
+    {
+        return false;
+    }
+
+    Cell* c1 { e->cell(0) };
+    Cell* c2 { e->cell(1) };
+
+    if ((c1->zone != c2->zone) || (c1->domain != c2->domain))
+    {
+        return false;
+    }
+
+    size_t j1 { edge_index(c1, e) }, j2 { edge_index(c2, e) };
+    Edge* evx { c1->edge((j1 + 1) % 3) };
+    Edge* exu { c1->edge((j1 + 2) % 3) };
+    Edge* euy { c2->edge((j2 + 1) % 3) };
+    Edge* eyv { c2->edge((j2 + 2) % 3) };
+    double a1 { c1->area() }, a2 { c2->area() };
+
+    clear_caches(mesh);
+
+    // Cell c1 becomes (u, y, x), cell c2 becomes (y, v, x).
+    c1->nodes() = { u, y, x };
+    c1->edges() = { euy, e, exu };
+    c2->nodes() = { y, v, x };
+    c2->edges() = { eyv, evx, e };
+
+    // Nodes links.
+    remove_item(u->cells(), c2);
+    remove_item(v->cells(), c1);
+    x->add_cell(c2);
+    y->add_cell(c1);
+    remove_item(u->edges(), e);
+    remove_item(v->edges(), e);
+    x->add_edge(e);
+    y->add_edge(e);
+    e->nodes() = { x, y };
+
+    // Edges links.
+    replace_item(euy->cells(), c2, c1);
+    replace_item(evx->cells(), c1, c2);
+
+    update_around({ u, v, x, y });
+    redistribute_ice(c1, c2, a1, a2);
+    e->save_geometry();
+    c1->save_geometry();
+    c2->save_geometry();
+
+    return true;
+}
+
+/// \brief Collapse edge.
+///
+/// Node v of edge (u, v) is merged into node u placed in the middle of edge.
+/// Cells (u, v, x) and (v, u, y) and edges (v, x), (v, y) are detached,
+/// their ice is moved to neighbours through edges (v, x) and (v, y).
+/// Detached objects must be removed with remove_detached.
+///
+/// \param[in,out] mesh          Mesh.
+/// \param[in,out] e             Edge.
+/// \param[in]     feature_angle Maximum angle between old and new normals of cells (rad).
+///
+/// \return
+/// true - if edge is collapsed,
+/// false - if collapse is impossible.
+bool
+Topology::collapse_edge(Mesh& mesh,
+                        Edge* e,
+                        double feature_angle)
+{
+    Node* u { nullptr };
+    Node* v { nullptr };
+    Node* x { nullptr };
+    Node* y { nullptr };
+
+    if (!get_quad(e, u, v, x, y) || !u->is_inner() || !v->is_inner())
+    {
+        return false;
+    }
+
+    // Nodes opposite to edge must keep at least 3 cells.
+    if ((x->cells_count() <= 3) || (y->cells_count() <= 3))
+    {
+        return false;
+    }
+
+    Cell* c1 { e->cell(0) };
+    Cell* c2 { e->cell(1) };
+
+    // All cells around must be in one zone and domain.
+    for (Node* n : { u, v })
+    {
+        for (size_t i = 0; i < n->cells_count(); ++i)
+        {
+            Cell* c { n->cell(i) };
+
+            if ((c->zone != c1->zone) || (c->domain != c1->domain))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Link condition: common neighbours of u and v are only x and y.
+    for (size_t i = 0; i < u->edges_count(); ++i)
+    {
+        Edge* ue { u->edge(i) };
+        Node* w { (ue->node(0) == u) ? ue->node(1) : ue->node(0) };
+
+        if ((w != v) && (w != x) && (w != y) && (find_edge(v, w) != nullptr))
+        {
+            return false;
+        }
+    }
+
+    geom::Vector p;
+    double new_min_angle { 0.0 };
+
+    geom::Vector::avg(u->point(), v->point(), p);
+
+    if (!is_collapse_correct(e, p, feature_angle, new_min_angle))
+    {
+        return false;
+    }
+
+    size_t j1 { edge_index(c1, e) }, j2 { edge_index(c2, e) };
+    Edge* evx { c1->edge((j1 + 1) % 3) };
+    Edge* exu { c1->edge((j1 + 2) % 3) };
+    Edge* euy { c2->edge((j2 + 1) % 3) };
+    Edge* eyv { c2->edge((j2 + 2) % 3) };
+    Cell* cx { (evx->cell(0) == c1) ? evx->cell(1) : evx->cell(0) };
+    Cell* cy { (eyv->cell(0) == c2) ? eyv->cell(1) : eyv->cell(0) };
+
+    clear_caches(mesh);
+
+    // Ice of removed cells.
+    move_ice(c1, cx);
+    move_ice(c2, cy);
+
+    // Edges (v, x) and (v, y) are replaced with (u, x) and (u, y).
+    replace_item(cx->edges(), evx, exu);
+    replace_item(exu->cells(), c1, cx);
+    replace_item(cy->edges(), eyv, euy);
+    replace_item(euy->cells(), c2, cy);
+
+    // Cells and edges of v go to u.
+    for (Cell* c : v->cells())
+    {
+        if ((c != c1) && (c != c2))
+        {
+            replace_item(c->nodes(), v, u);
+            u->add_cell(c);
+        }
+    }
+
+    for (Edge* ve : v->edges())
+    {
+        if ((ve != e) && (ve != evx) && (ve != eyv))
+        {
+            replace_item(ve->nodes(), v, u);
+            u->add_edge(ve);
+        }
+    }
+
+    remove_item(u->cells(), c1);
+    remove_item(u->cells(), c2);
+    remove_item(u->edges(), e);
+    remove_item(x->cells(), c1);
+    remove_item(x->edges(), evx);
+    remove_item(y->cells(), c2);
+    remove_item(y->edges(), eyv);
+
+    // Detach objects.
+    v->clear_cells();
+    v->clear_edges();
+    v->set_id(-1);
+
+    for (Edge* de : { e, evx, eyv })
+    {
+        de->clear_cells();
+        de->clear_nodes();
+        de->set_id(-1);
+    }
+
+    for (Cell* dc : { c1, c2 })
+    {
+        dc->clear_nodes();
+        dc->clear_edges();
+        dc->set_id(-1);
+    }
+
+    // Move node.
+    geom::Vector d;
+
+    geom::Vector::sub(p, u->point(), d);
+    u->move(d);
+    update_around({ u, x, y });
+    u->save_geometry();
+
+    for (Cell* c : u->cells())
+    {
+        c->save_geometry();
+    }
+
+    for (Edge* ue : u->edges())
+    {
+        ue->save_geometry();
+    }
+
+    return true;
+}
+
+/// \brief Remove objects detached while collapses.
+///
+/// Detached objects are removed from all lists and deleted,
+/// then identifiers are initialized again.
+///
+/// \param[in,out] mesh Mesh.
+void
+Topology::remove_detached(Mesh& mesh)
+{
+    // Remove from zones.
+    for (Zone* z : mesh.get_zones())
+    {
+        remove_detached_items(z->nodes());
+        remove_detached_items(z->edges());
+        remove_detached_items(z->cells());
+    }
+
+    // Remove from own and domains lists.
+    remove_detached_items(mesh.own.edges());
+    remove_detached_items(mesh.own.cells());
+
+    for (vector<Cell*>& dcs : mesh.domains_cells)
+    {
+        remove_detached_items(dcs);
+    }
+
+    mesh.halo.clear();
+
+    // Delete objects.
+    for (Node* n : mesh.all.nodes())
+    {
+        if ((n->get_id() < 0) && (mesh.free_node_data != nullptr))
+        {
+            mesh.free_node_data(n);
+        }
+    }
+
+    for (Edge* e : mesh.all.edges())
+    {
+        if ((e->get_id() < 0) && (mesh.free_edge_data != nullptr))
+        {
+            mesh.free_edge_data(e);
+        }
+    }
+
+    for (Cell* c : mesh.all.cells())
+    {
+        if ((c->get_id() < 0) && (mesh.free_cell_data != nullptr))
+        {
+            mesh.free_cell_data(c);
+        }
+    }
+
+    vector<Node*>& ns { mesh.all.nodes() };
+    vector<Edge*>& es { mesh.all.edges() };
+    vector<Cell*>& cs { mesh.all.cells() };
+    auto nit = stable_partition(ns.begin(), ns.end(), [](Node* n) { return n->get_id() >= 0; });
+    auto eit = stable_partition(es.begin(), es.end(), [](Edge* e) { return e->get_id() >= 0; });
+    auto cit = stable_partition(cs.begin(), cs.end(), [](Cell* c) { return c->get_id() >= 0; });
+
+    for_each(nit, ns.end(), [](Node* n) { delete n; });
+    for_each(eit, es.end(), [](Edge* e) { delete e; });
+    for_each(cit, cs.end(), [](Cell* c) { delete c; });
+    ns.erase(nit, ns.end());
+    es.erase(eit, es.end());
+    cs.erase(cit, cs.end());
+
+    mesh.init_global_identifiers();
+    mesh.init_local_identifiers();
+}
+
+/// \brief Check links consistency.
+///
+/// Check that identifiers are indices,
+/// edge j of cell connects nodes j and (j + 1) of cell,
+/// and all links between nodes, edges and cells are mutual.
+///
+/// \param[in] mesh Mesh.
+///
+/// \return
+/// true - if links are consistent,
+/// false - otherwise.
+bool
+Topology::is_correct(Mesh& mesh)
+{
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        if ((c->get_id() != static_cast<int>(i)) || (c->nodes_count() != 3) || (c->edges_count() != 3))
+        {
+            return false;
+        }
+
+        for (size_t j = 0; j < 3; ++j)
+        {
+            Node* n0 { c->node(j) };
+            Node* n1 { c->node((j + 1) % 3) };
+            Edge* e { c->edge(j) };
+
+            if (!has_item(n0->cells(), c) || !has_item(e->cells(), c)
+                || !(((e->node(0) == n0) && (e->node(1) == n1))
+                     || ((e->node(0) == n1) && (e->node(1) == n0))))
+            {
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < mesh.all.edges_count(); ++i)
+    {
+        Edge* e { mesh.all.edge(i) };
+
+        if ((e->get_id() != static_cast<int>(i)) || (e->nodes_count() != 2)
+            || (e->cells_count() < 1) || (e->cells_count() > 2))
+        {
+            return false;
+        }
+
+        for (size_t j = 0; j < 2; ++j)
+        {
+            if (!has_item(e->node(j)->edges(), e))
+            {
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+    {
+        Node* n { mesh.all.node(i) };
+
+        if (n->get_id() != static_cast<int>(i))
+        {
+            return false;
+        }
+
+        for (Cell* c : n->cells())
+        {
+            if (!has_item(c->nodes(), n))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+//
+// Quality pass.
+//
+
+/// \brief Improve cells quality.
+///
+/// 1. Split edges stretched more than given factor (relative to saved length).
+/// 2. For each cell with small minimum angle:
+///    if cell has big obtuse angle (cap), flip its longest edge,
+///    otherwise (needle) collapse its shortest edge.
+///    Operations are performed only if they improve minimum angle
+///    and do not change cells normals more than feature angle.
+/// 3. Remove detached objects.
+///
+/// \param[in,out] mesh          Mesh.
+/// \param[in]     min_angle     Minimum permitted angle of cell (rad).
+/// \param[in]     split_fact    Maximum permitted stretch of edge.
+/// \param[in]     feature_angle Maximum angle between old and new normals of cells (rad).
+///
+/// \return
+/// Count of operations.
+size_t
+Topology::improve_quality(Mesh& mesh,
+                          double min_angle,
+                          double split_fact,
+                          double feature_angle)
+{
+    static const double cap_angle { 2.0 * mth::Pi / 3.0 };
+    size_t ops { 0 }, collapses { 0 };
+    size_t ec { mesh.all.edges_count() };
+
+    // Split stretched edges.
+    for (size_t i = 0; i < ec; ++i)
+    {
+        Edge* e { mesh.all.edge(i) };
+
+        if (e->length() > split_fact * e->original_length())
+        {
+            split_edge(mesh, e);
+            ++ops;
+        }
+    }
+
+    // Flip and collapse for bad cells.
+    size_t cc { mesh.all.cells_count() };
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        if (c->get_id() < 0)
+        {
+            continue;
+        }
+
+        double mn { 0.0 }, mx { 0.0 };
+
+        triangle_angles(c->node(0)->point(), c->node(1)->point(), c->node(2)->point(), mn, mx);
+
+        if (mn >= min_angle)
+        {
+            continue;
+        }
+
+        // Shortest and longest edges.
+        Edge* se { c->edge(0) };
+        Edge* le { c->edge(0) };
+
+        for (size_t j = 1; j < 3; ++j)
+        {
+            Edge* e { c->edge(j) };
+
+            se = (e->length() < se->length()) ? e : se;
+            le = (e->length() > le->length()) ? e : le;
+        }
+
+        if (mx > cap_angle)
+        {
+            if (is_flip_better(le, feature_angle) && flip_edge(mesh, le))
+            {
+                ++ops;
+            }
+        }
+        else
+        {
+            geom::Vector p;
+            double new_min_angle { 0.0 };
+
+            geom::Vector::avg(se->node(0)->point(), se->node(1)->point(), p);
+
+            if ((se->cells_count() == 2)
+                && is_collapse_correct(se, p, feature_angle, new_min_angle)
+                && (new_min_angle > mn)
+                && collapse_edge(mesh, se, feature_angle))
+            {
+                ++ops;
+                ++collapses;
+            }
+        }
+    }
+
+    if (collapses > 0)
+    {
+        remove_detached(mesh);
+    }
+
+    return ops;
+}
+
+/// @}
+
+}
+
+}
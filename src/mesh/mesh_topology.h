@@ -0,0 +1,182 @@
+/// \file
+/// \brief Mesh topology changes.
+///
+/// Mesh topology changes declaration.
+
+#ifndef CAESAR_MESH_TOPOLOGY_H
+#define CAESAR_MESH_TOPOLOGY_H
+
+#include "mesh_mesh.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Mesh topology changes.
+///
+/// Local operations with edges (split, collapse, flip)
+/// with incremental update of links between nodes, edges and cells,
+/// zones, identifiers, own elements, geometry and cells neighbourhoods.
+/// Edge j of cell always connects nodes j and (j + 1) of cell.
+/// Ice volumes of cells (target, rest and chunks) are conserved.
+/// Operations are supported only for one process
+/// (decomposition boundaries and halo are not updated).
+class Topology
+{
+
+private:
+
+    //
+    // Links.
+    //
+
+    // Find edge between two nodes.
+    static Edge*
+    find_edge(Node* a,
+              Node* b);
+
+    // Index of edge in cell.
+    static size_t
+    edge_index(const Cell* c,
+               const Edge* e);
+
+    // Nodes of two cells around inner edge.
+    static bool
+    get_quad(Edge* e,
+             Node*& u,
+             Node*& v,
+             Node*& x,
+             Node*& y);
+
+    //
+    // Updates.
+    //
+
+    // Clear own edges colors and patches after topology change.
+    static void
+    clear_caches(Mesh& mesh);
+
+    // Register new node.
+    static void
+    register_node(Mesh& mesh,
+                  Node* n,
+                  const Node* from);
+
+    // Register new edge.
+    static void
+    register_edge(Mesh& mesh,
+                  Edge* e,
+                  const Edge* from);
+
+    // Register new cell.
+    static void
+    register_cell(Mesh& mesh,
+                  Cell* c,
+                  const Cell* from);
+
+    // Add edge into zones of its cells.
+    static void
+    add_edge_to_zones(Edge* e);
+
+    // Update geometry and neighbourhoods around nodes.
+    static void
+    update_around(const vector<Node*>& ns);
+
+    // Redistribute ice between two cells.
+    static void
+    redistribute_ice(Cell* c1,
+                     Cell* c2,
+                     double a1,
+                     double a2);
+
+    // Move ice from one cell to another.
+    static void
+    move_ice(Cell* from,
+             Cell* to);
+
+    //
+    // Geometrical checks.
+    //
+
+    // Check if flip of edge improves quality.
+    static bool
+    is_flip_better(Edge* e,
+                   double feature_angle);
+
+    // Check if edge collapse saves cells orientations.
+    static bool
+    is_collapse_correct(Edge* e,
+                        const geom::Vector& p,
+                        double feature_angle,
+                        double& new_min_angle);
+
+public:
+
+    //
+    // Quality of triangles.
+    //
+
+    // Minimum and maximum angles of triangle.
+    static void
+    triangle_angles(const geom::Vector& a,
+                    const geom::Vector& b,
+                    const geom::Vector& c,
+                    double& min_angle,
+                    double& max_angle);
+
+    // Minimum angle of cell.
+    static double
+    cell_min_angle(const Cell* c);
+
+    //
+    // Local operations.
+    //
+
+    // Split edge.
+    static Node*
+    split_edge(Mesh& mesh,
+               Edge* e);
+
+    // Flip edge.
+    static bool
+    flip_edge(Mesh& mesh,
+              Edge* e);
+
+    // Collapse edge.
+    static bool
+    collapse_edge(Mesh& mesh,
+                  Edge* e,
+                  double feature_angle);
+
+    // Remove objects detached while collapses.
+    static void
+    remove_detached(Mesh& mesh);
+
+    // Check links consistency.
+    static bool
+    is_correct(Mesh& mesh);
+
+    //
+    // Quality pass.
+    //
+
+    // Improve cells quality.
+    static size_t
+    improve_quality(Mesh& mesh,
+                    double min_angle,
+                    double split_fact,
+                    double feature_angle);
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_TOPOLOGY_H
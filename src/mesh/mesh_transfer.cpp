@@ -0,0 +1,392 @@
+/// \file
+/// \brief Transfer of data between meshes implementation.
+///
+/// Transfer of data between meshes implementation.
+
+#include "mesh_transfer.h"
+
+#include <cmath>
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Transfer type mapper.
+///
+/// Transfer type mapper.
+utils::Mapper<TransferType> TransferTypeMapper
+{
+    "transfer type",
+    vector<string> { "NODES", "CELLS", "CONSERVATIVE" }
+};
+
+// Static constants definitions.
+const size_t Transfer::max_subdivision_level;
+
+/// \brief Merge items with equal indices.
+///
+/// Sort items by indices and sum weights of items with equal indices.
+///
+/// \param[in,out] items Items (index, weight).
+static void
+merge_items(vector<pair<size_t, double>>& items)
+{
+    size_t n { 0 };
+
+    sort(items.begin(), items.end(),
+         [] (const pair<size_t, double>& a, const pair<size_t, double>& b) { return a.first < b.first; });
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if ((n > 0) && (items[n - 1].first == items[i].first))
+        {
+            items[n - 1].second += items[i].second;
+        }
+        else
+        {
+            items[n++] = items[i];
+        }
+    }
+
+    items.resize(n);
+}
+
+/// \brief Default constructor.
+///
+/// Default constructor.
+Transfer::Transfer()
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+Transfer::~Transfer()
+{
+}
+
+/// \brief Init interpolation weights.
+///
+/// Each target cell center is projected on the source surface
+/// (the closest point is found with cells BVH).
+/// Weights are barycentric coordinates of projection in source cell.
+/// For cells data nodes values are means of values of cells around nodes.
+///
+/// \param[in] src Source mesh.
+/// \param[in] dst Target mesh.
+void
+Transfer::init_interpolation(Mesh& src,
+                             Mesh& dst)
+{
+    size_t dc { dst.all.cells_count() };
+    bool is_nodes { type == TransferType::Nodes };
+    geom::BVH bvh;
+    vector<vector<pair<size_t, double>>> items(dc);
+
+    src.build_cells_bvh(bvh);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (size_t i = 0; i < dc; ++i)
+    {
+        Cell* c { dst.all.cell(i) };
+        geom::Vector q;
+        size_t ti { 0 };
+        double l[3];
+
+        if (!bvh.closest_point(c->center(), q, ti))
+        {
+            continue;
+        }
+
+        Cell* sc { src.all.cell(ti) };
+
+        geom::triangle_barycentric(q,
+                                   sc->node(0)->point(), sc->node(1)->point(), sc->node(2)->point(),
+                                   l[0], l[1], l[2]);
+
+        for (size_t j = 0; j < 3; ++j)
+        {
+            Node* n { sc->node(j) };
+
+            if (is_nodes)
+            {
+                items[i].push_back(make_pair(static_cast<size_t>(n->get_id()), l[j]));
+            }
+            else
+            {
+                size_t ncc { n->cells_count() };
+
+                for (size_t k = 0; k < ncc; ++k)
+                {
+                    items[i].push_back(make_pair(static_cast<size_t>(n->cell(k)->get_id()),
+                                                 l[j] / static_cast<double>(ncc)));
+                }
+            }
+        }
+
+        merge_items(items[i]);
+    }
+
+    // Pack rows.
+    rows.assign(dc + 1, 0);
+
+    for (size_t i = 0; i < dc; ++i)
+    {
+        rows[i + 1] = rows[i] + items[i].size();
+    }
+
+    cols.resize(rows[dc]);
+    weights.resize(rows[dc]);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < dc; ++i)
+    {
+        for (size_t j = 0; j < items[i].size(); ++j)
+        {
+            cols[rows[i] + j] = items[i][j].first;
+            weights[rows[i] + j] = items[i][j].second;
+        }
+    }
+}
+
+/// \brief Init conservative weights.
+///
+/// Each source cell is split into equal subtriangles (count depends on ratio
+/// of source and target cells areas), centers of subtriangles are projected
+/// on the target surface and their areas are given to target cells they hit.
+/// Target cells which are not hit take their area from the source cell
+/// nearest to their centers (reverse mapping).
+/// Weights of each source cell are normalized, so sum of transferred
+/// amounts is equal to sum of source amounts.
+///
+/// \param[in] src Source mesh.
+/// \param[in] dst Target mesh.
+void
+Transfer::init_conservative(Mesh& src,
+                            Mesh& dst)
+{
+    size_t sc { src.all.cells_count() }, dc { dst.all.cells_count() };
+    geom::BVH src_bvh, dst_bvh;
+    vector<vector<pair<size_t, double>>> items(sc);
+
+    src.build_cells_bvh(src_bvh);
+    dst.build_cells_bvh(dst_bvh);
+
+    // Forward mapping.
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < sc; ++i)
+    {
+        Cell* c { src.all.cell(i) };
+        const geom::Vector& a { c->node(0)->point() };
+        geom::Vector ab, ac, p, q;
+        size_t ti { 0 };
+
+        geom::Vector::sub(c->node(1)->point(), a, ab);
+        geom::Vector::sub(c->node(2)->point(), a, ac);
+
+        if (!dst_bvh.closest_point(c->center(), q, ti))
+        {
+            continue;
+        }
+
+        // Level of subdivision.
+        double dst_area { dst.all.cell(ti)->area() };
+        size_t n { 1 };
+
+        if (dst_area > 0.0)
+        {
+            double f { ceil(2.0 * sqrt(c->area() / dst_area)) };
+
+            n = static_cast<size_t>(max(1.0, min(f, static_cast<double>(max_subdivision_level))));
+        }
+
+        double nd { static_cast<double>(n) };
+        double sub_area { c->area() / (nd * nd) };
+
+        // Centers of subtriangles in parametric coordinates:
+        // (i + 1/3, j + 1/3) / n for i + j <= n - 1,
+        // (i + 2/3, j + 2/3) / n for i + j <= n - 2.
+        for (int t = 0; t < 2; ++t)
+        {
+            double shift { (t == 0) ? (1.0 / 3.0) : (2.0 / 3.0) };
+            size_t lim { n - static_cast<size_t>(t) };
+
+            for (size_t si = 0; si < lim; ++si)
+            {
+                for (size_t sj = 0; si + sj < lim; ++sj)
+                {
+                    geom::Vector::linear_combination(ab, (static_cast<double>(si) + shift) / nd,
+                                               ac, (static_cast<double>(sj) + shift) / nd,
+                                               p);
+                    p.add(a);
+
+                    if (dst_bvh.closest_point(p, q, ti))
+                    {
+                        items[i].push_back(make_pair(ti, sub_area));
+                    }
+                }
+            }
+        }
+
+        merge_items(items[i]);
+    }
+
+    // Reverse mapping for target cells which are not hit.
+    vector<char> is_hit(dc, 0);
+    vector<size_t> nearest(dc, sc);
+
+    for (size_t i = 0; i < sc; ++i)
+    {
+        for (const pair<size_t, double>& it : items[i])
+        {
+            is_hit[it.first] = 1;
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (size_t i = 0; i < dc; ++i)
+    {
+        if (!is_hit[i])
+        {
+            geom::Vector q;
+            size_t ti { 0 };
+
+            if (src_bvh.closest_point(dst.all.cell(i)->center(), q, ti))
+            {
+                nearest[i] = ti;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < dc; ++i)
+    {
+        if (nearest[i] < sc)
+        {
+            items[nearest[i]].push_back(make_pair(i, dst.all.cell(i)->area()));
+        }
+    }
+
+    // Normalize weights of source cells.
+    #pragma omp parallel for
+    for (size_t i = 0; i < sc; ++i)
+    {
+        double s { 0.0 };
+
+        for (const pair<size_t, double>& it : items[i])
+        {
+            s += it.second;
+        }
+
+        if (s > 0.0)
+        {
+            for (pair<size_t, double>& it : items[i])
+            {
+                it.second /= s;
+            }
+        }
+    }
+
+    // Transpose into rows.
+    rows.assign(dc + 1, 0);
+
+    for (size_t i = 0; i < sc; ++i)
+    {
+        for (const pair<size_t, double>& it : items[i])
+        {
+            ++rows[it.first + 1];
+        }
+    }
+
+    for (size_t i = 0; i < dc; ++i)
+    {
+        rows[i + 1] += rows[i];
+    }
+
+    vector<size_t> pos(rows.begin(), rows.end() - 1);
+
+    cols.resize(rows[dc]);
+    weights.resize(rows[dc]);
+
+    for (size_t i = 0; i < sc; ++i)
+    {
+        for (const pair<size_t, double>& it : items[i])
+        {
+            size_t k { pos[it.first]++ };
+
+            cols[k] = i;
+            weights[k] = it.second;
+        }
+    }
+}
+
+/// \brief Init transfer.
+///
+/// Calculate transfer weights.
+///
+/// \param[in] src   Source mesh.
+/// \param[in] dst   Target mesh.
+/// \param[in] type_ Transfer type.
+void
+Transfer::init(Mesh& src,
+               Mesh& dst,
+               TransferType type_)
+{
+    type = type_;
+    src_count = (type == TransferType::Nodes) ? src.all.nodes_count() : src.all.cells_count();
+
+    switch (type)
+    {
+        case TransferType::Nodes:
+        case TransferType::Cells:
+            init_interpolation(src, dst);
+            break;
+
+        case TransferType::Conservative:
+            init_conservative(src, dst);
+            break;
+
+        default:
+            DEBUG_ERROR("unexpected transfer type");
+    }
+}
+
+/// \brief Apply transfer to data.
+///
+/// Calculate target data from source data.
+///
+/// \param[in]  src_data Source data.
+/// \param[out] dst_data Target data.
+void
+Transfer::apply(const vector<double>& src_data,
+                vector<double>& dst_data) const
+{
+    size_t dc { dst_count() };
+
+    DEBUG_CHECK_ERROR(src_data.size() == src_count, "wrong source data size for transfer");
+
+    dst_data.resize(dc);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < dc; ++i)
+    {
+        double v { 0.0 };
+
+        for (size_t j = rows[i]; j < rows[i + 1]; ++j)
+        {
+            v += weights[j] * src_data[cols[j]];
+        }
+
+        dst_data[i] = v;
+    }
+}
+
+/// @}
+
+}
+
+}
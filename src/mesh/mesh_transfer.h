@@ -0,0 +1,166 @@
+/// \file
+/// \brief Transfer of data between meshes declaration.
+///
+/// Transfer of data between meshes declaration.
+
+#ifndef CAESAR_MESH_TRANSFER_H
+#define CAESAR_MESH_TRANSFER_H
+
+#include "mesh_mesh.h"
+
+namespace caesar
+{
+
+namespace mesh
+{
+
+/// \addtogroup mesh
+/// @{
+
+/// \brief Transfer type.
+///
+/// Transfer type.
+enum class TransferType
+{
+    /// \brief First element.
+    First = 0,
+
+    /// \brief Interpolation of nodes data into cells.
+    Nodes = First,
+
+    /// \brief Interpolation of cells data into cells.
+    Cells,
+
+    /// \brief Conservative transfer of cells data (amounts) into cells.
+    Conservative,
+
+    /// \brief Last element.
+    Last = Conservative
+};
+
+/// \brief Transfer type mapper.
+///
+/// Transfer type mapper.
+extern utils::Mapper<TransferType> TransferTypeMapper;
+
+/// \brief Transfer of data between meshes.
+///
+/// Transfer is a sparse matrix of weights (CSR format),
+/// each row is a target cell, each column is a source node or cell.
+/// Weights are calculated once and may be applied to many fields.
+class Transfer
+{
+
+private:
+
+    /// \brief Maximum level of source cell subdivision for conservative transfer.
+    static const size_t max_subdivision_level { 16 };
+
+    /// \brief Transfer type.
+    TransferType type { TransferType::Cells };
+
+    /// \brief Count of source elements.
+    size_t src_count { 0 };
+
+    /// \brief Rows begins.
+    vector<size_t> rows;
+
+    /// \brief Columns indices.
+    vector<size_t> cols;
+
+    /// \brief Weights.
+    vector<double> weights;
+
+    // Init interpolation weights.
+    void
+    init_interpolation(Mesh& src,
+                       Mesh& dst);
+
+    // Init conservative weights.
+    void
+    init_conservative(Mesh& src,
+                      Mesh& dst);
+
+public:
+
+    // Default constructor.
+    Transfer();
+
+    // Default destructor.
+    ~Transfer();
+
+    // Init transfer.
+    void
+    init(Mesh& src,
+         Mesh& dst,
+         TransferType type_);
+
+    /// \brief Get transfer type.
+    ///
+    /// Get transfer type.
+    ///
+    /// \return
+    /// Transfer type.
+    inline TransferType
+    get_type() const
+    {
+        return type;
+    }
+
+    /// \brief Count of target elements.
+    ///
+    /// Count of target elements.
+    ///
+    /// \return
+    /// Count of target elements.
+    inline size_t
+    dst_count() const
+    {
+        return rows.empty() ? 0 : (rows.size() - 1);
+    }
+
+    // Apply transfer to data.
+    void
+    apply(const vector<double>& src_data,
+          vector<double>& dst_data) const;
+
+    /// \brief Transfer data element.
+    ///
+    /// Transfer data element from source mesh into target mesh cells.
+    ///
+    /// \tparam    TSrcData  Source data type (node data for nodes transfer, cell data otherwise).
+    /// \tparam    TDstData  Target cell data type.
+    /// \param[in] src       Source mesh.
+    /// \param[in] src_index Source data element index.
+    /// \param[in] dst       Target mesh.
+    /// \param[in] dst_index Target data element index.
+    template<typename TSrcData, typename TDstData>
+    void
+    transfer_element(Mesh& src,
+                     int src_index,
+                     Mesh& dst,
+                     int dst_index) const
+    {
+        vector<double> src_data(src_count), dst_data;
+
+        if (type == TransferType::Nodes)
+        {
+            src.get_nodes_elements<TSrcData>(src_index, src_data.data());
+        }
+        else
+        {
+            src.get_cells_elements<TSrcData>(src_index, src_data.data());
+        }
+
+        apply(src_data, dst_data);
+        dst.set_cells_elements<TDstData>(dst_index, dst_data.data());
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MESH_TRANSFER_H
@@ -13,10 +13,12 @@
 #include "mth_interpolate.h"
 #include "mth_segment.h"
 #include "mth_linear_algebra.h"
+#include "mth_mat.h"
 #include "mth_nonlinear_eqn.h"
 #include "mth_poly_eqn.h"
 #include "mth_segment_function.h"
 #include "mth_sle.h"
+#include "mth_sparse_matrix.h"
 #include "mth_statistics.h"
 
 #endif // !CAESAR_MTH_H
@@ -14,6 +14,8 @@
 #include <eigen3/Eigen/Eigenvalues>
 #endif // !COMPILE_DISABLE_EIGEN
 
+#include "mth_basics.h"
+#include "mth_mat.h"
 #include "utils/utils.h"
 
 namespace caesar
@@ -40,11 +42,36 @@ calc_eigenvalues_and_eigenvectors(const vector<vector<double>>& m,
 
 #ifdef COMPILE_DISABLE_EIGEN
 
-    (void)m;
-    (void)values;
-    (void)vectors;
+    DEBUG_CHECK_ERROR((m.size() == 3) && (m[0].size() == 3), "we work only with 3x3 matrix");
+
+    // Without Eigen we can process only symmetric matrices.
+    if (!is_near(m[0][1], m[1][0]) || !is_near(m[0][2], m[2][0]) || !is_near(m[1][2], m[2][1]))
+    {
+        NOT_IMPLEMENTED;
+    }
+
+    Mat<3, 3> a, vecs;
+    Vec<3> vals;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        for (size_t j = 0; j < 3; ++j)
+        {
+            a(i, j) = m[i][j];
+        }
+    }
+
+    a.calc_symmetric_eigen(vals, vecs);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        values[i] = vals[i];
 
-    NOT_IMPLEMENTED;
+        for (size_t j = 0; j < 3; ++j)
+        {
+            vectors[i][j] = vecs(i, j);
+        }
+    }
 
 #else // !COMPILE_DISABLE_EIGEN
 
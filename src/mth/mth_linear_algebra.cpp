@@ -9,6 +9,7 @@
 
 #include "mth_poly_eqn.h"
 #include "mth_basics.h"
+#include "mth_mat.h"
 #include "utils/utils.h"
 
 using namespace std;
@@ -193,12 +194,14 @@ mul_and_add_line(vector<vector<double>>& m,
 double
 det_3x3(const vector<vector<double>>& m)
 {
-    double a { m[0][0] }, b { m[0][1] }, c { m[0][2] },
-           d { m[1][0] }, e { m[1][1] }, f { m[1][2] },
-           g { m[2][0] }, h { m[2][1] }, i { m[2][2] };
+    Mat<3, 3> a
+    {
+        { m[0][0], m[0][1], m[0][2] },
+        { m[1][0], m[1][1], m[1][2] },
+        { m[2][0], m[2][1], m[2][2] }
+    };
 
-    return (a * e * i) + (b * f * g) + (c * d * h)
-           - (c * e * g) - (b * d * i) - (a * f * h);
+    return a.det();
 }
 
 /// \brief Find real eigenvalues for matrix 3x3.
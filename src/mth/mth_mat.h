@@ -0,0 +1,729 @@
+/// \file
+/// \brief Fixed size vectors and matrices.
+///
+/// Small vectors and matrices with dimensions known at compile time.
+/// Data is stored on stack, so no heap allocations are performed.
+
+#ifndef CAESAR_MTH_MAT_H
+#define CAESAR_MTH_MAT_H
+
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+
+#include "diag/diag.h"
+#include "mth_basics.h"
+
+using namespace std;
+
+namespace caesar
+{
+
+namespace mth
+{
+
+/// \addtogroup mth
+/// @{
+
+/// \brief Fixed size vector.
+///
+/// \tparam N Size.
+template<size_t N>
+class Vec
+{
+
+public:
+
+    /// \brief Data.
+    double v[N];
+
+    /// \brief Default constructor.
+    ///
+    /// Zero vector.
+    Vec()
+    {
+        zero();
+    }
+
+    /// \brief Constructor from list.
+    ///
+    /// Constructor from list of values.
+    ///
+    /// \param[in] l List of values.
+    Vec(initializer_list<double> l)
+    {
+        DEBUG_CHECK_ERROR(l.size() == N, "wrong size of initializer list for Vec");
+
+        size_t i { 0 };
+
+        for (double x : l)
+        {
+            v[i++] = x;
+        }
+    }
+
+    /// \brief Get size.
+    ///
+    /// Get size.
+    ///
+    /// \return
+    /// Size.
+    static constexpr size_t
+    size()
+    {
+        return N;
+    }
+
+    /// \brief Access element.
+    ///
+    /// Access element.
+    ///
+    /// \param[in] i Index.
+    ///
+    /// \return
+    /// Element.
+    inline double&
+    operator[](size_t i)
+    {
+        return v[i];
+    }
+
+    /// \brief Access element.
+    ///
+    /// Access element.
+    ///
+    /// \param[in] i Index.
+    ///
+    /// \return
+    /// Element.
+    inline double
+    operator[](size_t i) const
+    {
+        return v[i];
+    }
+
+    /// \brief Set zero.
+    ///
+    /// Set all elements to zero.
+    inline void
+    zero()
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            v[i] = 0.0;
+        }
+    }
+
+    /// \brief Add vector.
+    ///
+    /// Add vector.
+    ///
+    /// \param[in] b Vector.
+    inline void
+    add(const Vec<N>& b)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            v[i] += b.v[i];
+        }
+    }
+
+    /// \brief Multiply on scalar.
+    ///
+    /// Multiply on scalar.
+    ///
+    /// \param[in] k Scalar.
+    inline void
+    mul(double k)
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            v[i] *= k;
+        }
+    }
+
+    /// \brief Dot product.
+    ///
+    /// Dot product.
+    ///
+    /// \param[in] b Vector.
+    ///
+    /// \return
+    /// Dot product.
+    inline double
+    dot(const Vec<N>& b) const
+    {
+        double r { 0.0 };
+
+        for (size_t i = 0; i < N; ++i)
+        {
+            r += v[i] * b.v[i];
+        }
+
+        return r;
+    }
+};
+
+/// \brief Fixed size matrix.
+///
+/// \tparam R Rows count.
+/// \tparam C Columns count.
+template<size_t R, size_t C>
+class Mat
+{
+
+public:
+
+    /// \brief Data.
+    double m[R][C];
+
+    /// \brief Default constructor.
+    ///
+    /// Zero matrix.
+    Mat()
+    {
+        zero();
+    }
+
+    /// \brief Constructor from list.
+    ///
+    /// Constructor from list of rows.
+    ///
+    /// \param[in] l List of rows.
+    Mat(initializer_list<initializer_list<double>> l)
+    {
+        DEBUG_CHECK_ERROR(l.size() == R, "wrong rows count of initializer list for Mat");
+
+        size_t i { 0 };
+
+        for (const initializer_list<double>& row : l)
+        {
+            DEBUG_CHECK_ERROR(row.size() == C, "wrong columns count of initializer list for Mat");
+
+            size_t j { 0 };
+
+            for (double x : row)
+            {
+                m[i][j++] = x;
+            }
+
+            ++i;
+        }
+    }
+
+    /// \brief Get rows count.
+    ///
+    /// Get rows count.
+    ///
+    /// \return
+    /// Rows count.
+    static constexpr size_t
+    rows()
+    {
+        return R;
+    }
+
+    /// \brief Get columns count.
+    ///
+    /// Get columns count.
+    ///
+    /// \return
+    /// Columns count.
+    static constexpr size_t
+    cols()
+    {
+        return C;
+    }
+
+    /// \brief Access element.
+    ///
+    /// Access element.
+    ///
+    /// \param[in] i Row.
+    /// \param[in] j Column.
+    ///
+    /// \return
+    /// Element.
+    inline double&
+    operator()(size_t i,
+               size_t j)
+    {
+        return m[i][j];
+    }
+
+    /// \brief Access element.
+    ///
+    /// Access element.
+    ///
+    /// \param[in] i Row.
+    /// \param[in] j Column.
+    ///
+    /// \return
+    /// Element.
+    inline double
+    operator()(size_t i,
+               size_t j) const
+    {
+        return m[i][j];
+    }
+
+    /// \brief Set zero.
+    ///
+    /// Set all elements to zero.
+    inline void
+    zero()
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            for (size_t j = 0; j < C; ++j)
+            {
+                m[i][j] = 0.0;
+            }
+        }
+    }
+
+    /// \brief Identity matrix.
+    ///
+    /// Identity matrix.
+    ///
+    /// \return
+    /// Identity matrix.
+    static Mat<R, C>
+    identity()
+    {
+        static_assert(R == C, "identity matrix must be square");
+
+        Mat<R, C> e;
+
+        for (size_t i = 0; i < R; ++i)
+        {
+            e.m[i][i] = 1.0;
+        }
+
+        return e;
+    }
+
+    /// \brief Transpose.
+    ///
+    /// Transpose matrix.
+    ///
+    /// \param[out] t Transposed matrix.
+    inline void
+    transpose(Mat<C, R>& t) const
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            for (size_t j = 0; j < C; ++j)
+            {
+                t.m[j][i] = m[i][j];
+            }
+        }
+    }
+
+    /// \brief Add matrix.
+    ///
+    /// Add matrix.
+    ///
+    /// \param[in] b Matrix.
+    inline void
+    add(const Mat<R, C>& b)
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            for (size_t j = 0; j < C; ++j)
+            {
+                m[i][j] += b.m[i][j];
+            }
+        }
+    }
+
+    /// \brief Multiply on scalar.
+    ///
+    /// Multiply on scalar.
+    ///
+    /// \param[in] k Scalar.
+    inline void
+    mul(double k)
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            for (size_t j = 0; j < C; ++j)
+            {
+                m[i][j] *= k;
+            }
+        }
+    }
+
+    /// \brief Add outer product.
+    ///
+    /// this += k * a * b^T
+    ///
+    /// \param[in] k Factor.
+    /// \param[in] a Column vector.
+    /// \param[in] b Row vector.
+    inline void
+    add_outer_product(double k,
+                      const Vec<R>& a,
+                      const Vec<C>& b)
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            double ka { k * a.v[i] };
+
+            for (size_t j = 0; j < C; ++j)
+            {
+                m[i][j] += ka * b.v[j];
+            }
+        }
+    }
+
+    /// \brief Multiply matrices.
+    ///
+    /// r = a * b
+    ///
+    /// \tparam     K Inner dimension.
+    /// \param[in]  a First matrix.
+    /// \param[in]  b Second matrix.
+    /// \param[out] r Result.
+    template<size_t K>
+    static void
+    mul(const Mat<R, K>& a,
+        const Mat<K, C>& b,
+        Mat<R, C>& r)
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            for (size_t j = 0; j < C; ++j)
+            {
+                double s { 0.0 };
+
+                for (size_t k = 0; k < K; ++k)
+                {
+                    s += a.m[i][k] * b.m[k][j];
+                }
+
+                r.m[i][j] = s;
+            }
+        }
+    }
+
+    /// \brief Multiply matrix on vector.
+    ///
+    /// r = a * x
+    ///
+    /// \param[in]  a Matrix.
+    /// \param[in]  x Vector.
+    /// \param[out] r Result.
+    static void
+    mul(const Mat<R, C>& a,
+        const Vec<C>& x,
+        Vec<R>& r)
+    {
+        for (size_t i = 0; i < R; ++i)
+        {
+            double s { 0.0 };
+
+            for (size_t j = 0; j < C; ++j)
+            {
+                s += a.m[i][j] * x.v[j];
+            }
+
+            r.v[i] = s;
+        }
+    }
+
+    /// \brief Determinant.
+    ///
+    /// Determinant of square matrix.
+    /// Gauss elimination with partial pivoting is used.
+    ///
+    /// \return
+    /// Determinant.
+    double
+    det() const
+    {
+        static_assert(R == C, "determinant is defined only for square matrix");
+
+        Mat<R, C> a(*this);
+        double d { 1.0 };
+
+        for (size_t k = 0; k < R; ++k)
+        {
+            size_t p { k };
+
+            for (size_t i = k + 1; i < R; ++i)
+            {
+                if (abs(a.m[i][k]) > abs(a.m[p][k]))
+                {
+                    p = i;
+                }
+            }
+
+            if (abs(a.m[p][k]) <= numeric_limits<double>::min())
+            {
+                return 0.0;
+            }
+
+            if (p != k)
+            {
+                a.swap_rows(p, k);
+                d = -d;
+            }
+
+            d *= a.m[k][k];
+
+            for (size_t i = k + 1; i < R; ++i)
+            {
+                double f { a.m[i][k] / a.m[k][k] };
+
+                for (size_t j = k; j < C; ++j)
+                {
+                    a.m[i][j] -= f * a.m[k][j];
+                }
+            }
+        }
+
+        return d;
+    }
+
+    /// \brief Inverse matrix.
+    ///
+    /// Inverse square matrix.
+    /// Gauss-Jordan elimination with partial pivoting is used.
+    ///
+    /// \param[out] inv Inverse matrix.
+    ///
+    /// \return
+    /// true - if matrix is not singular,
+    /// false - otherwise.
+    bool
+    inverse(Mat<R, C>& inv) const
+    {
+        static_assert(R == C, "inverse is defined only for square matrix");
+
+        Mat<R, C> a(*this);
+
+        inv = identity();
+
+        for (size_t k = 0; k < R; ++k)
+        {
+            size_t p { k };
+
+            for (size_t i = k + 1; i < R; ++i)
+            {
+                if (abs(a.m[i][k]) > abs(a.m[p][k]))
+                {
+                    p = i;
+                }
+            }
+
+            if (abs(a.m[p][k]) <= numeric_limits<double>::min())
+            {
+                return false;
+            }
+
+            a.swap_rows(p, k);
+            inv.swap_rows(p, k);
+
+            double f { 1.0 / a.m[k][k] };
+
+            for (size_t j = 0; j < C; ++j)
+            {
+                a.m[k][j] *= f;
+                inv.m[k][j] *= f;
+            }
+
+            for (size_t i = 0; i < R; ++i)
+            {
+                if (i == k)
+                {
+                    continue;
+                }
+
+                double g { a.m[i][k] };
+
+                for (size_t j = 0; j < C; ++j)
+                {
+                    a.m[i][j] -= g * a.m[k][j];
+                    inv.m[i][j] -= g * inv.m[k][j];
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /// \brief Eigenvalues and eigenvectors of symmetric matrix.
+    ///
+    /// Cyclic Jacobi method.
+    /// Eigenvalues are sorted in descending order,
+    /// i-th row of vectors is unit eigenvector for i-th eigenvalue.
+    ///
+    /// \param[out] values  Eigenvalues.
+    /// \param[out] vectors Eigenvectors.
+    void
+    calc_symmetric_eigen(Vec<R>& values,
+                         Mat<R, C>& vectors) const
+    {
+        static_assert(R == C, "eigenvalues are defined only for square matrix");
+
+        // Max count of sweeps (Jacobi method converges quadratically).
+        const int max_sweeps { 32 };
+
+        Mat<R, C> a(*this);
+        Mat<R, C> v(identity());
+        double norm { 0.0 };
+
+        for (size_t i = 0; i < R; ++i)
+        {
+            for (size_t j = 0; j < C; ++j)
+            {
+                norm += m[i][j] * m[i][j];
+            }
+        }
+
+        for (int sweep = 0; sweep < max_sweeps; ++sweep)
+        {
+            double off { 0.0 };
+
+            for (size_t p = 0; p < R; ++p)
+            {
+                for (size_t q = p + 1; q < C; ++q)
+                {
+                    off += a.m[p][q] * a.m[p][q];
+                }
+            }
+
+            if (off <= Eps * Eps * norm)
+            {
+                break;
+            }
+
+            for (size_t p = 0; p < R; ++p)
+            {
+                for (size_t q = p + 1; q < C; ++q)
+                {
+                    a.jacobi_rotate(p, q, v);
+                }
+            }
+        }
+
+        // Sort eigenvalues in descending order (selection sort).
+        size_t ord[R];
+
+        for (size_t i = 0; i < R; ++i)
+        {
+            ord[i] = i;
+        }
+
+        for (size_t i = 0; i < R; ++i)
+        {
+            for (size_t j = i + 1; j < R; ++j)
+            {
+                if (a.m[ord[j]][ord[j]] > a.m[ord[i]][ord[i]])
+                {
+                    swap(ord[i], ord[j]);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < R; ++i)
+        {
+            values.v[i] = a.m[ord[i]][ord[i]];
+
+            for (size_t k = 0; k < R; ++k)
+            {
+                vectors.m[i][k] = v.m[k][ord[i]];
+            }
+        }
+    }
+
+private:
+
+    /// \brief Swap rows.
+    ///
+    /// Swap rows.
+    ///
+    /// \param[in] i First row.
+    /// \param[in] j Second row.
+    inline void
+    swap_rows(size_t i,
+              size_t j)
+    {
+        if (i == j)
+        {
+            return;
+        }
+
+        for (size_t k = 0; k < C; ++k)
+        {
+            swap(m[i][k], m[j][k]);
+        }
+    }
+
+    /// \brief Jacobi rotation.
+    ///
+    /// Rotation of symmetric matrix which annihilates (p, q) element.
+    /// Rotation is accumulated in columns of v.
+    ///
+    /// \param[in]     p First index.
+    /// \param[in]     q Second index.
+    /// \param[in,out] v Accumulated rotations.
+    void
+    jacobi_rotate(size_t p,
+                  size_t q,
+                  Mat<R, C>& v)
+    {
+        double apq { m[p][q] };
+
+        if (apq * apq <= numeric_limits<double>::min())
+        {
+            return;
+        }
+
+        double theta { (m[q][q] - m[p][p]) / (2.0 * apq) };
+        double t { 1.0 / (abs(theta) + sqrt(theta * theta + 1.0)) };
+
+        if (theta < 0.0)
+        {
+            t = -t;
+        }
+
+        double c { 1.0 / sqrt(t * t + 1.0) };
+        double s { t * c };
+
+        m[p][p] -= t * apq;
+        m[q][q] += t * apq;
+        m[p][q] = m[q][p] = 0.0;
+
+        for (size_t r = 0; r < R; ++r)
+        {
+            if ((r == p) || (r == q))
+            {
+                continue;
+            }
+
+            double arp { m[r][p] }, arq { m[r][q] };
+
+            m[r][p] = m[p][r] = c * arp - s * arq;
+            m[r][q] = m[q][r] = s * arp + c * arq;
+        }
+
+        for (size_t k = 0; k < R; ++k)
+        {
+            double vkp { v.m[k][p] }, vkq { v.m[k][q] };
+
+            v.m[k][p] = c * vkp - s * vkq;
+            v.m[k][q] = s * vkp + c * vkq;
+        }
+    }
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MTH_MAT_H
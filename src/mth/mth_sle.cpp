@@ -117,6 +117,96 @@ solve_tridiagonal_system(int n,
     return true;
 }
 
+/// \brief Solving system with symmetric positive definite sparse matrix with conjugate gradients method.
+///
+/// Conjugate gradients method with Jacobi (diagonal) preconditioner.
+/// Iterations stop when norm of residual is not greater than eps * norm of right part.
+///
+/// \param[in]     a         Matrix (symmetric positive definite).
+/// \param[in]     b         Right part.
+/// \param[in,out] x         Initial approximation / solution.
+/// \param[in]     eps       Relative accuracy.
+/// \param[in]     max_iters Maximum iterations count.
+/// \param[out]    iters     Iterations count.
+///
+/// \return
+/// true - if required accuracy is reached (possibly on the last iteration),
+/// false - otherwise.
+bool
+solve_conjugate_gradients(const SparseMatrix& a,
+                          const vector<double>& b,
+                          vector<double>& x,
+                          double eps,
+                          size_t max_iters,
+                          size_t& iters)
+{
+    size_t n { a.rows_count() };
+    vector<double> d, r(n), z(n), p(n), q(n);
+    double bb { 0.0 }, rz { 0.0 }, rr { 0.0 };
+
+    x.resize(n, 0.0);
+    a.diagonal(d);
+    a.mul(x, q);
+
+    #pragma omp parallel for reduction(+:bb, rz, rr)
+    for (size_t i = 0; i < n; ++i)
+    {
+        r[i] = b[i] - q[i];
+        z[i] = r[i] / d[i];
+        p[i] = z[i];
+        bb += b[i] * b[i];
+        rz += r[i] * z[i];
+        rr += r[i] * r[i];
+    }
+
+    double lim { eps * eps * bb };
+    size_t it { 0 };
+
+    while ((it < max_iters) && (rr > lim))
+    {
+        double pq { 0.0 };
+
+        a.mul(p, q);
+
+        #pragma omp parallel for reduction(+:pq)
+        for (size_t i = 0; i < n; ++i)
+        {
+            pq += p[i] * q[i];
+        }
+
+        double alfa { rz / pq };
+        double new_rz { 0.0 };
+
+        rr = 0.0;
+
+        #pragma omp parallel for reduction(+:new_rz, rr)
+        for (size_t i = 0; i < n; ++i)
+        {
+            x[i] += alfa * p[i];
+            r[i] -= alfa * q[i];
+            z[i] = r[i] / d[i];
+            new_rz += r[i] * z[i];
+            rr += r[i] * r[i];
+        }
+
+        double beta { new_rz / rz };
+
+        rz = new_rz;
+
+        #pragma omp parallel for
+        for (size_t i = 0; i < n; ++i)
+        {
+            p[i] = z[i] + beta * p[i];
+        }
+
+        ++it;
+    }
+
+    iters = it;
+
+    return rr <= lim;
+}
+
 /// @}
 
 }
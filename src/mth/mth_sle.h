@@ -6,6 +6,8 @@
 #ifndef CAESAR_MTH_SLE_H
 #define CAESAR_MTH_SLE_H
 
+#include "mth_sparse_matrix.h"
+
 namespace caesar
 {
 
@@ -39,6 +41,15 @@ solve_tridiagonal_system(int n,
                          double *beta,
                          double *x);
 
+// Solving system with symmetric positive definite sparse matrix with conjugate gradients method.
+bool
+solve_conjugate_gradients(const SparseMatrix& a,
+                          const vector<double>& b,
+                          vector<double>& x,
+                          double eps,
+                          size_t max_iters,
+                          size_t& iters);
+
 /// @}
 
 }
@@ -0,0 +1,151 @@
+/// \file
+/// \brief Sparse matrix implementation.
+///
+/// Sparse matrix in compressed sparse row format.
+
+#include "mth_sparse_matrix.h"
+
+#include "utils/utils.h"
+
+namespace caesar
+{
+
+namespace mth
+{
+
+/// \addtogroup mth
+/// @{
+
+/// \brief Default constructor.
+///
+/// Default constructor.
+SparseMatrix::SparseMatrix()
+{
+}
+
+/// \brief Default destructor.
+///
+/// Default destructor.
+SparseMatrix::~SparseMatrix()
+{
+}
+
+/// \brief Set structure of matrix.
+///
+/// Set positions of nonzero elements, all values are set to zero.
+///
+/// \param[in] offsets_ Offsets of rows (rows count + 1 elements).
+/// \param[in] cols_    Columns of elements.
+void
+SparseMatrix::set_structure(const vector<size_t>& offsets_,
+                            const vector<size_t>& cols_)
+{
+    DEBUG_CHECK_ERROR(!offsets_.empty() && (offsets_.back() == cols_.size()),
+                      "wrong structure of sparse matrix");
+
+    offsets = offsets_;
+    cols = cols_;
+    vals.assign(cols.size(), 0.0);
+}
+
+/// \brief Add value to element.
+///
+/// Element must be in matrix structure.
+///
+/// \param[in] i Row.
+/// \param[in] j Column.
+/// \param[in] v Value.
+void
+SparseMatrix::add(size_t i,
+                  size_t j,
+                  double v)
+{
+    for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+    {
+        if (cols[k] == j)
+        {
+            vals[k] += v;
+
+            return;
+        }
+    }
+
+    DEBUG_ERROR("no element in sparse matrix structure");
+}
+
+/// \brief Get element.
+///
+/// Get element (zero if it is not in matrix structure).
+///
+/// \param[in] i Row.
+/// \param[in] j Column.
+///
+/// \return
+/// Element value.
+double
+SparseMatrix::get(size_t i,
+                  size_t j) const
+{
+    for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+    {
+        if (cols[k] == j)
+        {
+            return vals[k];
+        }
+    }
+
+    return 0.0;
+}
+
+/// \brief Get diagonal.
+///
+/// Get diagonal.
+///
+/// \param[out] d Diagonal.
+void
+SparseMatrix::diagonal(vector<double>& d) const
+{
+    size_t n { rows_count() };
+
+    d.resize(n);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i)
+    {
+        d[i] = get(i, i);
+    }
+}
+
+/// \brief Multiply matrix on vector.
+///
+/// y = A * x
+///
+/// \param[in]  x Vector.
+/// \param[out] y Result.
+void
+SparseMatrix::mul(const vector<double>& x,
+                  vector<double>& y) const
+{
+    size_t n { rows_count() };
+
+    y.resize(n);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i)
+    {
+        double s { 0.0 };
+
+        for (size_t k = offsets[i]; k < offsets[i + 1]; ++k)
+        {
+            s += vals[k] * x[cols[k]];
+        }
+
+        y[i] = s;
+    }
+}
+
+/// @}
+
+}
+
+}
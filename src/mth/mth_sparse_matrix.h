@@ -0,0 +1,105 @@
+/// \file
+/// \brief Sparse matrix declaration.
+///
+/// Sparse matrix in compressed sparse row format.
+
+#ifndef CAESAR_MTH_SPARSE_MATRIX_H
+#define CAESAR_MTH_SPARSE_MATRIX_H
+
+#include <vector>
+
+using namespace std;
+
+namespace caesar
+{
+
+namespace mth
+{
+
+/// \addtogroup mth
+/// @{
+
+/// \brief Sparse matrix.
+///
+/// Square matrix in compressed sparse row format.
+/// Structure of matrix (positions of nonzero elements) is set once,
+/// then values are accumulated.
+class SparseMatrix
+{
+
+private:
+
+    /// \brief Offsets of rows in columns and values arrays.
+    vector<size_t> offsets;
+
+    /// \brief Columns of elements.
+    vector<size_t> cols;
+
+    /// \brief Values of elements.
+    vector<double> vals;
+
+public:
+
+    // Default constructor.
+    SparseMatrix();
+
+    // Default destructor.
+    ~SparseMatrix();
+
+    // Set structure of matrix.
+    void
+    set_structure(const vector<size_t>& offsets_,
+                  const vector<size_t>& cols_);
+
+    /// \brief Get rows count.
+    ///
+    /// Get rows count.
+    ///
+    /// \return
+    /// Rows count.
+    inline size_t
+    rows_count() const
+    {
+        return offsets.empty() ? 0 : (offsets.size() - 1);
+    }
+
+    /// \brief Get nonzero elements count.
+    ///
+    /// Get nonzero elements count.
+    ///
+    /// \return
+    /// Nonzero elements count.
+    inline size_t
+    nonzeros_count() const
+    {
+        return vals.size();
+    }
+
+    // Add value to element.
+    void
+    add(size_t i,
+        size_t j,
+        double v);
+
+    // Get element.
+    double
+    get(size_t i,
+        size_t j) const;
+
+    // Get diagonal.
+    void
+    diagonal(vector<double>& d) const;
+
+    // Multiply matrix on vector.
+    void
+    mul(const vector<double>& x,
+        vector<double>& y) const;
+};
+
+/// @}
+
+}
+
+}
+
+#endif // !CAESAR_MTH_SPARSE_MATRIX_H
@@ -3,6 +3,7 @@
 
 #include "mth_statistics.h"
 
+#include <algorithm>
 #include <numeric>
 
 namespace caesar
@@ -44,6 +45,121 @@ mean(const vector<double>& v)
     return (s == 0) ? 0.0 : (sum(v) / static_cast<double>(s));
 }
 
+/// \brief Quantile of vector elements.
+///
+/// Quantile of vector elements found with selection (without full sort).
+/// Order of vector elements is changed.
+///
+/// \param[in,out] v Vector of doubles.
+/// \param[in]     q Quantile level (from 0.0 to 1.0).
+///
+/// \return
+/// Element with position q * (size - 1) in sorted vector.
+double
+quantile(vector<double>& v,
+         double q)
+{
+    size_t s { v.size() };
+
+    DEBUG_CHECK_ERROR(s > 0, "quantile of empty vector");
+
+    size_t k { static_cast<size_t>(q * static_cast<double>(s - 1) + 0.5) };
+
+    k = min(k, s - 1);
+    nth_element(v.begin(), v.begin() + static_cast<long>(k), v.end());
+
+    return v[k];
+}
+
+/// \brief Histogram of vector elements.
+///
+/// Add counts of vector elements to histogram with bins of equal width.
+/// Values outside [lo, hi] are counted in the first or the last bin.
+/// Histogram is double vector to be reduced with MPI.
+///
+/// \param[in]     v  Vector of doubles.
+/// \param[in]     lo Low bound of histogram.
+/// \param[in]     hi High bound of histogram.
+/// \param[in,out] h  Histogram (its size is count of bins).
+void
+histogram(const vector<double>& v,
+          double lo,
+          double hi,
+          vector<double>& h)
+{
+    size_t s { v.size() }, bc { h.size() };
+
+    if (bc == 0)
+    {
+        return;
+    }
+
+    double k { (hi > lo) ? (static_cast<double>(bc) / (hi - lo)) : 0.0 };
+
+    #pragma omp parallel
+    {
+        vector<double> local(bc, 0.0);
+
+        #pragma omp for
+        for (size_t i = 0; i < s; ++i)
+        {
+            double x { (v[i] - lo) * k };
+            size_t b { (x > 0.0) ? min(static_cast<size_t>(x), bc - 1) : 0 };
+
+            local[b] += 1.0;
+        }
+
+        #pragma omp critical
+        {
+            for (size_t i = 0; i < bc; ++i)
+            {
+                h[i] += local[i];
+            }
+        }
+    }
+}
+
+/// \brief Quantile by histogram.
+///
+/// Approximate quantile by histogram with linear interpolation inside bin.
+///
+/// \param[in] h  Histogram.
+/// \param[in] lo Low bound of histogram.
+/// \param[in] hi High bound of histogram.
+/// \param[in] q  Quantile level (from 0.0 to 1.0).
+///
+/// \return
+/// Quantile value.
+double
+histogram_quantile(const vector<double>& h,
+                   double lo,
+                   double hi,
+                   double q)
+{
+    size_t bc { h.size() };
+    double total { sum(h) };
+
+    if ((bc == 0) || (total <= 0.0))
+    {
+        return lo;
+    }
+
+    double target { q * total }, acc { 0.0 };
+    double w { (hi - lo) / static_cast<double>(bc) };
+
+    for (size_t i = 0; i < bc; ++i)
+    {
+        if ((h[i] > 0.0) && (acc + h[i] >= target))
+        {
+            return lo + w * (static_cast<double>(i) + (target - acc) / h[i]);
+        }
+
+        acc += h[i];
+    }
+
+    return hi;
+}
+
 /// @}
 
 }
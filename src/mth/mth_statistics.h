@@ -25,6 +25,25 @@ sum(const vector<double>& v);
 double
 mean(const vector<double>& v);
 
+// Quantile of vector elements.
+double
+quantile(vector<double>& v,
+         double q);
+
+// Histogram of vector elements.
+void
+histogram(const vector<double>& v,
+          double lo,
+          double hi,
+          vector<double>& h);
+
+// Quantile by histogram.
+double
+histogram_quantile(const vector<double>& h,
+                   double lo,
+                   double hi,
+                   double q);
+
 /// @}
 
 }
@@ -28,6 +28,16 @@ Buffers::~Buffers()
 {
 }
 
+/// \brief Clear buffers.
+///
+/// Remove all buffers and requests, so buffers may be allocated again.
+void
+Buffers::clear()
+{
+    buffers.clear();
+    requests.resize(0);
+}
+
 //
 // Print information.
 //
@@ -70,6 +70,10 @@ public:
         return buffers[i].get_out_data();
     }
 
+    // Clear buffers.
+    void
+    clear();
+
     //
     // Print information.
     //
@@ -481,6 +481,98 @@ mpi_reduce_sum(vector<double>& out_data,
 
 }
 
+#ifdef COMPILE_ENABLE_MPI
+
+/// \brief MPI allreduce.
+///
+/// MPI allreduce in place (result is written to the same vector in all processes).
+///
+/// \param[in,out] data Data vector.
+/// \param[in]     op   Operation.
+static void
+mpi_allreduce(vector<double>& data,
+              MPI_Op op)
+{
+    if (!is_mpi_initialized())
+    {
+        return;
+    }
+
+    vector<double> local(data);
+
+    MPI_Allreduce(local.data(),
+                  data.data(),
+                  static_cast<int>(data.size()),
+                  MPI_DOUBLE,
+                  op,
+                  MPI_COMM_WORLD);
+}
+
+#endif // COMPILE_ENABLE_MPI
+
+/// \brief MPI allreduce with add operation.
+///
+/// Sum vectors of all processes, result is set in all processes.
+///
+/// \param[in,out] data Data vector.
+void
+mpi_allreduce_sum(vector<double>& data)
+{
+
+#ifdef COMPILE_ENABLE_MPI
+
+    mpi_allreduce(data, MPI_SUM);
+
+#else // !COMPILE_ENABLE_MPI
+
+    (void)data;
+
+#endif // COMPILE_ENABLE_MPI
+
+}
+
+/// \brief MPI allreduce with min operation.
+///
+/// Elementwise minimum of vectors of all processes, result is set in all processes.
+///
+/// \param[in,out] data Data vector.
+void
+mpi_allreduce_min(vector<double>& data)
+{
+
+#ifdef COMPILE_ENABLE_MPI
+
+    mpi_allreduce(data, MPI_MIN);
+
+#else // !COMPILE_ENABLE_MPI
+
+    (void)data;
+
+#endif // COMPILE_ENABLE_MPI
+
+}
+
+/// \brief MPI allreduce with max operation.
+///
+/// Elementwise maximum of vectors of all processes, result is set in all processes.
+///
+/// \param[in,out] data Data vector.
+void
+mpi_allreduce_max(vector<double>& data)
+{
+
+#ifdef COMPILE_ENABLE_MPI
+
+    mpi_allreduce(data, MPI_MAX);
+
+#else // !COMPILE_ENABLE_MPI
+
+    (void)data;
+
+#endif // COMPILE_ENABLE_MPI
+
+}
+
 /// @}
 
 }
@@ -150,6 +150,18 @@ void
 mpi_reduce_sum(vector<double>& out_data,
                vector<double>& in_data);
 
+// MPI allreduce with add operation.
+void
+mpi_allreduce_sum(vector<double>& data);
+
+// MPI allreduce with min operation.
+void
+mpi_allreduce_min(vector<double>& data);
+
+// MPI allreduce with max operation.
+void
+mpi_allreduce_max(vector<double>& data);
+
 /// @}
 
 }
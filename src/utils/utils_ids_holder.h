@@ -33,6 +33,11 @@ private:
     /// \brief Local identifer.
     int loc_id { -1 };
 
+    /// \brief Original identifier.
+    ///
+    /// Identifier of object in whole mesh (for part of mesh loaded from domain file).
+    int orig_id { -1 };
+
 public:
 
     //
@@ -63,6 +68,18 @@ public:
         return loc_id;
     }
 
+    /// \brief Get original identifier.
+    ///
+    /// Get original identifier.
+    ///
+    /// \return
+    /// Original identifier.
+    inline int
+    get_orig_id() const
+    {
+        return orig_id;
+    }
+
     //
     // Setters.
     //
@@ -89,6 +106,39 @@ public:
         loc_id = loc_id_;
     }
 
+    /// \brief Set original identifier.
+    ///
+    /// Set original identifier.
+    ///
+    /// \param[in] orig_id_ Identifier.
+    inline void
+    set_orig_id(int orig_id_)
+    {
+        orig_id = orig_id_;
+    }
+
+    //
+    // Compare.
+    //
+
+    /// \brief Compare objects by original identifiers.
+    ///
+    /// Objects are compared by original identifiers, then by identifiers.
+    /// If original identifiers are set order does not depend on numbering of objects in process.
+    ///
+    /// \param[in] a First object.
+    /// \param[in] b Second object.
+    ///
+    /// \return
+    /// true - if first object is less than second one,
+    /// false - otherwise.
+    static inline bool
+    is_less_by_orig_id(const IdsHolder* a,
+                       const IdsHolder* b)
+    {
+        return (a->orig_id < b->orig_id) || ((a->orig_id == b->orig_id) && (a->id < b->id));
+    }
+
     //
     // Get string.
     //
@@ -0,0 +1,259 @@
+/// \file
+/// \brief Tests for bounding volume hierarchy.
+///
+/// Tests for bounding volume hierarchy.
+
+#include <catch2/catch_test_macros.hpp>
+#include <limits>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+TEST_CASE("BVH : closest point and ray queries", "[geom]")
+{
+    SECTION("single triangle")
+    {
+        vector<geom::Vector> ps;
+        vector<size_t> ts { 0, 1, 2 };
+        geom::BVH bvh;
+        geom::Vector q;
+        size_t ti { 0 };
+        double t { 0.0 };
+
+        ps.push_back(geom::Vector(0.0, 0.0, 0.0));
+        ps.push_back(geom::Vector(1.0, 0.0, 0.0));
+        ps.push_back(geom::Vector(0.0, 1.0, 0.0));
+        bvh.build(ps, ts);
+
+        CHECK(bvh.nodes_count() == 1);
+        CHECK(bvh.is_correct());
+
+        // Face region.
+        CHECK(bvh.closest_point(geom::Vector(0.25, 0.25, 1.0), q, ti));
+        CHECK(q.is_near(geom::Vector(0.25, 0.25, 0.0), mth::Eps));
+        CHECK(ti == 0);
+
+        // Vertex region.
+        CHECK(bvh.closest_point(geom::Vector(-1.0, -1.0, 0.0), q, ti));
+        CHECK(q.is_near(geom::Vector(0.0, 0.0, 0.0), mth::Eps));
+
+        // Edge region.
+        CHECK(bvh.closest_point(geom::Vector(1.0, 1.0, 0.0), q, ti));
+        CHECK(q.is_near(geom::Vector(0.5, 0.5, 0.0), mth::Eps));
+
+        // Rays.
+        CHECK(bvh.ray_first_hit(geom::Vector(0.25, 0.25, 1.0), geom::Vector(0.0, 0.0, -1.0), 10.0, t, ti));
+        CHECK(mth::is_eq(t, 1.0));
+        CHECK(!bvh.ray_first_hit(geom::Vector(0.25, 0.25, 1.0), geom::Vector(0.0, 0.0, -1.0), 0.5, t, ti));
+        CHECK(!bvh.ray_first_hit(geom::Vector(0.75, 0.75, 1.0), geom::Vector(0.0, 0.0, -1.0), 10.0, t, ti));
+
+        // Triangles intersection.
+        CHECK(geom::triangles_intersection(ps[0], ps[1], ps[2],
+                                           geom::Vector(0.2, 0.2, -1.0),
+                                           geom::Vector(0.2, 0.2, 1.0),
+                                           geom::Vector(2.0, 2.0, 0.0)));
+        CHECK(!geom::triangles_intersection(ps[0], ps[1], ps[2],
+                                            geom::Vector(0.2, 0.2, 0.5),
+                                            geom::Vector(0.2, 0.2, 1.0),
+                                            geom::Vector(2.0, 2.0, 0.5)));
+    }
+
+    SECTION("mesh triangles against brute force")
+    {
+        Mesh mesh;
+        geom::BVH bvh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        mesh.build_cells_bvh(bvh);
+
+        size_t cc { mesh.all.cells_count() };
+
+        CHECK(bvh.triangles_count() == cc);
+        CHECK(bvh.is_correct());
+
+        // Query points on regular grid around sphere.
+        vector<geom::Vector> ps, qs;
+        vector<size_t> tis;
+        geom::Box box;
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            box.extend(bvh.triangle_box(i));
+        }
+
+        for (int i = 0; i < 5; ++i)
+        {
+            for (int j = 0; j < 5; ++j)
+            {
+                for (int k = 0; k < 5; ++k)
+                {
+                    double fi { static_cast<double>(i) / 4.0 };
+                    double fj { static_cast<double>(j) / 4.0 };
+                    double fk { static_cast<double>(k) / 4.0 };
+
+                    ps.push_back(geom::Vector(box.lo.x + 1.5 * (fi - 0.25) * (box.hi.x - box.lo.x),
+                                              box.lo.y + 1.5 * (fj - 0.25) * (box.hi.y - box.lo.y),
+                                              box.lo.z + 1.5 * (fk - 0.25) * (box.hi.z - box.lo.z)));
+                }
+            }
+        }
+
+        bvh.closest_points(ps, qs, tis);
+
+        for (size_t i = 0; i < ps.size(); ++i)
+        {
+            double best { numeric_limits<double>::infinity() };
+            geom::Vector q;
+
+            for (size_t j = 0; j < cc; ++j)
+            {
+                geom::triangle_closest_point(ps[i],
+                                             bvh.triangle_point(j, 0),
+                                             bvh.triangle_point(j, 1),
+                                             bvh.triangle_point(j, 2),
+                                             q);
+                best = min(best, q.dist_to(ps[i]));
+            }
+
+            CHECK(tis[i] < cc);
+            CHECK(mth::is_eq(qs[i].dist_to(ps[i]), best));
+        }
+
+        // Rays from grid points to sphere center.
+        vector<geom::Vector> ds;
+        vector<double> ts;
+        geom::Vector center;
+
+        box.calc_center(center);
+
+        for (size_t i = 0; i < ps.size(); ++i)
+        {
+            geom::Vector d;
+
+            geom::Vector::sub(center, ps[i], d);
+            ds.push_back(d);
+        }
+
+        bvh.rays_first_hits(ps, ds, 1.0, ts, tis);
+
+        for (size_t i = 0; i < ps.size(); ++i)
+        {
+            double best { numeric_limits<double>::infinity() };
+
+            for (size_t j = 0; j < cc; ++j)
+            {
+                double t { 0.0 };
+
+                if (geom::triangle_ray_intersection(ps[i], ds[i],
+                                                    bvh.triangle_point(j, 0),
+                                                    bvh.triangle_point(j, 1),
+                                                    bvh.triangle_point(j, 2),
+                                                    t)
+                    && (t <= 1.0))
+                {
+                    best = min(best, t);
+                }
+            }
+
+            if (best < 2.0)
+            {
+                CHECK(tis[i] < cc);
+                CHECK(mth::is_eq(ts[i], best));
+            }
+            else
+            {
+                CHECK(tis[i] == numeric_limits<size_t>::max());
+            }
+        }
+
+        // Refit after shifting the mesh.
+        for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+        {
+            mesh.all.node(i)->move(geom::Vector(1.0, 2.0, 3.0));
+        }
+
+        mesh.refit_cells_bvh(bvh);
+
+        CHECK(bvh.is_correct());
+
+        geom::Vector q;
+        size_t ti { 0 };
+        geom::Vector p(ps[0].x + 1.0, ps[0].y + 2.0, ps[0].z + 3.0);
+
+        CHECK(bvh.closest_point(p, q, ti));
+        CHECK(mth::is_eq(q.dist_to(p), qs[0].dist_to(ps[0])));
+
+        mesh.clear();
+    }
+
+    SECTION("depth of tree is limited")
+    {
+        // Triangles with exponentially growing coordinates give unbalanced splits.
+        const size_t n { 200 };
+        vector<geom::Vector> ps;
+        vector<size_t> ts;
+        geom::BVH bvh;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            double x { pow(1.5, static_cast<double>(i)) };
+
+            ps.push_back(geom::Vector(x, 0.0, 0.0));
+            ps.push_back(geom::Vector(x, 1.0, 0.0));
+            ps.push_back(geom::Vector(x, 0.0, 1.0));
+            ts.push_back(3 * i);
+            ts.push_back(3 * i + 1);
+            ts.push_back(3 * i + 2);
+        }
+
+        bvh.build(ps, ts);
+
+        CHECK(bvh.is_correct());
+
+        for (size_t i = 0; i < n; i += 7)
+        {
+            geom::Vector p(ps[3 * i].x, 0.25, 0.25), q;
+            size_t ti { 0 };
+            double t { 0.0 };
+
+            // Closest point is on the triangle in the same plane.
+            CHECK(bvh.closest_point(p, q, ti));
+            CHECK(ti == i);
+            CHECK(q.is_near(p, mth::Eps));
+
+            // Ray along x hits the triangle right after the start point.
+            CHECK(bvh.ray_first_hit(geom::Vector(0.95 * ps[3 * i].x, 0.25, 0.25),
+                                    geom::Vector(1.0, 0.0, 0.0),
+                                    numeric_limits<double>::infinity(), t, ti));
+            CHECK(ti == i);
+            CHECK(mth::is_eq(t / ps[3 * i].x, 0.05));
+        }
+    }
+
+    SECTION("ray parallel to faces of box")
+    {
+        geom::Box b;
+        geom::Vector d(1.0, 0.0, 0.0);
+        geom::Vector inv_d(1.0 / d.x, 1.0 / d.y, 1.0 / d.z);
+        double tnear { 0.0 };
+
+        b.extend(geom::Vector(0.0, 0.0, 0.0));
+        b.extend(geom::Vector(1.0, 1.0, 1.0));
+
+        // Ray on faces of box (0 * inf is not calculated).
+        CHECK(b.intersect_ray(geom::Vector(-1.0, 1.0, 0.5), inv_d, 10.0, tnear));
+        CHECK(mth::is_eq(tnear, 1.0));
+        CHECK(b.intersect_ray(geom::Vector(-1.0, 0.0, 1.0), inv_d, 10.0, tnear));
+        CHECK(mth::is_eq(tnear, 1.0));
+
+        // Ray inside box starts at its origin.
+        CHECK(b.intersect_ray(geom::Vector(0.5, 0.5, 0.5), inv_d, 10.0, tnear));
+        CHECK(mth::is_eq(tnear, 0.0));
+
+        // Ray out of slab or too short.
+        CHECK(!b.intersect_ray(geom::Vector(-1.0, 2.0, 0.5), inv_d, 10.0, tnear));
+        CHECK(!b.intersect_ray(geom::Vector(-1.0, 0.5, 0.5), inv_d, 0.5, tnear));
+    }
+}
@@ -0,0 +1,60 @@
+/// \file
+/// \brief Tests for displaced triangles.
+///
+/// Tests for displaced triangles.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace caesar;
+
+TEST_CASE("Displaced triangle", "[geom]")
+{
+    SECTION("displaced triangle volume")
+    {
+        geom::Vector a(0.0, 0.0, 0.0), b(1.0, 0.0, 0.0), c(0.0, 1.0, 0.0);
+        geom::Vector na(0.0, 0.0, 2.0), nb(1.0, 0.0, 2.0), nc(0.0, 1.0, 2.0);
+
+        CHECK(mth::is_eq(geom::displaced_triangle_volume(a, b, c, na, nb, nc), 1.0));
+    }
+
+    SECTION("batch versions")
+    {
+        const size_t n { 19 };
+        geom::VectorsArray a(n), b(n), c(n), na(n), nb(n), nc(n);
+        vector<double> vs, ts;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            double f { static_cast<double>(i) };
+
+            a.set(i, geom::Vector(0.0, 0.0, 0.1 * f));
+            b.set(i, geom::Vector(1.0 + f, 0.0, 0.0));
+            c.set(i, geom::Vector(0.0, 1.0, 0.0));
+            na.set(i, geom::Vector(0.1 * f, 0.0, 1.0));
+            nb.set(i, geom::Vector(1.0 + f, 0.2, 1.0 + f));
+            nc.set(i, geom::Vector(0.0, 1.0, 0.5));
+        }
+
+        geom::displaced_triangle_volume(a, b, c, na, nb, nc, vs);
+        geom::tetrahedron_volume(a, b, c, na, ts);
+
+        REQUIRE(vs.size() == n);
+        REQUIRE(ts.size() == n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            geom::Vector pa, pb, pc, pna, pnb, pnc;
+
+            a.get(i, pa);
+            b.get(i, pb);
+            c.get(i, pc);
+            na.get(i, pna);
+            nb.get(i, pnb);
+            nc.get(i, pnc);
+
+            CHECK(mth::is_eq(vs[i], geom::displaced_triangle_volume(pa, pb, pc, pna, pnb, pnc)));
+            CHECK(mth::is_eq(ts[i], geom::tetrahedron_volume(pa, pb, pc, pna)));
+        }
+    }
+}
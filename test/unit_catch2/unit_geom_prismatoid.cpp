@@ -23,4 +23,47 @@ TEST_CASE("Prismatoid", "[geom]")
         CHECK(mth::is_eq(b, 0.0));
         CHECK(mth::is_eq(c, 0.0));
     }
+
+    SECTION("prismatoid volume coefficients batch version")
+    {
+        const size_t n { 17 };
+        geom::VectorsArray v1(n), v2(n), v3(n), n1(n), n2(n), n3(n), nn(n);
+        vector<double> as, bs, cs;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            double f { static_cast<double>(i) };
+
+            v1.set(i, geom::Vector(0.0, 0.1 * f, 0.0));
+            v2.set(i, geom::Vector(1.0 + f, 0.0, 0.0));
+            v3.set(i, geom::Vector(0.0, 1.0, 0.2 * f));
+            n1.set(i, geom::Vector(0.1 * f, 0.0, 1.0));
+            n2.set(i, geom::Vector(0.0, 0.1, 1.0));
+            n3.set(i, geom::Vector(0.0, -0.05 * f, 1.0));
+            nn.set(i, geom::Vector(0.0, 0.0, 1.0));
+        }
+
+        geom::prismatoid_volume_coefficients(v1, v2, v3, n1, n2, n3, nn, as, bs, cs);
+
+        REQUIRE(as.size() == n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            geom::Vector w1, w2, w3, m1, m2, m3, m;
+            double a, b, c;
+
+            v1.get(i, w1);
+            v2.get(i, w2);
+            v3.get(i, w3);
+            n1.get(i, m1);
+            n2.get(i, m2);
+            n3.get(i, m3);
+            nn.get(i, m);
+            geom::prismatoid_volume_coefficients(w1, w2, w3, m1, m2, m3, m, a, b, c);
+
+            CHECK(mth::is_eq(as[i], a));
+            CHECK(mth::is_eq(bs[i], b));
+            CHECK(mth::is_eq(cs[i], c));
+        }
+    }
 }
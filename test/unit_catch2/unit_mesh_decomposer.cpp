@@ -0,0 +1,866 @@
+/// \file
+/// \brief Tests for mesh decomposer.
+///
+/// Tests for mesh decomposer.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+/// \brief Count of cross edges.
+///
+/// Count of edges between cells of different domains.
+///
+/// \param[in] mesh Mesh.
+///
+/// \return
+/// Count of cross edges.
+static size_t
+cross_edges_count(Mesh& mesh)
+{
+    size_t cnt { 0 };
+
+    for (size_t i = 0; i < mesh.all.edges_count(); ++i)
+    {
+        if (mesh.all.edge(i)->is_cross())
+        {
+            ++cnt;
+        }
+    }
+
+    return cnt;
+}
+
+TEST_CASE("Decomposer : multilevel", "[mesh]")
+{
+    SECTION("balanced domains with small edge cut")
+    {
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        size_t cc { mesh.all.cells_count() };
+
+        for (size_t dn : vector<size_t> { 2, 4, 8 })
+        {
+            Decomposer::decompose(mesh, DecompositionType::Linear, dn, false);
+
+            size_t linear_cut { cross_edges_count(mesh) };
+
+            Decomposer::decompose(mesh, DecompositionType::Farhat, dn, false);
+
+            size_t farhat_cut { cross_edges_count(mesh) };
+
+            Decomposer::decompose(mesh, DecompositionType::Multilevel, dn);
+
+            size_t multilevel_cut { cross_edges_count(mesh) };
+            vector<size_t> sizes(dn, 0);
+
+            for (size_t i = 0; i < cc; ++i)
+            {
+                ++sizes[mesh.all.cell(i)->get_domain()];
+            }
+
+            // All domains are used and balanced.
+            for (size_t s : sizes)
+            {
+                CHECK(s > 0);
+                CHECK(static_cast<double>(s) <= 1.03 * static_cast<double>(cc) / static_cast<double>(dn) + 1.0);
+            }
+
+            CHECK(multilevel_cut < linear_cut);
+            CHECK(multilevel_cut <= farhat_cut);
+
+            // Cut of dual graph is the same as count of cross edges.
+            PartitionGraph g;
+            vector<size_t> parts(cc);
+
+            Partitioner::build_dual_graph(mesh.all, g);
+
+            for (size_t i = 0; i < cc; ++i)
+            {
+                parts[i] = mesh.all.cell(i)->get_domain();
+            }
+
+            CHECK(Partitioner::edge_cut(g, parts) == multilevel_cut);
+        }
+
+        mesh.clear();
+    }
+}
+
+TEST_CASE("Decomposer : geometric", "[mesh]")
+{
+    SECTION("rcb and hilbert give balanced compact domains")
+    {
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        size_t cc { mesh.all.cells_count() };
+
+        for (size_t dn : vector<size_t> { 3, 8 })
+        {
+            Decomposer::decompose(mesh, DecompositionType::Linear, dn, false);
+
+            size_t linear_cut { cross_edges_count(mesh) };
+
+            for (DecompositionType t : { DecompositionType::RCB, DecompositionType::Hilbert })
+            {
+                Decomposer::decompose(mesh, t, dn, false);
+
+                vector<size_t> sizes(dn, 0);
+
+                for (size_t i = 0; i < cc; ++i)
+                {
+                    ++sizes[mesh.all.cell(i)->get_domain()];
+                }
+
+                // Sizes of domains differ not more than by one cell.
+                for (size_t s : sizes)
+                {
+                    CHECK(s >= cc / dn);
+                    CHECK(s <= cc / dn + 1);
+                }
+
+                CHECK(cross_edges_count(mesh) < linear_cut / 2);
+            }
+        }
+
+        mesh.clear();
+    }
+}
+
+TEST_CASE("Decomposer : refinement", "[mesh]")
+{
+    SECTION("cross edges and neighbour domains are reduced")
+    {
+        const size_t dn { 6 };
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        size_t cc { mesh.all.cells_count() };
+        size_t max_size { static_cast<size_t>(1.03 * static_cast<double>(cc) / static_cast<double>(dn)) };
+        PartitionGraph g;
+
+        Partitioner::build_dual_graph(mesh.all, g);
+
+        for (DecompositionType t : { DecompositionType::Random, DecompositionType::Linear, DecompositionType::Farhat })
+        {
+            vector<size_t> parts(cc), refined_parts;
+            vector<size_t> sizes(dn, 0), refined_sizes(dn, 0);
+
+            Decomposer::decompose(mesh, t, dn, false);
+
+            for (size_t i = 0; i < cc; ++i)
+            {
+                parts[i] = mesh.all.cell(i)->get_domain();
+                ++sizes[parts[i]];
+            }
+
+            refined_parts = parts;
+            Partitioner::refine_fm(g, dn, 1.03, refined_parts);
+
+            for (size_t i = 0; i < cc; ++i)
+            {
+                ++refined_sizes[refined_parts[i]];
+            }
+
+            CHECK(Partitioner::edge_cut(g, refined_parts) < Partitioner::edge_cut(g, parts));
+            CHECK(Partitioner::adjacent_parts_pairs_count(g, dn, refined_parts)
+                  <= Partitioner::adjacent_parts_pairs_count(g, dn, parts));
+
+            // Domains do not become too heavy.
+            for (size_t d = 0; d < dn; ++d)
+            {
+                CHECK(refined_sizes[d] > 0);
+                CHECK(refined_sizes[d] <= max(max_size, sizes[d]));
+            }
+
+            // Decomposer refines the same way.
+            if (t != DecompositionType::Random)
+            {
+                bool is_same { true };
+
+                Decomposer::decompose(mesh, t, dn);
+
+                for (size_t i = 0; i < cc; ++i)
+                {
+                    is_same = is_same && (mesh.all.cell(i)->get_domain() == refined_parts[i]);
+                }
+
+                CHECK(is_same);
+            }
+        }
+
+        mesh.clear();
+    }
+}
+
+TEST_CASE("Decomposer : report", "[mesh]")
+{
+    SECTION("metrics correspond to domains of cells")
+    {
+        const size_t dn { 4 };
+        Mesh mesh;
+        DecompositionReport r;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::Linear, dn, false);
+        Decomposer::report(mesh, r);
+
+        size_t cells { 0 }, bytes { 0 };
+
+        CHECK(r.domains_count == dn);
+        CHECK(r.cut_edges == cross_edges_count(mesh));
+
+        for (size_t d = 0; d < dn; ++d)
+        {
+            cells += r.cells[d];
+            bytes += r.exchange_bytes[d];
+            CHECK(r.boundary_pairs[d][d] == 0);
+
+            for (size_t q = 0; q < dn; ++q)
+            {
+                CHECK(r.boundary_pairs[d][q] == r.boundary_pairs[q][d]);
+            }
+        }
+
+        CHECK(cells == mesh.all.cells_count());
+        CHECK(bytes == r.total_exchange_bytes);
+        CHECK(r.total_exchange_bytes > 0);
+        CHECK(r.total_exchange_bytes <= 2 * r.cut_edges * sizeof(double));
+        CHECK(mth::is_near(r.imbalance, 1.0, 0.01));
+
+        // Linear domains of sphere are chained.
+        CHECK(r.neighbours[0] >= 1);
+
+        ostringstream os;
+
+        r.print_csv(os);
+
+        string csv { os.str() };
+
+        CHECK(count(csv.begin(), csv.end(), '\n') == static_cast<long>(dn + 1));
+
+        mesh.clear();
+    }
+
+    SECTION("exchange bytes correspond to ghost layers")
+    {
+        const size_t dn { 4 };
+        Mesh mesh;
+        DecompositionReport r1, r2;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::Linear, dn, false);
+        Decomposer::report(mesh, r1);
+
+        // Cells sent through one layer of edges (each cell once for each neighbour).
+        size_t cc { mesh.all.cells_count() };
+        vector<vector<size_t>> sent(dn, vector<size_t>(dn, 0));
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+            vector<bool> is_sent(dn, false);
+
+            for (size_t j = 0; j < c->edges_count(); ++j)
+            {
+                Edge* e { c->edge(j) };
+
+                if (e->is_cross())
+                {
+                    Cell* ngh { (e->cell(0) == c) ? e->cell(1) : e->cell(0) };
+
+                    is_sent[ngh->get_domain()] = true;
+                }
+            }
+
+            for (size_t q = 0; q < dn; ++q)
+            {
+                if (is_sent[q])
+                {
+                    ++sent[c->get_domain()][q];
+                }
+            }
+        }
+
+        for (size_t d = 0; d < dn; ++d)
+        {
+            size_t bytes { 0 };
+
+            for (size_t q = 0; q < dn; ++q)
+            {
+                bytes += max(sent[d][q], sent[q][d]) * sizeof(double);
+            }
+
+            CHECK(r1.exchange_bytes[d] == bytes);
+        }
+
+        // Deeper ghost layers give more data in exchange.
+        mesh.set_ghost_layers(2, GhostAdjacency::Nodes);
+        Decomposer::report(mesh, r2);
+
+        for (size_t d = 0; d < dn; ++d)
+        {
+            CHECK(r2.exchange_bytes[d] > r1.exchange_bytes[d]);
+            CHECK(r2.neighbours[d] >= r1.neighbours[d]);
+        }
+
+        CHECK(r2.cut_edges == r1.cut_edges);
+        CHECK(r2.total_exchange_bytes > r1.total_exchange_bytes);
+
+        mesh.clear();
+    }
+
+    SECTION("domains are spread through ghost layers")
+    {
+        const size_t dn { 5 };
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::Multilevel, dn, false);
+
+        size_t cc { mesh.all.cells_count() };
+
+        for (size_t depth = 1; depth <= 3; ++depth)
+        {
+            for (GhostAdjacency adj : { GhostAdjacency::Edges, GhostAdjacency::Nodes })
+            {
+                vector<vector<size_t>> ds;
+                bool is_same { true };
+
+                Boundaries::spread_domains(mesh.all, depth, adj, ds);
+
+                // Each domain is spread with its own walk over layers.
+                for (size_t d = 0; d < dn; ++d)
+                {
+                    vector<bool> is_reached(cc, false);
+                    vector<Cell*> front;
+
+                    for (size_t i = 0; i < cc; ++i)
+                    {
+                        if (mesh.all.cell(i)->get_domain() == d)
+                        {
+                            is_reached[i] = true;
+                            front.push_back(mesh.all.cell(i));
+                        }
+                    }
+
+                    for (size_t li = 0; li < depth; ++li)
+                    {
+                        vector<Cell*> next;
+
+                        for (Cell* c : front)
+                        {
+                            vector<Cell*> ngh;
+
+                            if (adj == GhostAdjacency::Edges)
+                            {
+                                for (size_t j = 0; j < c->edges_count(); ++j)
+                                {
+                                    Edge* e { c->edge(j) };
+
+                                    if (e->is_inner())
+                                    {
+                                        ngh.push_back((e->cell(0) == c) ? e->cell(1) : e->cell(0));
+                                    }
+                                }
+                            }
+                            else
+                            {
+                                for (size_t j = 0; j < c->nodes_count(); ++j)
+                                {
+                                    for (size_t k = 0; k < c->node(j)->cells_count(); ++k)
+                                    {
+                                        ngh.push_back(c->node(j)->cell(k));
+                                    }
+                                }
+                            }
+
+                            for (Cell* n : ngh)
+                            {
+                                size_t ni { static_cast<size_t>(n->get_id()) };
+
+                                if (!is_reached[ni])
+                                {
+                                    is_reached[ni] = true;
+                                    next.push_back(n);
+                                }
+                            }
+                        }
+
+                        front.swap(next);
+                    }
+
+                    for (size_t i = 0; i < cc; ++i)
+                    {
+                        is_same = is_same
+                                  && (is_reached[i] == binary_search(ds[i].begin(), ds[i].end(), d));
+                    }
+                }
+
+                for (size_t i = 0; i < cc; ++i)
+                {
+                    is_same = is_same && is_sorted(ds[i].begin(), ds[i].end());
+                }
+
+                CHECK(is_same);
+            }
+        }
+
+        mesh.clear();
+    }
+}
+
+TEST_CASE("Decomposer : weights", "[mesh]")
+{
+    SECTION("domains have equal weights")
+    {
+        const size_t dn { 4 };
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        size_t cc { mesh.all.cells_count() };
+        vector<double> weights(cc);
+        double total { 0.0 };
+
+        // Cells of one half of sphere are 10 times heavier.
+        for (size_t i = 0; i < cc; ++i)
+        {
+            weights[i] = (mesh.all.cell(i)->center().x > 0.0) ? 10.0 : 1.0;
+            total += weights[i];
+        }
+
+        vector<DecompositionType> types { DecompositionType::Linear,
+                                          DecompositionType::Farhat,
+                                          DecompositionType::Multilevel,
+                                          DecompositionType::RCB,
+                                          DecompositionType::Hilbert };
+
+        for (DecompositionType type : types)
+        {
+            Decomposer::decompose(mesh, type, dn, weights, false);
+
+            vector<double> dw(dn, 0.0);
+
+            for (size_t i = 0; i < cc; ++i)
+            {
+                dw[mesh.all.cell(i)->get_domain()] += weights[i];
+            }
+
+            CHECK(*max_element(dw.begin(), dw.end()) / (total / dn) < 1.05);
+            CHECK(*min_element(dw.begin(), dw.end()) > 0.0);
+        }
+
+        mesh.clear();
+    }
+
+    SECTION("weights are estimated from work of cells")
+    {
+        Mesh mesh;
+        RemeshOptions opts;
+        vector<double> weights;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        size_t cc { mesh.all.cells_count() };
+        size_t iced { 0 };
+        double max_x { 0.0 };
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            max_x = max(max_x, mesh.all.cell(i)->center().x);
+        }
+
+        // Ice only on small cap of sphere.
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+
+            if (c->center().x > 0.8 * max_x)
+            {
+                c->ice_shift = 0.002;
+                iced = i;
+            }
+        }
+
+        opts.method = RemeshMethod::Tong;
+        opts.is_active_set = true;
+        Remesher::remesh(mesh, opts);
+        Decomposer::estimate_weights(mesh, weights, 2.0);
+
+        REQUIRE(weights.size() == cc);
+        CHECK(mth::is_eq(*min_element(weights.begin(), weights.end()), 1.0));
+        CHECK(mth::is_eq(weights[iced], 1.0 + 2.0 * mesh.all.cell(iced)->work));
+        CHECK(weights[iced] > 1.0);
+
+        mesh.clear();
+    }
+}
+
+TEST_CASE("Decomposer : rebalancing", "[mesh]")
+{
+    SECTION("diffusion rebalancing keeps most cells in their domains")
+    {
+        const size_t dn { 4 };
+        Mesh mesh;
+        PartitionGraph g;
+        vector<size_t> parts;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Partitioner::build_dual_graph(mesh.all, g);
+        Partitioner::multilevel(g, dn, parts);
+
+        // Cells of part 0 become 3 times heavier.
+        size_t cc { g.vertices_count() };
+        vector<double> weights(cc);
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            weights[i] = (parts[i] == 0) ? 3.0 : 1.0;
+        }
+
+        Partitioner::set_weights(g, weights);
+
+        vector<size_t> old_parts { parts };
+        vector<size_t> pw(dn, 0);
+        size_t moved { 0 };
+
+        Partitioner::rebalance(g, dn, 1.03, parts);
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            pw[parts[i]] += g.weights[i];
+
+            if (parts[i] != old_parts[i])
+            {
+                ++moved;
+            }
+        }
+
+        double avg { static_cast<double>(g.total_weight()) / static_cast<double>(dn) };
+
+        CHECK(static_cast<double>(*max_element(pw.begin(), pw.end())) / avg < 1.05);
+        CHECK(moved < cc / 2);
+
+        mesh.clear();
+    }
+
+    SECTION("single process is not rebalanced")
+    {
+        Mesh mesh;
+        RebalanceReport r;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::No, 1);
+
+        CHECK(!Decomposer::rebalance<CellDataStub>(mesh, 1.0, 1.1, r));
+        CHECK(!r.is_rebalanced);
+        CHECK(mth::is_eq(r.time_imbalance, 1.0));
+        CHECK(r.moved_cells == 0);
+        CHECK(r.sent_bytes == 0);
+
+        mesh.clear();
+    }
+}
+
+TEST_CASE("Decomposer : domains files", "[mesh]")
+{
+    SECTION("domain file holds own cells and ghost layers")
+    {
+        const size_t dn { 3 };
+        const string prefix { "unit_mesh_decomposer_sphere" };
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::Multilevel, dn, false);
+
+        REQUIRE(Decomposer::store_domains<NodeDataStub, CellDataStub>(mesh, prefix));
+
+        vector<size_t> own_counts(dn, 0);
+
+        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        {
+            ++own_counts[mesh.all.cell(i)->get_domain()];
+        }
+
+        for (size_t d = 0; d < dn; ++d)
+        {
+            Mesh part;
+            string fn { Decomposer::domain_file_name(prefix, d) };
+            size_t own { 0 }, ghost { 0 };
+            bool is_same { true };
+
+            REQUIRE(Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(part, fn));
+
+            for (size_t i = 0; i < part.all.cells_count(); ++i)
+            {
+                Cell* c { part.all.cell(i) };
+                Cell* oc { mesh.all.cell(static_cast<size_t>(c->get_orig_id())) };
+
+                if (c->get_domain() == d)
+                {
+                    ++own;
+                }
+                else
+                {
+                    ++ghost;
+                }
+
+                is_same = is_same
+                          && (c->get_domain() == oc->get_domain())
+                          && mth::is_eq(c->center().dist_to(oc->center()), 0.0);
+            }
+
+            for (size_t i = 0; i < part.all.nodes_count(); ++i)
+            {
+                Node* n { part.all.node(i) };
+                Node* on { mesh.all.node(static_cast<size_t>(n->get_orig_id())) };
+
+                is_same = is_same && mth::is_eq(n->point().dist_to(on->point()), 0.0);
+            }
+
+            CHECK(own == own_counts[d]);
+            CHECK(ghost > 0);
+            CHECK(part.all.cells_count() < mesh.all.cells_count());
+            CHECK(is_same);
+
+            part.clear();
+            remove(fn.c_str());
+        }
+
+        mesh.clear();
+    }
+
+    SECTION("mesh part can not be decomposed, rebalanced or reported")
+    {
+        const string prefix { "unit_mesh_decomposer_part" };
+        Mesh mesh, part;
+        DecompositionReport dr;
+        RebalanceReport rr;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::No, 1);
+
+        REQUIRE(Decomposer::store_domains<NodeDataStub, CellDataStub>(mesh, prefix));
+        REQUIRE(Decomposer::load_domain<NodeDataStub, NodeDataStub, CellDataStub>(part, prefix));
+        REQUIRE(part.is_domain_part());
+
+        CHECK_THROWS(Decomposer::decompose(part, DecompositionType::Multilevel, 2, false));
+        CHECK_THROWS(Decomposer::report(part, dr));
+        CHECK_THROWS(Decomposer::rebalance<CellDataStub>(part, 1.0, 0.1, rr));
+        CHECK_THROWS(Decomposer::store_domains<NodeDataStub, CellDataStub>(part, prefix));
+
+        part.clear();
+        mesh.clear();
+        remove(Decomposer::domain_file_name(prefix, 0).c_str());
+    }
+}
+
+/// \brief Count of edges between static chunks of own cells.
+///
+/// Own cells are split into equal contiguous chunks (as in static schedule).
+///
+/// \param[in] mesh Mesh.
+/// \param[in] bn   Count of chunks.
+///
+/// \return
+/// Count of edges between cells of different chunks.
+static size_t
+chunks_cut(Mesh& mesh,
+           size_t bn)
+{
+    size_t cc { mesh.own.cells_count() }, cnt { 0 };
+    vector<size_t> chunk(mesh.all.cells_count(), bn);
+
+    for (size_t i = 0; i < cc; ++i)
+    {
+        chunk[static_cast<size_t>(mesh.own.cell(i)->get_id())] = i * bn / cc;
+    }
+
+    for (size_t i = 0; i < mesh.all.edges_count(); ++i)
+    {
+        Edge* e { mesh.all.edge(i) };
+
+        if (e->is_inner()
+            && (chunk[static_cast<size_t>(e->cell(0)->get_id())]
+                != chunk[static_cast<size_t>(e->cell(1)->get_id())]))
+        {
+            ++cnt;
+        }
+    }
+
+    return cnt;
+}
+
+TEST_CASE("Decomposer : blocks", "[mesh]")
+{
+    SECTION("blocks are contiguous and compact")
+    {
+        const size_t bn { 8 };
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::No, 1);
+
+        size_t nc { mesh.all.nodes_count() }, ec { mesh.all.edges_count() }, cc { mesh.all.cells_count() };
+        size_t cut { chunks_cut(mesh, bn) };
+
+        Decomposer::build_blocks(mesh, bn);
+
+        bool is_ids { true };
+
+        for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+        {
+            is_ids = is_ids && (static_cast<size_t>(mesh.all.node(i)->get_id()) == i);
+        }
+
+        for (size_t i = 0; i < mesh.all.edges_count(); ++i)
+        {
+            is_ids = is_ids && (static_cast<size_t>(mesh.all.edge(i)->get_id()) == i);
+        }
+
+        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        {
+            is_ids = is_ids && (static_cast<size_t>(mesh.all.cell(i)->get_id()) == i);
+        }
+
+        CHECK(mesh.blocks_count() == bn);
+        CHECK(mesh.all.nodes_count() == nc);
+        CHECK(mesh.all.edges_count() == ec);
+        CHECK(mesh.all.cells_count() == cc);
+        CHECK(mesh.own.cells_count() == cc);
+        CHECK(is_ids);
+        CHECK(chunks_cut(mesh, bn) < cut / 2);
+
+        mesh.clear();
+    }
+
+    SECTION("threads process own blocks")
+    {
+        const size_t bn { 4 };
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Decomposer::decompose(mesh, DecompositionType::No, 1);
+        Decomposer::build_blocks(mesh, bn);
+
+        size_t nc { mesh.all.nodes_count() }, cc { mesh.all.cells_count() };
+        const vector<size_t>& offs { mesh.blocks_cells_offsets(0) };
+
+        REQUIRE(offs.size() == bn + 1);
+        CHECK(offs.front() == 0);
+        CHECK(offs.back() == cc);
+
+        // Each element is processed once, cells of block are processed by one thread.
+        vector<size_t> cells_visits(cc, 0), nodes_visits(nc, 0);
+        vector<int> threads(cc, -1);
+
+        mesh.for_each_cell_by_blocks(mesh.all, [&cells_visits, &threads](size_t i)
+        {
+            ++cells_visits[i];
+            threads[i] = omp_get_thread_num();
+        });
+        mesh.for_each_node_by_blocks(mesh.all, [&nodes_visits](size_t i)
+        {
+            ++nodes_visits[i];
+        });
+
+        bool is_once { true }, is_block_thread { true };
+
+        for (size_t v : cells_visits)
+        {
+            is_once = is_once && (v == 1);
+        }
+
+        for (size_t v : nodes_visits)
+        {
+            is_once = is_once && (v == 1);
+        }
+
+        for (size_t b = 0; b < bn; ++b)
+        {
+            for (size_t i = offs[b]; i < offs[b + 1]; ++i)
+            {
+                is_block_thread = is_block_thread && (threads[i] == threads[offs[b]]);
+            }
+        }
+
+        CHECK(is_once);
+        CHECK(is_block_thread);
+
+        mesh.clear();
+    }
+
+    SECTION("blocks are not built while ensemble exists")
+    {
+        Mesh mesh;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        {
+            Ensemble ens(mesh);
+
+            CHECK_THROWS(Decomposer::build_blocks(mesh, 4));
+        }
+
+        Decomposer::build_blocks(mesh, 4);
+        CHECK(mesh.blocks_count() == 4);
+
+        mesh.clear();
+    }
+
+    SECTION("remeshing does not depend on blocks")
+    {
+        RemeshOptions opts;
+        Mesh mesh, blocked;
+
+        opts.method = RemeshMethod::Tong;
+        opts.nsmooth_steps = 2;
+        opts.hsmooth_steps = 2;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(blocked, "cases/meshes/sphere.dat");
+
+        for (size_t i = 0; i < blocked.all.nodes_count(); ++i)
+        {
+            blocked.all.node(i)->set_orig_id(static_cast<int>(i));
+        }
+
+        Decomposer::build_blocks(blocked, 4);
+
+        for (Mesh* m : { &mesh, &blocked })
+        {
+            for (size_t i = 0; i < m->all.cells_count(); ++i)
+            {
+                Cell* c { m->all.cell(i) };
+
+                c->ice_shift = 0.002 * (1.0 + 0.5 * sin(20.0 * c->center().x));
+            }
+
+            Remesher::remesh(*m, opts);
+        }
+
+        double max_dist { 0.0 };
+
+        for (size_t i = 0; i < blocked.all.nodes_count(); ++i)
+        {
+            Node* n { blocked.all.node(i) };
+            Node* on { mesh.all.node(static_cast<size_t>(n->get_orig_id())) };
+
+            max_dist = max(max_dist, n->point().dist_to(on->point()));
+        }
+
+        CHECK(max_dist < 1.0e-12);
+
+        mesh.clear();
+        blocked.clear();
+    }
+}
@@ -0,0 +1,128 @@
+/// \file
+/// \brief Tests for ensemble remeshing.
+///
+/// Tests for ensemble remeshing.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+/// \brief Load sphere with nonuniform ice.
+///
+/// Load sphere with nonuniform ice.
+///
+/// \param[out] mesh Mesh.
+static void
+load_iced_sphere(Mesh& mesh)
+{
+    Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        c->ice_shift = 0.002 * (1.0 + 0.5 * sin(20.0 * c->center().x));
+    }
+}
+
+TEST_CASE("Ensemble : members are the same as separate runs", "[mesh]")
+{
+    SECTION("prisms and tong")
+    {
+        vector<RemeshOptions> opts(3);
+
+        opts[0].method = RemeshMethod::Prisms;
+        opts[1].method = RemeshMethod::Tong;
+        opts[2].method = RemeshMethod::Tong;
+        opts[2].nsmooth_steps = 2;
+        opts[2].hsmooth_steps = 2;
+
+        Mesh mesh;
+
+        load_iced_sphere(mesh);
+
+        Ensemble ens(mesh);
+        vector<double> hs(mesh.all.cells_count());
+
+        for (const RemeshOptions& o : opts)
+        {
+            ens.add_member(o);
+        }
+
+        for (size_t i = 0; i < hs.size(); ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+
+            hs[i] = c->ice_shift;
+            c->work = 1.0;
+            c->ice_chunk = 2.0;
+            c->set_mark(3);
+        }
+
+        ens.remesh();
+
+        // Ice and other remesher state of mesh are not changed by members.
+        bool is_ice { true }, is_state { true };
+
+        for (size_t i = 0; i < hs.size(); ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+
+            is_ice = is_ice && mth::is_eq(c->ice_shift, hs[i]);
+            is_state = is_state
+                       && mth::is_eq(c->work, 1.0)
+                       && mth::is_eq(c->ice_chunk, 2.0)
+                       && (c->get_mark() == 3);
+        }
+
+        CHECK(is_ice);
+        CHECK(is_state);
+
+        for (size_t m = 0; m < opts.size(); ++m)
+        {
+            Mesh single;
+            vector<geom::Vector> ps;
+            bool is_same { true };
+
+            load_iced_sphere(single);
+            Remesher::remesh(single, opts[m]);
+            single.get_nodes_points(ps);
+
+            const vector<geom::Vector>& eps { ens.get_points(m) };
+
+            REQUIRE(eps.size() == ps.size());
+
+            for (size_t i = 0; i < ps.size(); ++i)
+            {
+                is_same = is_same && mth::is_eq(eps[i].dist_to(ps[i]), 0.0);
+            }
+
+            CHECK(is_same);
+
+            // State of member is much smaller than mesh.
+            CHECK(ens.member_memory(m) < mesh.all.nodes_count() * sizeof(Node));
+
+            single.clear();
+        }
+
+        // Base geometry is in mesh after remeshing.
+        vector<geom::Vector> ps;
+        bool is_base { true };
+
+        mesh.get_nodes_points(ps);
+        ens.load_member(1);
+        ens.load_base();
+
+        for (size_t i = 0; i < ps.size(); ++i)
+        {
+            is_base = is_base && mth::is_eq(mesh.all.node(i)->point().dist_to(ps[i]), 0.0);
+        }
+
+        CHECK(is_base);
+
+        mesh.clear();
+    }
+}
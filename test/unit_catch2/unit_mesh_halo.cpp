@@ -0,0 +1,109 @@
+/// \file
+/// \brief Tests for halo of domain.
+///
+/// Tests for halo of domain.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+TEST_CASE("Halo : ghost cells and far nodes", "[mesh]")
+{
+    SECTION("linear decomposition")
+    {
+        const size_t dn { 3 };
+        Mesh mesh;
+        vector<Halo> halos(dn);
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        // Only one process, so halos of all domains are built here.
+        Decomposer::decompose(mesh, DecompositionType::Linear, dn);
+
+        for (size_t r = 0; r < dn; ++r)
+        {
+            halos[r].build(mesh.all, r, dn);
+            CHECK(halos[r].is_built());
+            CHECK(halos[r].get_send_cells(r).empty());
+            CHECK(halos[r].get_recv_cells(r).empty());
+            CHECK(halos[r].get_send_nodes(r).empty());
+            CHECK(halos[r].get_recv_nodes(r).empty());
+        }
+
+        // Send lists are consistent with receive lists.
+        for (size_t r = 0; r < dn; ++r)
+        {
+            for (size_t q = 0; q < dn; ++q)
+            {
+                CHECK(halos[r].get_send_cells(q) == halos[q].get_recv_cells(r));
+                CHECK(halos[r].get_send_nodes(q) == halos[q].get_recv_nodes(r));
+            }
+        }
+
+        for (size_t r = 0; r < dn; ++r)
+        {
+            NodesEdgesCellsHolder& part { halos[r].part };
+            size_t own_cells { 0 }, domain_cells { 0 }, far_nodes { 0 }, recv_nodes { 0 };
+
+            for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+            {
+                if (mesh.all.cell(i)->get_domain() == r)
+                {
+                    ++domain_cells;
+                }
+            }
+
+            for (size_t i = 0; i < part.cells_count(); ++i)
+            {
+                part.cell(i)->set_mark(1);
+
+                if (part.cell(i)->get_domain() == r)
+                {
+                    ++own_cells;
+                }
+            }
+
+            CHECK(own_cells == domain_cells);
+            CHECK(part.cells_count() > own_cells);
+
+            for (size_t i = 0; i < part.nodes_count(); ++i)
+            {
+                Node* n { part.node(i) };
+                bool is_own { false }, is_all_in_part { true };
+
+                for (size_t j = 0; j < n->cells_count(); ++j)
+                {
+                    is_own = is_own || (n->cell(j)->get_domain() == r);
+                    is_all_in_part = is_all_in_part && (n->cell(j)->get_mark() == 1);
+                }
+
+                // All incident cells of nodes of own cells are in part.
+                if (is_own)
+                {
+                    CHECK(is_all_in_part);
+                }
+                else
+                {
+                    ++far_nodes;
+                }
+            }
+
+            for (size_t q = 0; q < dn; ++q)
+            {
+                recv_nodes += halos[r].get_recv_nodes(q).size();
+            }
+
+            CHECK(far_nodes == recv_nodes);
+
+            for (size_t i = 0; i < part.cells_count(); ++i)
+            {
+                part.cell(i)->set_mark(0);
+            }
+        }
+
+        mesh.clear();
+    }
+}
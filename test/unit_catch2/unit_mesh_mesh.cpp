@@ -95,4 +95,99 @@ TEST_CASE("Mesh : main methods of mesh", "[mesh]")
         CHECK(cc1 == cc2);
         CHECK(zc1 == zc2);
     }
+
+    SECTION("self-intersections")
+    {
+        Mesh mesh;
+
+        // Load mesh.
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        // Sphere has no self-intersections.
+        CHECK(mesh.mark_self_intersecting_cells() == 0);
+
+        // Push node through the sphere.
+        geom::BVH bvh;
+        geom::Box box;
+        Node* n { mesh.all.node(0) };
+        geom::Vector v;
+
+        mesh.build_cells_bvh(bvh);
+
+        for (size_t i = 0; i < bvh.triangles_count(); ++i)
+        {
+            box.extend(bvh.triangle_box(i));
+        }
+
+        geom::Vector::mul(n->normal(), -1.5 * (box.hi.x - box.lo.x), v);
+        n->move(v);
+        mesh.calc_geometry();
+
+        size_t marked { mesh.mark_self_intersecting_cells() };
+
+        CHECK(marked > 0);
+        CHECK(n->cell(0)->get_mark() == 1);
+
+        // BVH built before moving is refitted.
+        CHECK(mesh.mark_self_intersecting_cells(bvh) == marked);
+
+        // Move node back, the same BVH is refitted again.
+        geom::Vector::mul(v, -1.0, v);
+        n->move(v);
+        mesh.calc_geometry();
+
+        CHECK(mesh.mark_self_intersecting_cells(bvh) == 0);
+
+        // Free data.
+        mesh.clear();
+    }
+
+    SECTION("colored edges sweep")
+    {
+        Mesh mesh;
+
+        // Load mesh.
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        CHECK(!mesh.is_own_edges_colored());
+
+        Decomposer::decompose(mesh, DecompositionType::No, 1);
+        EdgesColorizer::colorize_edges(mesh);
+
+        CHECK(mesh.is_own_edges_colored());
+        CHECK(mesh.own.edges_count() == mesh.all.edges_count());
+
+        // Colorize again, colors must not be duplicated.
+        EdgesColorizer::colorize_edges(mesh);
+
+        CHECK(mesh.is_own_edges_colored());
+
+        // Scatter to incident cells without atomics.
+        size_t cc { mesh.all.cells_count() };
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            mesh.all.cell(i)->loc_ice_chunk = 0.0;
+        }
+
+        mesh.for_each_edge_colored([](Edge* e)
+        {
+            for (size_t j = 0; j < e->cells_count(); ++j)
+            {
+                e->cell(j)->loc_ice_chunk += 1.0;
+            }
+        });
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+
+            CHECK(mth::is_eq(c->loc_ice_chunk, static_cast<double>(c->edges_count())));
+        }
+
+        // Free data.
+        mesh.clear();
+
+        CHECK(!mesh.is_own_edges_colored());
+    }
 }
@@ -0,0 +1,63 @@
+/// \file
+/// \brief Tests for patches of mesh.
+///
+/// Tests for patches of mesh.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+TEST_CASE("Patches : build", "[mesh]")
+{
+    SECTION("each cell is core and each node is owned only once")
+    {
+        Mesh mesh;
+        Patches ps;
+
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+        ps.build(mesh.all, 50, 2);
+
+        CHECK(ps.is_built(mesh.all, 50, 2));
+        CHECK(!ps.is_built(mesh.all, 50, 3));
+        CHECK(ps.patches_count() > 1);
+
+        vector<size_t> cores(mesh.all.cells_count(), 0), owners(mesh.all.nodes_count(), 0);
+        bool is_links_correct { true };
+
+        for (size_t pi = 0; pi < ps.patches_count(); ++pi)
+        {
+            const Patch& p { ps.patch(pi) };
+
+            CHECK(p.core_count <= 50);
+            CHECK(p.core_count < p.cells.size());
+
+            for (size_t i = 0; i < p.core_count; ++i)
+            {
+                ++cores[static_cast<size_t>(p.cells[i]->get_id())];
+            }
+
+            for (size_t i : p.own_nodes)
+            {
+                ++owners[static_cast<size_t>(p.nodes[i]->get_id())];
+            }
+
+            for (size_t i = 0; i < p.cells.size(); ++i)
+            {
+                for (size_t j = 0; j < 3; ++j)
+                {
+                    is_links_correct = is_links_correct
+                                       && (p.nodes[p.cells_nodes[3 * i + j]] == p.cells[i]->node(j));
+                }
+            }
+        }
+
+        CHECK(count(cores.begin(), cores.end(), 1) == static_cast<long>(cores.size()));
+        CHECK(count(owners.begin(), owners.end(), 1) == static_cast<long>(owners.size()));
+        CHECK(is_links_correct);
+
+        mesh.clear();
+    }
+}
@@ -0,0 +1,132 @@
+/// \file
+/// \brief Tests for mesh quality.
+///
+/// Tests for mesh quality.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+TEST_CASE("Quality : mesh quality metrics", "[mesh]")
+{
+    SECTION("sphere quality")
+    {
+        Mesh mesh;
+        Quality q(32);
+
+        // Load mesh.
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        size_t cc { mesh.all.cells_count() };
+
+        q.calc(mesh.all, true);
+
+        CHECK(q.cells_count() == cc);
+        CHECK(q.get_values(QualityMetric::MinSide).size() == cc);
+
+        // Compare with serial calculation.
+        double min_side { numeric_limits<double>::max() };
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* c { mesh.all.cell(i) };
+            double s { geom::Vector::triangle_min_side_length(c->node(0)->point(),
+                                                              c->node(1)->point(),
+                                                              c->node(2)->point()) };
+
+            CHECK(mth::is_eq(q.get_values(QualityMetric::MinSide)[i], s));
+            min_side = min(min_side, s);
+        }
+
+        CHECK(mth::is_eq(q.min(QualityMetric::MinSide), min_side));
+
+        // Geometry is not changed.
+        CHECK(mth::is_eq(q.min(QualityMetric::AreaRatio), 1.0));
+        CHECK(mth::is_eq(q.max(QualityMetric::AreaRatio), 1.0));
+
+        // Metrics bounds.
+        CHECK(q.min(QualityMetric::AspectRatio) >= 1.0 - mth::Eps);
+        CHECK(q.max(QualityMetric::MinAngle) <= M_PI / 3.0 + mth::Eps);
+
+        // Histograms and quantiles.
+        for (int i = static_cast<int>(QualityMetric::First); i <= static_cast<int>(QualityMetric::Last); ++i)
+        {
+            QualityMetric m { static_cast<QualityMetric>(i) };
+
+            CHECK(mth::is_eq(mth::sum(q.get_histogram(m)), static_cast<double>(cc)));
+            CHECK(q.quantile(m, 0.5) >= q.min(m) - mth::Eps);
+            CHECK(q.quantile(m, 0.5) <= q.max(m) + mth::Eps);
+        }
+
+        // Free data.
+        mesh.clear();
+    }
+
+    SECTION("degenerate cell")
+    {
+        Mesh mesh;
+        Quality q(32);
+
+        // Load mesh.
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+        size_t cc { mesh.all.cells_count() };
+        Cell* c { mesh.all.cell(0) };
+
+        // Cell with zero area.
+        c->node(2)->set_point(c->node(0)->point());
+
+        q.calc(mesh.all, true);
+
+        size_t degenerate { 0 };
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            Cell* ci { mesh.all.cell(i) };
+
+            if (!(geom::Vector::triangle_area(ci->node(0)->point(),
+                                              ci->node(1)->point(),
+                                              ci->node(2)->point()) > 0.0))
+            {
+                ++degenerate;
+            }
+        }
+
+        CHECK(degenerate >= 1);
+        CHECK(q.degenerate_cells_count() == degenerate);
+        CHECK(q.cells_count() == cc);
+
+        // Degenerate cells are not taken into account in aspect ratio statistics.
+        QualityMetric m { QualityMetric::AspectRatio };
+        const vector<double>& h { q.get_histogram(m) };
+        double max_ar { 0.0 };
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            double v { q.get_values(m)[i] };
+
+            if (v < numeric_limits<double>::max())
+            {
+                max_ar = max(max_ar, v);
+            }
+        }
+
+        CHECK(mth::is_eq(q.max(m), max_ar));
+        CHECK(isfinite(q.mean(m)));
+        CHECK(q.mean(m) < q.max(m));
+        CHECK(mth::is_eq(mth::sum(h), static_cast<double>(cc - degenerate)));
+        CHECK(h[0] < static_cast<double>(cc - degenerate));
+        CHECK(q.quantile(m, 0.5) >= q.min(m) - mth::Eps);
+        CHECK(q.quantile(m, 0.5) < 0.5 * q.max(m));
+
+        // Other metrics are defined for all cells.
+        CHECK(mth::is_eq(mth::sum(q.get_histogram(QualityMetric::MinSide)), static_cast<double>(cc)));
+        CHECK(mth::is_eq(q.min(QualityMetric::MinSide), 0.0));
+
+        // Free data.
+        mesh.clear();
+    }
+}
@@ -0,0 +1,301 @@
+/// \file
+/// \brief Tests for remesher.
+///
+/// Tests for remesher.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+/// \brief Volume inside closed mesh.
+///
+/// Volume inside closed mesh.
+///
+/// \param[in] mesh Mesh.
+///
+/// \return
+/// Volume.
+static double
+mesh_volume(Mesh& mesh)
+{
+    double v { 0.0 };
+
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        v += geom::Vector::triple_product(c->node(0)->point(),
+                                          c->node(1)->point(),
+                                          c->node(2)->point()) / 6.0;
+    }
+
+    return abs(v);
+}
+
+/// \brief Remesh sphere with nonuniform ice.
+///
+/// Remesh sphere with nonuniform ice.
+///
+/// \param[in]  opts   Options.
+/// \param[out] target Target ice volume.
+///
+/// \return
+/// Grown ice volume.
+static double
+remesh_sphere(const RemeshOptions& opts,
+              double& target)
+{
+    Mesh mesh;
+
+    Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+    target = 0.0;
+
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        // Thick ice only on small part of surface.
+        c->ice_shift = (c->center().x > 0.8 * c->center().mod()) ? 0.02 : 0.001;
+        target += c->ice_shift * c->area();
+    }
+
+    double v0 { mesh_volume(mesh) };
+
+    Remesher::remesh(mesh, opts);
+
+    double v { mesh_volume(mesh) - v0 };
+    bool is_marks_zero { true };
+
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        is_marks_zero = is_marks_zero && (mesh.all.cell(i)->get_mark() == 0);
+    }
+
+    CHECK(is_marks_zero);
+
+    mesh.clear();
+
+    return v;
+}
+
+/// \brief Remesh sphere with ice on small part of surface.
+///
+/// Remesh sphere with ice on small part of surface.
+///
+/// \param[in]  opts Options.
+/// \param[out] ps   Points of nodes after remeshing.
+static void
+remesh_sphere_patch(const RemeshOptions& opts,
+                    vector<geom::Vector>& ps,
+                    bool is_smooth_ice = false)
+{
+    Mesh mesh;
+
+    Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        if (is_smooth_ice)
+        {
+            c->ice_shift = 0.02 + 0.002 * c->center().x / c->center().mod();
+        }
+        else
+        {
+            c->ice_shift = (c->center().x > 0.8 * c->center().mod()) ? 0.02 : 0.0;
+        }
+    }
+
+    Remesher::remesh(mesh, opts);
+    mesh.get_nodes_points(ps);
+    mesh.clear();
+}
+
+TEST_CASE("Remesher : Tong method", "[mesh]")
+{
+    SECTION("local sub-stepping")
+    {
+        RemeshOptions opts;
+        double target { 0.0 };
+
+        opts.method = RemeshMethod::Tong;
+        opts.hsmooth_steps = 2;
+
+        double v { remesh_sphere(opts, target) };
+
+        opts.is_local_steps = true;
+
+        double lv { remesh_sphere(opts, target) };
+
+        // Ice grows on convex surface, so volume is a bit bigger than target.
+        CHECK(mth::is_near(v, target, 0.05 * target));
+        CHECK(mth::is_near(lv, target, 0.05 * target));
+        CHECK(mth::is_near(lv, v, 0.01 * v));
+    }
+}
+
+TEST_CASE("Remesher : self-intersections", "[mesh]")
+{
+    SECTION("retries with more steps for folded cells")
+    {
+        size_t bad[2] { 0, 0 };
+
+        for (int check = 0; check < 2; ++check)
+        {
+            Mesh mesh;
+            RemeshOptions opts;
+
+            Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+            // Dent in sphere, thick ice in it folds cells with one step.
+            geom::Vector p0 { mesh.all.node(0)->point() };
+            double r { p0.mod() };
+
+            for (size_t i = 0; i < mesh.all.nodes_count(); ++i)
+            {
+                Node* n { mesh.all.node(i) };
+                double d { n->point().dist_to(p0) / r };
+
+                if (d < 0.5)
+                {
+                    geom::Vector v;
+
+                    geom::Vector::mul(n->point(), -0.3 * (1.0 - 2.0 * d), v);
+                    n->move(v);
+                }
+            }
+
+            mesh.calc_geometry();
+
+            for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+            {
+                Cell* c { mesh.all.cell(i) };
+
+                c->ice_shift = (c->center().dist_to(p0) < 0.5 * r) ? (0.1 * r) : 0.0;
+            }
+
+            opts.method = RemeshMethod::Tong;
+            opts.nsteps_max = 1;
+            opts.is_check_self_intersections = (check == 1);
+            opts.self_intersections_retries = 4;
+            Remesher::remesh(mesh, opts);
+            bad[check] = mesh.mark_self_intersecting_cells();
+            mesh.clear();
+        }
+
+        CHECK(bad[0] > 0);
+        CHECK(bad[1] == 0);
+    }
+}
+
+TEST_CASE("Remesher : implicit heights smoothing", "[mesh]")
+{
+    SECTION("volume is conserved")
+    {
+        RemeshOptions opts;
+        double target { 0.0 };
+
+        opts.method = RemeshMethod::Tong;
+        opts.hsmooth_steps = 8;
+
+        double v { remesh_sphere(opts, target) };
+
+        opts.is_hsmooth_implicit = true;
+
+        double iv { remesh_sphere(opts, target) };
+
+        CHECK(mth::is_near(v, target, 0.05 * target));
+        CHECK(mth::is_near(iv, target, 0.05 * target));
+        CHECK(mth::is_near(iv, v, 0.01 * v));
+    }
+}
+
+TEST_CASE("Remesher : active set", "[mesh]")
+{
+    SECTION("same result as for all mesh")
+    {
+        for (RemeshMethod m : { RemeshMethod::Prisms, RemeshMethod::Tong })
+        {
+            RemeshOptions opts;
+            vector<geom::Vector> ps, aps;
+            bool is_same { true };
+
+            opts.method = m;
+            remesh_sphere_patch(opts, ps);
+            opts.is_active_set = true;
+            remesh_sphere_patch(opts, aps);
+
+            REQUIRE(ps.size() == aps.size());
+
+            for (size_t i = 0; i < ps.size(); ++i)
+            {
+                is_same = is_same && mth::is_eq(ps[i].dist_to(aps[i]), 0.0);
+            }
+
+            CHECK(is_same);
+        }
+    }
+}
+
+TEST_CASE("Remesher : patches smoothing", "[mesh]")
+{
+    SECTION("same result as for smoothing over all mesh")
+    {
+        RemeshOptions opts;
+        vector<geom::Vector> ps, pps1, pps3;
+        bool is_same { true }, is_near { true };
+
+        opts.method = RemeshMethod::Tong;
+        opts.nsmooth_steps = 4;
+        opts.hsmooth_steps = 4;
+        remesh_sphere_patch(opts, ps);
+        opts.patch_smoothing_cells = 64;
+        opts.patch_smoothing_iters = 1;
+        remesh_sphere_patch(opts, pps1);
+        opts.patch_smoothing_iters = 3;
+        remesh_sphere_patch(opts, pps3);
+
+        REQUIRE(ps.size() == pps1.size());
+        REQUIRE(ps.size() == pps3.size());
+
+        // Limiter is active on ice step, so blocks of iterations are done over all mesh.
+        for (size_t i = 0; i < ps.size(); ++i)
+        {
+            is_same = is_same && mth::is_eq(ps[i].dist_to(pps1[i]), 0.0);
+            is_near = is_near && mth::is_near(ps[i].dist_to(pps3[i]), 0.0, 1.0e-12);
+        }
+
+        CHECK(is_same);
+        CHECK(is_near);
+    }
+
+    SECTION("same result as full sweeps for several iterations in block")
+    {
+        RemeshOptions opts;
+        vector<geom::Vector> ps, pps;
+        bool is_near { true };
+
+        opts.method = RemeshMethod::Tong;
+        opts.nsmooth_steps = 4;
+        opts.hsmooth_steps = 6;
+        remesh_sphere_patch(opts, ps, true);
+        opts.patch_smoothing_cells = 64;
+        opts.patch_smoothing_iters = 3;
+        remesh_sphere_patch(opts, pps, true);
+
+        REQUIRE(ps.size() == pps.size());
+
+        // Limiter is not active on smooth ice, so patches are used.
+        for (size_t i = 0; i < ps.size(); ++i)
+        {
+            is_near = is_near && mth::is_near(ps[i].dist_to(pps[i]), 0.0, 1.0e-12);
+        }
+
+        CHECK(is_near);
+    }
+}
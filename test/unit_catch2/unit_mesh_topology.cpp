@@ -0,0 +1,203 @@
+/// \file
+/// \brief Tests for mesh topology changes.
+///
+/// Tests for mesh topology changes.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+/// \brief Total target ice of mesh.
+///
+/// Total target ice of mesh.
+///
+/// \param[in] mesh Mesh.
+///
+/// \return
+/// Total target ice.
+static double
+total_target_ice(Mesh& mesh)
+{
+    double v { 0.0 };
+
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        v += mesh.all.cell(i)->target_ice;
+    }
+
+    return v;
+}
+
+/// \brief Load sphere and init target ice.
+///
+/// Target ice of each cell is equal to its area.
+///
+/// \param[out] mesh Mesh.
+static void
+load_sphere(Mesh& mesh)
+{
+    Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(mesh, "cases/meshes/sphere.dat");
+
+    for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+    {
+        Cell* c { mesh.all.cell(i) };
+
+        c->target_ice = c->area();
+    }
+}
+
+TEST_CASE("Topology : local operations", "[mesh]")
+{
+    SECTION("split edge")
+    {
+        Mesh mesh;
+
+        load_sphere(mesh);
+
+        size_t nc { mesh.all.nodes_count() }, ec { mesh.all.edges_count() }, cc { mesh.all.cells_count() };
+        double ice { total_target_ice(mesh) };
+        Edge* e { mesh.all.edge(0) };
+        double l { e->length() };
+        Node* m { Topology::split_edge(mesh, e) };
+
+        CHECK(Topology::is_correct(mesh));
+        CHECK(mesh.all.nodes_count() == nc + 1);
+        CHECK(mesh.all.edges_count() == ec + 3);
+        CHECK(mesh.all.cells_count() == cc + 2);
+        CHECK(m->cells_count() == 4);
+        CHECK(mth::is_eq(e->length(), l / 2.0));
+        CHECK(mth::is_eq(total_target_ice(mesh), ice));
+
+        mesh.clear();
+    }
+
+    SECTION("flip edge")
+    {
+        Mesh mesh;
+
+        load_sphere(mesh);
+
+        size_t nc { mesh.all.nodes_count() }, ec { mesh.all.edges_count() }, cc { mesh.all.cells_count() };
+        double ice { total_target_ice(mesh) };
+        Edge* e { mesh.all.edge(0) };
+        Node* a { e->node(0) };
+        Node* b { e->node(1) };
+
+        REQUIRE(Topology::flip_edge(mesh, e));
+        CHECK(Topology::is_correct(mesh));
+        CHECK(mesh.all.nodes_count() == nc);
+        CHECK(mesh.all.edges_count() == ec);
+        CHECK(mesh.all.cells_count() == cc);
+        CHECK(e->node(0) != a);
+        CHECK(e->node(1) != b);
+        CHECK(mth::is_eq(total_target_ice(mesh), ice));
+
+        // Second flip restores edge.
+        REQUIRE(Topology::flip_edge(mesh, e));
+        CHECK(Topology::is_correct(mesh));
+        CHECK((((e->node(0) == a) && (e->node(1) == b)) || ((e->node(0) == b) && (e->node(1) == a))));
+
+        mesh.clear();
+    }
+
+    SECTION("collapse edge")
+    {
+        Mesh mesh;
+
+        load_sphere(mesh);
+
+        size_t nc { mesh.all.nodes_count() }, ec { mesh.all.edges_count() }, cc { mesh.all.cells_count() };
+        double ice { total_target_ice(mesh) };
+        bool is_collapsed { false };
+
+        for (size_t i = 0; (i < ec) && !is_collapsed; ++i)
+        {
+            is_collapsed = Topology::collapse_edge(mesh, mesh.all.edge(i), 1.0);
+        }
+
+        REQUIRE(is_collapsed);
+        Topology::remove_detached(mesh);
+        CHECK(Topology::is_correct(mesh));
+        CHECK(mesh.all.nodes_count() == nc - 1);
+        CHECK(mesh.all.edges_count() == ec - 3);
+        CHECK(mesh.all.cells_count() == cc - 2);
+        CHECK(mth::is_eq(total_target_ice(mesh), ice));
+
+        mesh.clear();
+    }
+}
+
+TEST_CASE("Topology : quality improvement", "[mesh]")
+{
+    SECTION("stretched edges are split")
+    {
+        Mesh mesh;
+
+        load_sphere(mesh);
+
+        size_t nc { mesh.all.nodes_count() };
+        double ice { total_target_ice(mesh) };
+
+        // Stretch sphere, so all edges become 3 times longer.
+        for (size_t i = 0; i < nc; ++i)
+        {
+            Node* n { mesh.all.node(i) };
+            geom::Vector d;
+
+            geom::Vector::mul(n->point(), 2.0, d);
+            n->move(d);
+        }
+
+        mesh.calc_geometry();
+
+        size_t ops { Topology::improve_quality(mesh, 0.35, 2.0, 0.35) };
+
+        CHECK(ops > 0);
+        CHECK(Topology::is_correct(mesh));
+        CHECK(mesh.all.nodes_count() > nc);
+        CHECK(mth::is_eq(total_target_ice(mesh), ice));
+
+        mesh.clear();
+    }
+
+    SECTION("bad cells are fixed")
+    {
+        Mesh mesh;
+
+        load_sphere(mesh);
+
+        // Split one edge several times to make needles.
+        Edge* e { mesh.all.edge(0) };
+
+        for (int i = 0; i < 4; ++i)
+        {
+            Topology::split_edge(mesh, e);
+        }
+
+        double ice { total_target_ice(mesh) };
+        double min_angle { mth::Pi };
+
+        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        {
+            min_angle = min(min_angle, Topology::cell_min_angle(mesh.all.cell(i)));
+        }
+
+        size_t ops { Topology::improve_quality(mesh, 2.0 * min_angle, 10.0, 0.5) };
+        double new_min_angle { mth::Pi };
+
+        for (size_t i = 0; i < mesh.all.cells_count(); ++i)
+        {
+            new_min_angle = min(new_min_angle, Topology::cell_min_angle(mesh.all.cell(i)));
+        }
+
+        CHECK(ops > 0);
+        CHECK(Topology::is_correct(mesh));
+        CHECK(new_min_angle >= min_angle);
+        CHECK(mth::is_eq(total_target_ice(mesh), ice));
+
+        mesh.clear();
+    }
+}
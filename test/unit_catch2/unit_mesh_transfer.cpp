@@ -0,0 +1,128 @@
+/// \file
+/// \brief Tests for transfer of data between meshes.
+///
+/// Tests for transfer of data between meshes.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace std;
+using namespace caesar;
+using namespace caesar::mesh;
+
+TEST_CASE("Transfer : transfer of data between meshes", "[mesh]")
+{
+    SECTION("transfer on the same mesh")
+    {
+        Mesh src, dst;
+        Transfer tr;
+
+        // Load meshes.
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(src, "cases/meshes/sphere.dat");
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(dst, "cases/meshes/sphere.dat");
+
+        size_t nc { src.all.nodes_count() }, cc { src.all.cells_count() };
+        vector<double> src_data, dst_data;
+
+        //
+        // Linear function in nodes is interpolated exactly.
+        //
+
+        tr.init(src, dst, TransferType::Nodes);
+
+        CHECK(tr.dst_count() == dst.all.cells_count());
+
+        for (size_t i = 0; i < nc; ++i)
+        {
+            const geom::Vector& p { src.all.node(i)->point() };
+
+            src_data.push_back(p.x + 2.0 * p.y + 3.0 * p.z);
+        }
+
+        tr.apply(src_data, dst_data);
+
+        for (size_t i = 0; i < dst.all.cells_count(); ++i)
+        {
+            const geom::Vector& p { dst.all.cell(i)->center() };
+
+            CHECK(mth::is_eq(dst_data[i], p.x + 2.0 * p.y + 3.0 * p.z));
+        }
+
+        //
+        // Constant cells data is kept.
+        //
+
+        tr.init(src, dst, TransferType::Cells);
+        src_data.assign(cc, 2.0);
+        tr.apply(src_data, dst_data);
+
+        for (size_t i = 0; i < dst.all.cells_count(); ++i)
+        {
+            CHECK(mth::is_eq(dst_data[i], 2.0));
+        }
+
+        //
+        // Conservative transfer on the same mesh is identity.
+        //
+
+        tr.init(src, dst, TransferType::Conservative);
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            src_data[i] = static_cast<double>(i % 7) + 0.5;
+        }
+
+        tr.apply(src_data, dst_data);
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            CHECK(mth::is_eq(dst_data[i], src_data[i]));
+        }
+
+        // Free data.
+        src.clear();
+        dst.clear();
+    }
+
+    SECTION("conservative transfer on moved mesh")
+    {
+        Mesh src, dst;
+        Transfer tr;
+
+        // Load meshes.
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(src, "cases/meshes/sphere.dat");
+        Filer::load_mesh<NodeDataStub, NodeDataStub, CellDataStub>(dst, "cases/meshes/sphere.dat");
+
+        // Slightly rotate target mesh nodes around Z axis.
+        for (size_t i = 0; i < dst.all.nodes_count(); ++i)
+        {
+            Node* n { dst.all.node(i) };
+            const geom::Vector& p { n->point() };
+            double a { 0.05 };
+            geom::Vector v(p.x * cos(a) - p.y * sin(a) - p.x,
+                           p.x * sin(a) + p.y * cos(a) - p.y,
+                           0.0);
+
+            n->move(v);
+        }
+
+        dst.calc_geometry();
+        tr.init(src, dst, TransferType::Conservative);
+
+        size_t cc { src.all.cells_count() };
+        vector<double> src_data(cc), dst_data;
+
+        for (size_t i = 0; i < cc; ++i)
+        {
+            src_data[i] = static_cast<double>(i % 5) + 1.0;
+        }
+
+        tr.apply(src_data, dst_data);
+
+        CHECK(mth::is_near(mth::sum(dst_data), mth::sum(src_data), 1.0e-8));
+
+        // Free data.
+        src.clear();
+        dst.clear();
+    }
+}
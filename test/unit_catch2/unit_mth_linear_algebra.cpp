@@ -57,4 +57,24 @@ TEST_CASE("Eigenvalues and eigenvectors", "[mth]")
         CHECK(mth::is_near(eig[1], 1.739, 0.01));
         CHECK(mth::is_near(eig[2], -0.21, 0.01));
     }
+
+    SECTION("eigenvalues and eigenvectors for degenerate symmetric 3x3 matrix")
+    {
+        // Plane normal quadric with one big eigenvalue.
+        vector<vector<double>> m
+        {
+            vector<double> { 0.0, 0.0, 0.0 },
+            vector<double> { 0.0, 0.0, 0.0 },
+            vector<double> { 0.0, 0.0, 2.0 }
+        };
+        vector<double> vals(3, 0.0);
+        vector<vector<double>> vecs(3, vector<double>(3, 0.0));
+
+        mth::calc_eigenvalues_and_eigenvectors(m, vals, vecs);
+
+        CHECK(mth::is_near(vals[0], 2.0));
+        CHECK(mth::is_near(vals[1], 0.0));
+        CHECK(mth::is_near(vals[2], 0.0));
+        CHECK(mth::is_near(abs(vecs[0][2]), 1.0));
+    }
 }
@@ -0,0 +1,118 @@
+/// \file
+/// \brief Tests for fixed size vectors and matrices.
+///
+/// Tests for fixed size vectors and matrices.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace caesar;
+
+TEST_CASE("Fixed size vectors and matrices", "[mth]")
+{
+    SECTION("arithmetic")
+    {
+        mth::Mat<2, 3> a { { 1.0, 2.0, 3.0 }, { 4.0, 5.0, 6.0 } };
+        mth::Mat<3, 2> t;
+        mth::Mat<2, 2> d;
+        mth::Vec<3> x { 1.0, 0.0, -1.0 };
+        mth::Vec<2> y;
+
+        CHECK(mth::Mat<2, 3>::rows() == 2);
+        CHECK(mth::Mat<2, 3>::cols() == 3);
+        CHECK(mth::Vec<3>::size() == 3);
+
+        a.transpose(t);
+
+        CHECK(mth::is_eq(t(2, 1), 6.0));
+
+        mth::Mat<2, 2>::mul(a, t, d);
+
+        CHECK(mth::is_eq(d(0, 0), 14.0));
+        CHECK(mth::is_eq(d(0, 1), 32.0));
+        CHECK(mth::is_eq(d(1, 1), 77.0));
+
+        mth::Mat<2, 3>::mul(a, x, y);
+
+        CHECK(mth::is_eq(y[0], -2.0));
+        CHECK(mth::is_eq(y[1], -2.0));
+        CHECK(mth::is_eq(x.dot(x), 2.0));
+    }
+
+    SECTION("determinant and inverse")
+    {
+        mth::Mat<3, 3> a { { 2.0, 1.0, 0.0 }, { 1.0, 3.0, 1.0 }, { 0.0, 1.0, 4.0 } };
+        mth::Mat<3, 3> inv, e;
+        mth::Mat<3, 3> s { { 1.0, 2.0, 3.0 }, { 2.0, 4.0, 6.0 }, { 0.0, 1.0, 1.0 } };
+
+        CHECK(mth::is_eq(a.det(), 18.0));
+        CHECK(mth::is_eq(s.det(), 0.0));
+        CHECK(mth::is_eq(mth::Mat<3, 3>::identity().det(), 1.0));
+        CHECK(a.inverse(inv));
+        CHECK(!s.inverse(inv));
+
+        a.inverse(inv);
+        mth::Mat<3, 3>::mul(a, inv, e);
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                CHECK(mth::is_eq(e(i, j), (i == j) ? 1.0 : 0.0));
+            }
+        }
+
+        // Vector wrapper.
+        vector<vector<double>> m
+        {
+            vector<double> { 2.0, 1.0, 0.0 },
+            vector<double> { 1.0, 3.0, 1.0 },
+            vector<double> { 0.0, 1.0, 4.0 }
+        };
+
+        CHECK(mth::is_eq(mth::det_3x3(m), 18.0));
+    }
+
+    SECTION("symmetric eigen solver")
+    {
+        mth::Mat<3, 3> a { { 0.0, 1.0, 0.0 }, { 1.0, 5.0, 1.0 }, { 0.0, 1.0, 2.0 } };
+        mth::Mat<4, 4> b { { 4.0, 1.0, 0.0, 0.0 },
+                           { 1.0, 3.0, 1.0, 0.0 },
+                           { 0.0, 1.0, 2.0, 1.0 },
+                           { 0.0, 0.0, 1.0, 1.0 } };
+        mth::Vec<3> vals;
+        mth::Mat<3, 3> vecs;
+        mth::Vec<4> bvals;
+        mth::Mat<4, 4> bvecs;
+
+        a.calc_symmetric_eigen(vals, vecs);
+
+        CHECK(mth::is_near(vals[0], 5.471, 0.01));
+        CHECK(mth::is_near(vals[1], 1.739, 0.01));
+        CHECK(mth::is_near(vals[2], -0.21, 0.01));
+
+        b.calc_symmetric_eigen(bvals, bvecs);
+
+        // Sum of eigenvalues is trace, they are sorted.
+        CHECK(mth::is_near(bvals[0] + bvals[1] + bvals[2] + bvals[3], 10.0, 1.0e-10));
+        CHECK(bvals[0] >= bvals[1]);
+        CHECK(bvals[1] >= bvals[2]);
+        CHECK(bvals[2] >= bvals[3]);
+
+        for (size_t i = 0; i < 4; ++i)
+        {
+            mth::Vec<4> v { bvecs(i, 0), bvecs(i, 1), bvecs(i, 2), bvecs(i, 3) };
+            mth::Vec<4> bv;
+
+            // b * v = lambda * v
+            mth::Mat<4, 4>::mul(b, v, bv);
+
+            for (size_t p = 0; p < 4; ++p)
+            {
+                CHECK(mth::is_near(bv[p], bvals[i] * v[p], 1.0e-10));
+            }
+
+            CHECK(mth::is_near(v.dot(v), 1.0, 1.0e-10));
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/// \file
+/// \brief Tests for sparse matrix.
+///
+/// Tests for sparse matrix.
+
+#include <catch2/catch_test_macros.hpp>
+#include "caesar.h"
+
+using namespace caesar;
+
+TEST_CASE("Sparse matrix : conjugate gradients", "[mth]")
+{
+    SECTION("laplacian of path with diagonal shift")
+    {
+        size_t n { 50 };
+        vector<size_t> offsets { 0 }, cols;
+        mth::SparseMatrix a;
+
+        // Tridiagonal matrix: 3 on diagonal, -1 near diagonal.
+        for (size_t i = 0; i < n; ++i)
+        {
+            cols.push_back(i);
+
+            if (i > 0)
+            {
+                cols.push_back(i - 1);
+            }
+
+            if (i + 1 < n)
+            {
+                cols.push_back(i + 1);
+            }
+
+            offsets.push_back(cols.size());
+        }
+
+        a.set_structure(offsets, cols);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            a.add(i, i, 3.0);
+
+            if (i > 0)
+            {
+                a.add(i, i - 1, -1.0);
+            }
+
+            if (i + 1 < n)
+            {
+                a.add(i, i + 1, -1.0);
+            }
+        }
+
+        CHECK(a.rows_count() == n);
+        CHECK(a.nonzeros_count() == 3 * n - 2);
+        CHECK(mth::is_eq(a.get(1, 0), -1.0));
+        CHECK(mth::is_eq(a.get(0, 2), 0.0));
+
+        // Right part for known solution.
+        vector<double> sol(n), b, x;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            sol[i] = sin(static_cast<double>(i));
+        }
+
+        a.mul(sol, b);
+
+        size_t iters { 0 };
+        bool is_solved { true };
+
+        CHECK(mth::solve_conjugate_gradients(a, b, x, 1.0e-14, 100, iters));
+        CHECK(iters < 100);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            is_solved = is_solved && mth::is_near(x[i], sol[i], 1.0e-10);
+        }
+
+        CHECK(is_solved);
+
+        // Convergence on the last allowed iteration is reported.
+        size_t last_iters { 0 };
+        vector<double> y;
+
+        CHECK(mth::solve_conjugate_gradients(a, b, y, 1.0e-14, iters, last_iters));
+        CHECK(last_iters == iters);
+
+        y.clear();
+        CHECK(!mth::solve_conjugate_gradients(a, b, y, 1.0e-14, iters - 1, last_iters));
+        CHECK(last_iters == iters - 1);
+    }
+}
@@ -17,4 +17,28 @@ TEST_CASE("Statistics : statistics functions on vectors", "[mth]")
         CHECK(mth::is_near(mth::sum(v), 15.0));
         CHECK(mth::is_near(mth::mean(v), 3.0));
     }
+
+    SECTION("quantile")
+    {
+        vector<double> v { 5.0, 1.0, 4.0, 2.0, 3.0 };
+
+        CHECK(mth::is_near(mth::quantile(v, 0.0), 1.0));
+        CHECK(mth::is_near(mth::quantile(v, 0.5), 3.0));
+        CHECK(mth::is_near(mth::quantile(v, 1.0), 5.0));
+    }
+
+    SECTION("histogram")
+    {
+        vector<double> v { 0.5, 1.5, 1.6, 2.5, 3.5, 3.9, 4.0, -1.0 };
+        vector<double> h(4, 0.0);
+
+        mth::histogram(v, 0.0, 4.0, h);
+
+        CHECK(mth::is_near(h[0], 2.0));
+        CHECK(mth::is_near(h[1], 2.0));
+        CHECK(mth::is_near(h[2], 1.0));
+        CHECK(mth::is_near(h[3], 3.0));
+        CHECK(mth::is_near(mth::histogram_quantile(h, 0.0, 4.0, 0.5), 2.0));
+        CHECK(mth::is_near(mth::histogram_quantile(h, 0.0, 4.0, 1.0), 4.0));
+    }
 }